@@ -32,6 +32,17 @@ sunster_heater_ns = cg.esphome_ns.namespace("sunster_heater")
 SunsterHeater = sunster_heater_ns.class_("SunsterHeater", cg.PollingComponent)
 SunsterInjectedPerPulseNumber = sunster_heater_ns.class_("SunsterInjectedPerPulseNumber", number.Number, cg.Component)
 SunsterResetTotalConsumptionButton = sunster_heater_ns.class_("SunsterResetTotalConsumptionButton", button.Button, cg.Component)
+SunsterDumpTraceButton = sunster_heater_ns.class_("SunsterDumpTraceButton", button.Button, cg.Component)
+SunsterExportPiTelemetryButton = sunster_heater_ns.class_(
+    "SunsterExportPiTelemetryButton", button.Button, cg.Component
+)
+SunsterDumpCaptureButton = sunster_heater_ns.class_("SunsterDumpCaptureButton", button.Button, cg.Component)
+SunsterCalibrationStartButton = sunster_heater_ns.class_("SunsterCalibrationStartButton", button.Button, cg.Component)
+SunsterCalibrationFuelNumber = sunster_heater_ns.class_("SunsterCalibrationFuelNumber", number.Number, cg.Component)
+SunsterTankRefillButton = sunster_heater_ns.class_("SunsterTankRefillButton", button.Button, cg.Component)
+SunsterTankAddFuelNumber = sunster_heater_ns.class_("SunsterTankAddFuelNumber", number.Number, cg.Component)
+SunsterDumpHistoryButton = sunster_heater_ns.class_("SunsterDumpHistoryButton", button.Button, cg.Component)
+SunsterHistoryDayNumber = sunster_heater_ns.class_("SunsterHistoryDayNumber", number.Number, cg.Component)
 SunsterControlModeSelect = sunster_heater_ns.class_("SunsterControlModeSelect", select.Select, cg.Component)
 SunsterHeaterPowerSwitch = sunster_heater_ns.class_("SunsterHeaterPowerSwitch", switch.Switch, cg.Component)
 SunsterAutoStopSwitch = sunster_heater_ns.class_("SunsterAutoStopSwitch", switch.Switch, cg.Component)
@@ -44,6 +55,7 @@ SunsterTLookaheadNumber = sunster_heater_ns.class_("SunsterTLookaheadNumber", nu
 SunsterSlopeWindowNumber = sunster_heater_ns.class_("SunsterSlopeWindowNumber", number.Number, cg.Component)
 SunsterOutputOffThresholdNumber = sunster_heater_ns.class_("SunsterOutputOffThresholdNumber", number.Number, cg.Component)
 SunsterOutputOnThresholdNumber = sunster_heater_ns.class_("SunsterOutputOnThresholdNumber", number.Number, cg.Component)
+TelemetryChannel = sunster_heater_ns.enum("TelemetryChannel", is_class=True)
 
 # Configuration keys
 CONF_AUTO_SENSORS = "auto_sensors"
@@ -54,9 +66,38 @@ CONF_DEFAULT_POWER_PERCENT = "default_power_percent"
 CONF_EXTERNAL_TEMPERATURE_SENSOR = "external_temperature_sensor"
 CONF_INJECTED_PER_PULSE = "injected_per_pulse"
 CONF_INJECTED_PER_PULSE_NUMBER = "injected_per_pulse_number"
+CONF_FUEL_MAX_GAP = "fuel_max_gap"
+CONF_CALIBRATE_PER_LEVEL = "calibrate_per_level"
+CONF_CALIBRATION_START_BUTTON = "calibration_start_button"
+CONF_CALIBRATION_FUEL_NUMBER = "calibration_fuel_number"
+CONF_TANK_CAPACITY = "tank_capacity"
+CONF_TANK_REFILL_BUTTON = "tank_refill_button"
+CONF_TANK_ADD_FUEL_NUMBER = "tank_add_fuel_number"
+CONF_TANK_REMAINING = "tank_remaining"
+CONF_TANK_RUNTIME = "tank_runtime"
+CONF_TANK_RUNTIME_AVERAGE = "tank_runtime_average"
 CONF_PASSIVE_SNIFF = "passive_sniff"
 CONF_POLLING_INTERVAL = "polling_interval"
+CONF_MIN_TX_GAP = "min_tx_gap"
+CONF_CONTROL_PERIOD = "control_period"
+CONF_STRICT_CHECKSUM = "strict_checksum"
+CONF_FRAME_LAYOUT = "frame_layout"
 CONF_RESET_TOTAL_CONSUMPTION_BUTTON = "reset_total_consumption_button"
+CONF_SIMULATE = "simulate"
+CONF_AMBIENT_TEMPERATURE = "ambient_temperature"
+CONF_INITIAL_TEMPERATURE = "initial_temperature"
+CONF_HEATER_POWER = "heater_power"
+CONF_HEAT_LOSS = "heat_loss"
+CONF_THERMAL_MASS = "thermal_mass"
+CONF_SENSOR_LAG = "sensor_lag"
+CONF_FRAME_TRACE = "frame_trace"
+CONF_DUMP_TRACE_BUTTON = "dump_trace_button"
+CONF_EXPORT_PI_TELEMETRY_BUTTON = "export_pi_telemetry_button"
+CONF_CAPTURE_BUFFER_SIZE = "capture_buffer_size"
+CONF_PI_TELEMETRY_SIZE = "pi_telemetry_size"
+CONF_DUMP_CAPTURE_BUTTON = "dump_capture_button"
+CONF_DUMP_HISTORY_BUTTON = "dump_history_button"
+CONF_HISTORY_DAY_NUMBER = "history_day_number"
 CONF_POWER_SWITCH = "power_switch"
 CONF_AUTO_STOP_SWITCH = "auto_stop_switch"
 CONF_POWER_LEVEL_NUMBER = "power_level_number"
@@ -66,6 +107,10 @@ CONF_TARGET_TEMPERATURE_NUMBER = "target_temperature_number"
 CONF_PI_MIN_ON_TIME_NUMBER = "pi_min_on_time_number"
 CONF_T_LOOKAHEAD = "t_lookahead"
 CONF_SLOPE_WINDOW = "slope_window"
+CONF_TEMPERATURE_NOISE = "temperature_noise"
+CONF_ECONOMY_BAND = "economy_band"
+CONF_CYCLE_AWARE_STOP = "cycle_aware_stop"
+CONF_CYCLE_PENALTY = "cycle_penalty"
 CONF_OUTPUT_OFF_THRESHOLD = "output_off_threshold"
 CONF_OUTPUT_ON_THRESHOLD = "output_on_threshold"
 CONF_T_LOOKAHEAD_NUMBER = "t_lookahead_number"
@@ -78,6 +123,13 @@ CONTROL_MODE_MANUAL = "manual"
 CONTROL_MODE_AUTOMATIC = "automatic"
 CONTROL_MODE_ANTIFREEZE = "antifreeze"
 CONTROL_MODE_FAN_ONLY = "fan_only"
+CONTROL_MODE_ECONOMY = "economy"
+
+# Heater frame layouts (heater_frame.h FRAME_LAYOUTS); "auto" keeps all decoders
+FRAME_LAYOUT_AUTO = "auto"
+FRAME_LAYOUTS = {
+    "heater_0x34": "SUNSTER_HEATER_FRAME_LAYOUT_HEATER_0X34",
+}
 
 # Sensor configuration keys
 CONF_INPUT_VOLTAGE = "input_voltage"
@@ -96,10 +148,40 @@ CONF_LOW_VOLTAGE_ERROR = "low_voltage_error"
 CONF_PI_OUTPUT = "pi_output"
 CONF_PREDICTED_TEMPERATURE = "predicted_temperature"
 CONF_SLOPE = "slope"
+CONF_COMMAND_LATENCY = "command_latency"
+CONF_CONTROL_JITTER = "control_jitter"
+CONF_SAMPLE_AGE = "sample_age"
+CONF_ECONOMY_SAVINGS = "economy_savings"
+CONF_FLASH_WRITE_RATE = "flash_write_rate"
+CONF_HISTORY = "history"
+CONF_CYCLE_COST = "cycle_cost"
+CONF_CYCLE_VOLTAGE_SAG = "cycle_voltage_sag"
+CONF_START_STOP_CYCLES = "start_stop_cycles"
+CONF_IDLE_DECISIONS = "idle_decisions"
+CONF_PUBLISHES_EMITTED = "publishes_emitted"
+CONF_PUBLISHES_SUPPRESSED = "publishes_suppressed"
+CONF_LINK_TX_FRAMES = "link_tx_frames"
+CONF_LINK_RX_FRAMES = "link_rx_frames"
+CONF_LINK_CHECKSUM_FAILURES = "link_checksum_failures"
+CONF_LINK_ECHO_FRAMES = "link_echo_frames"
+CONF_LINK_RESYNCS = "link_resyncs"
+CONF_LINK_OVERSIZE_RESETS = "link_oversize_resets"
+CONF_LINK_PARTIAL_TIMEOUTS = "link_partial_timeouts"
+CONF_LINK_COMM_TIMEOUTS = "link_comm_timeouts"
+CONF_LINK_RTT_MIN = "link_rtt_min"
+CONF_LINK_RTT_AVG = "link_rtt_avg"
+CONF_LINK_RTT_P95 = "link_rtt_p95"
+
+# Publish filter keys (per telemetry entity)
+CONF_PUBLISH_DEADBAND = "publish_deadband"
+CONF_PUBLISH_DEADBAND_PERCENT = "publish_deadband_percent"
+CONF_PUBLISH_MIN_INTERVAL = "publish_min_interval"
+CONF_PUBLISH_HEARTBEAT = "publish_heartbeat"
 
 # Fuel consumption constants
 UNIT_MILLILITERS = "ml"
 UNIT_MILLILITERS_PER_HOUR = "ml/h"
+UNIT_MILLISECOND = "ms"
 
 # Standard number options (like normal ESPHome Numbers, for YAML compatibility)
 # restore_value/optimistic/initial_value are accepted in the schema; persistence is still handled by the heater (pref_config_).
@@ -109,6 +191,93 @@ NUMBER_EXTRA = {
     cv.Optional("initial_value"): cv.float_,
 }
 
+
+# Publish-on-change filter: numeric entities get a deadband, text/binary ones only
+# publish on change. All are re-published at least every publish_heartbeat.
+def publish_filter_schema(deadband=0.0, min_interval="0s", heartbeat="60s", numeric=True):
+    schema = {
+        cv.Optional(CONF_PUBLISH_MIN_INTERVAL, default=min_interval): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_PUBLISH_HEARTBEAT, default=heartbeat): cv.positive_time_period_milliseconds,
+    }
+    if numeric:
+        schema[cv.Optional(CONF_PUBLISH_DEADBAND, default=deadband)] = cv.positive_float
+        schema[cv.Optional(CONF_PUBLISH_DEADBAND_PERCENT, default=0.0)] = cv.float_range(min=0.0, max=100.0)
+    return schema
+
+
+LinkStat = sunster_heater_ns.enum("LinkStat", is_class=True)
+SimConfig = sunster_heater_ns.struct("SimConfig")
+
+# Closed-loop simulation: simulated heater on the bus, first-order cabin model
+SIMULATE_SCHEMA = cv.Schema(
+    {
+        cv.Optional(CONF_AMBIENT_TEMPERATURE, default=0.0): cv.temperature,
+        cv.Optional(CONF_INITIAL_TEMPERATURE, default=5.0): cv.temperature,
+        cv.Optional(CONF_HEATER_POWER, default=2000.0): cv.positive_float,  # W at power level 10
+        cv.Optional(CONF_HEAT_LOSS, default=40.0): cv.positive_float,  # W/K
+        cv.Optional(CONF_THERMAL_MASS, default=100.0): cv.positive_float,  # kJ/K
+        cv.Optional(CONF_SENSOR_LAG, default="60s"): cv.positive_time_period_seconds,
+    }
+)
+
+
+def link_counter_schema(icon):
+    return sensor.sensor_schema(
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        accuracy_decimals=0,
+        icon=icon,
+        entity_category="diagnostic",
+    )
+
+
+def link_rtt_schema():
+    return sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=0,
+        icon="mdi:timer-sync-outline",
+        entity_category="diagnostic",
+    )
+
+
+# Link-layer statistics: config key -> (LinkStat, schema). Diagnostic only, never auto-created.
+LINK_STAT_SENSORS = {
+    CONF_LINK_TX_FRAMES: (LinkStat.TX_FRAMES, link_counter_schema("mdi:upload")),
+    CONF_LINK_RX_FRAMES: (LinkStat.RX_FRAMES, link_counter_schema("mdi:download")),
+    CONF_LINK_CHECKSUM_FAILURES: (LinkStat.CHECKSUM_FAILURES, link_counter_schema("mdi:alert-circle-outline")),
+    CONF_LINK_ECHO_FRAMES: (LinkStat.ECHO_FRAMES, link_counter_schema("mdi:repeat")),
+    CONF_LINK_RESYNCS: (LinkStat.RESYNCS, link_counter_schema("mdi:sync-alert")),
+    CONF_LINK_OVERSIZE_RESETS: (LinkStat.OVERSIZE_RESETS, link_counter_schema("mdi:arrow-expand-horizontal")),
+    CONF_LINK_PARTIAL_TIMEOUTS: (LinkStat.PARTIAL_TIMEOUTS, link_counter_schema("mdi:timer-sand-empty")),
+    CONF_LINK_COMM_TIMEOUTS: (LinkStat.COMM_TIMEOUTS, link_counter_schema("mdi:lan-disconnect")),
+    CONF_LINK_RTT_MIN: (LinkStat.RTT_MIN, link_rtt_schema()),
+    CONF_LINK_RTT_AVG: (LinkStat.RTT_AVG, link_rtt_schema()),
+    CONF_LINK_RTT_P95: (LinkStat.RTT_P95, link_rtt_schema()),
+}
+
+
+TELEMETRY_CHANNELS = {
+    CONF_STATE: TelemetryChannel.STATE,
+    CONF_POWER_LEVEL: TelemetryChannel.POWER_LEVEL,
+    CONF_INPUT_VOLTAGE: TelemetryChannel.INPUT_VOLTAGE,
+    CONF_GLOW_PLUG_STATUS: TelemetryChannel.GLOW_PLUG_STATUS,
+    CONF_COOLING_DOWN: TelemetryChannel.COOLING_DOWN,
+    CONF_HEAT_EXCHANGER_TEMPERATURE: TelemetryChannel.HEAT_EXCHANGER_TEMPERATURE,
+    CONF_STATE_DURATION: TelemetryChannel.STATE_DURATION,
+    CONF_PUMP_FREQUENCY: TelemetryChannel.PUMP_FREQUENCY,
+    CONF_FAN_SPEED: TelemetryChannel.FAN_SPEED,
+    CONF_HOURLY_CONSUMPTION: TelemetryChannel.HOURLY_CONSUMPTION,
+    CONF_DAILY_CONSUMPTION: TelemetryChannel.DAILY_CONSUMPTION,
+    CONF_TOTAL_CONSUMPTION: TelemetryChannel.TOTAL_CONSUMPTION,
+    CONF_TANK_REMAINING: TelemetryChannel.TANK_REMAINING,
+    CONF_TANK_RUNTIME: TelemetryChannel.TANK_RUNTIME,
+    CONF_TANK_RUNTIME_AVERAGE: TelemetryChannel.TANK_RUNTIME_AVERAGE,
+    CONF_PI_OUTPUT: TelemetryChannel.PI_OUTPUT,
+    CONF_PREDICTED_TEMPERATURE: TelemetryChannel.PREDICTED_TEMPERATURE,
+    CONF_SLOPE: TelemetryChannel.SLOPE,
+    CONF_LOW_VOLTAGE_ERROR: TelemetryChannel.LOW_VOLTAGE_ERROR,
+}
+
 # Simplified sensor schemas with good defaults
 SENSOR_SCHEMAS = {
     CONF_INPUT_VOLTAGE: sensor.sensor_schema(
@@ -117,85 +286,182 @@ SENSOR_SCHEMAS = {
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=1,
         icon=ICON_FLASH,
-    ),
+    ).extend(publish_filter_schema()),
     CONF_STATE: text_sensor.text_sensor_schema(
         icon=ICON_POWER,
-    ),
+    ).extend(publish_filter_schema(numeric=False)),
     CONF_POWER_LEVEL: sensor.sensor_schema(
         unit_of_measurement=UNIT_PERCENT,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=0,
         icon=ICON_POWER,
-    ),
+    ).extend(publish_filter_schema()),
     CONF_FAN_SPEED: sensor.sensor_schema(
         unit_of_measurement=UNIT_REVOLUTIONS_PER_MINUTE,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=0,
         icon=ICON_FAN,
-    ),
+    ).extend(publish_filter_schema()),
     CONF_PUMP_FREQUENCY: sensor.sensor_schema(
         unit_of_measurement=UNIT_HERTZ,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=1,
-    ),
+    ).extend(publish_filter_schema()),
     CONF_GLOW_PLUG_STATUS: text_sensor.text_sensor_schema(
         icon="mdi:fire",
-    ),
+    ).extend(publish_filter_schema(numeric=False)),
     CONF_HEAT_EXCHANGER_TEMPERATURE: sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=1,
         icon=ICON_THERMOMETER,
-    ),
+    ).extend(publish_filter_schema()),
     CONF_STATE_DURATION: sensor.sensor_schema(
         unit_of_measurement=UNIT_SECOND,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=0,
-    ),
+    ).extend(publish_filter_schema(min_interval="10s")),
     CONF_COOLING_DOWN: binary_sensor.binary_sensor_schema(
         icon=ICON_FAN,
-    ),
+    ).extend(publish_filter_schema(numeric=False)),
     CONF_PI_OUTPUT: sensor.sensor_schema(
         unit_of_measurement=UNIT_PERCENT,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=1,
         icon=ICON_POWER,
-    ),
+    ).extend(publish_filter_schema()),
     CONF_PREDICTED_TEMPERATURE: sensor.sensor_schema(
         unit_of_measurement=UNIT_CELSIUS,
         device_class=DEVICE_CLASS_TEMPERATURE,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=2,
         icon=ICON_THERMOMETER,
-    ),
+    ).extend(publish_filter_schema()),
     CONF_SLOPE: sensor.sensor_schema(
         unit_of_measurement="°C/s",
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=4,
         icon="mdi:chart-line",
-    ),
+    ).extend(publish_filter_schema()),
     CONF_LOW_VOLTAGE_ERROR: binary_sensor.binary_sensor_schema(
         icon="mdi:alert-circle",
         device_class="problem",
-    ),
+    ).extend(publish_filter_schema(numeric=False)),
     CONF_HOURLY_CONSUMPTION: sensor.sensor_schema(
         unit_of_measurement=UNIT_MILLILITERS_PER_HOUR,
         state_class=STATE_CLASS_MEASUREMENT,
         accuracy_decimals=2,
         icon="mdi:fuel",
-    ),
+    ).extend(publish_filter_schema()),
     CONF_DAILY_CONSUMPTION: sensor.sensor_schema(
         unit_of_measurement=UNIT_MILLILITERS,
         state_class=STATE_CLASS_TOTAL_INCREASING,
         accuracy_decimals=2,
         icon="mdi:counter",
-    ),    CONF_TOTAL_CONSUMPTION: sensor.sensor_schema(
+    ).extend(publish_filter_schema(min_interval="10s")),
+    CONF_TOTAL_CONSUMPTION: sensor.sensor_schema(
         unit_of_measurement=UNIT_MILLILITERS,
         state_class=STATE_CLASS_TOTAL_INCREASING,
         accuracy_decimals=2,
         icon="mdi:fuel",
-    ),}
+    ).extend(publish_filter_schema(min_interval="10s")),
+    CONF_COMMAND_LATENCY: sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=0,
+        icon="mdi:timer-outline",
+        entity_category="diagnostic",
+    ),
+    CONF_CONTROL_JITTER: sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLISECOND,
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=0,
+        icon="mdi:timer-alert-outline",
+        entity_category="diagnostic",
+    ),
+    CONF_SAMPLE_AGE: sensor.sensor_schema(
+        unit_of_measurement=UNIT_SECOND,
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=1,
+        icon="mdi:timer-sand",
+        entity_category="diagnostic",
+    ),
+    CONF_ECONOMY_SAVINGS: sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLILITERS,
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        accuracy_decimals=1,
+        icon="mdi:leaf",
+        entity_category="diagnostic",
+    ),
+    CONF_TANK_REMAINING: sensor.sensor_schema(
+        unit_of_measurement="L",
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=2,
+        icon="mdi:gas-station",
+    ).extend(publish_filter_schema(deadband=0.01)),
+    CONF_TANK_RUNTIME: sensor.sensor_schema(
+        unit_of_measurement="h",
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=1,
+        icon="mdi:timer-sand",
+    ).extend(publish_filter_schema(deadband=0.1)),
+    CONF_TANK_RUNTIME_AVERAGE: sensor.sensor_schema(
+        unit_of_measurement="h",
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=0,
+        icon="mdi:timer-sand",
+    ).extend(publish_filter_schema(deadband=1.0)),
+    CONF_HISTORY: text_sensor.text_sensor_schema(
+        icon="mdi:history",
+    ),
+    CONF_FLASH_WRITE_RATE: sensor.sensor_schema(
+        unit_of_measurement="writes/h",
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=1,
+        icon="mdi:content-save-cog-outline",
+        entity_category="diagnostic",
+    ),
+    CONF_CYCLE_COST: sensor.sensor_schema(
+        unit_of_measurement=UNIT_MILLILITERS,
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=1,
+        icon="mdi:restart",
+        entity_category="diagnostic",
+    ),
+    CONF_CYCLE_VOLTAGE_SAG: sensor.sensor_schema(
+        unit_of_measurement=UNIT_VOLT,
+        device_class=DEVICE_CLASS_VOLTAGE,
+        state_class=STATE_CLASS_MEASUREMENT,
+        accuracy_decimals=2,
+        icon="mdi:battery-arrow-down",
+        entity_category="diagnostic",
+    ),
+    CONF_START_STOP_CYCLES: sensor.sensor_schema(
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        accuracy_decimals=0,
+        icon="mdi:counter",
+        entity_category="diagnostic",
+    ),
+    CONF_IDLE_DECISIONS: sensor.sensor_schema(
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        accuracy_decimals=0,
+        icon="mdi:pause-circle-outline",
+        entity_category="diagnostic",
+    ),
+    CONF_PUBLISHES_EMITTED: sensor.sensor_schema(
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        accuracy_decimals=0,
+        icon="mdi:upload-network",
+        entity_category="diagnostic",
+    ),
+    CONF_PUBLISHES_SUPPRESSED: sensor.sensor_schema(
+        state_class=STATE_CLASS_TOTAL_INCREASING,
+        accuracy_decimals=0,
+        icon="mdi:upload-off",
+        entity_category="diagnostic",
+    ),
+}
 
 CONFIG_SCHEMA = cv.All(
     cv.Schema(
@@ -209,6 +475,7 @@ CONFIG_SCHEMA = cv.All(
                     CONTROL_MODE_AUTOMATIC: "automatic",
                     CONTROL_MODE_ANTIFREEZE: "antifreeze",
                     CONTROL_MODE_FAN_ONLY: "fan_only",
+                    CONTROL_MODE_ECONOMY: "economy",
                 },
                 upper=False
             ),
@@ -219,7 +486,29 @@ CONFIG_SCHEMA = cv.All(
                 min=0.001, max=1.0
             ),
             cv.Optional(CONF_PASSIVE_SNIFF, default=False): cv.boolean,
+            cv.Optional(CONF_STRICT_CHECKSUM, default=False): cv.boolean,
+            cv.Optional(CONF_SIMULATE): SIMULATE_SCHEMA,
+            cv.Optional(CONF_FRAME_TRACE, default=False): cv.boolean,
+            cv.Optional(CONF_CAPTURE_BUFFER_SIZE, default=0): cv.Any(
+                cv.one_of(0), cv.int_range(min=256, max=65536)
+            ),
+            # PI step records for the CSV export, ~52 bytes each; steps x control_period of history
+            cv.Optional(CONF_PI_TELEMETRY_SIZE, default=64): cv.int_range(min=16, max=2880),
+            cv.Optional(CONF_FRAME_LAYOUT, default=FRAME_LAYOUT_AUTO): cv.one_of(
+                FRAME_LAYOUT_AUTO, *FRAME_LAYOUTS, lower=True
+            ),
             cv.Optional(CONF_POLLING_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_MIN_TX_GAP, default="200ms"): cv.positive_time_period_milliseconds,
+            cv.Optional(CONF_FUEL_MAX_GAP, default="5s"): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(min=cv.TimePeriod(seconds=1), max=cv.TimePeriod(seconds=60)),
+            ),
+            cv.Optional(CONF_CALIBRATE_PER_LEVEL, default=False): cv.boolean,
+            cv.Optional(CONF_TANK_CAPACITY, default=0.0): cv.float_range(min=0.0, max=1000.0),
+            cv.Optional(CONF_CONTROL_PERIOD, default="5s"): cv.All(
+                cv.positive_time_period_milliseconds,
+                cv.Range(min=cv.TimePeriod(seconds=1), max=cv.TimePeriod(seconds=60)),
+            ),
             cv.Optional(CONF_TIME_ID): cv.use_id(time.RealTimeClock),
             cv.Optional(CONF_EXTERNAL_TEMPERATURE_SENSOR): cv.use_id(sensor.Sensor),
             cv.Optional("target_temperature", default=20.0): cv.float_range(
@@ -240,6 +529,16 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(CONF_SLOPE_WINDOW, default=45.0): cv.float_range(
                 min=10.0, max=120.0
             ),
+            cv.Optional(CONF_TEMPERATURE_NOISE, default=0.05): cv.float_range(
+                min=0.005, max=2.0
+            ),
+            cv.Optional(CONF_ECONOMY_BAND, default=0.5): cv.float_range(
+                min=0.1, max=3.0
+            ),
+            cv.Optional(CONF_CYCLE_AWARE_STOP, default=True): cv.boolean,
+            cv.Optional(CONF_CYCLE_PENALTY, default=0.0): cv.float_range(
+                min=0.0, max=100.0
+            ),
             cv.Optional(CONF_OUTPUT_OFF_THRESHOLD, default=-10.0): cv.float_range(
                 min=-100.0, max=0.0
             ),
@@ -281,6 +580,52 @@ CONFIG_SCHEMA = cv.All(
             cv.Optional(CONF_TOTAL_CONSUMPTION): SENSOR_SCHEMAS[CONF_TOTAL_CONSUMPTION],
             cv.Optional(CONF_PREDICTED_TEMPERATURE): SENSOR_SCHEMAS[CONF_PREDICTED_TEMPERATURE],
             cv.Optional(CONF_SLOPE): SENSOR_SCHEMAS[CONF_SLOPE],
+            cv.Optional(CONF_COMMAND_LATENCY): SENSOR_SCHEMAS[CONF_COMMAND_LATENCY],
+            cv.Optional(CONF_CONTROL_JITTER): SENSOR_SCHEMAS[CONF_CONTROL_JITTER],
+            cv.Optional(CONF_SAMPLE_AGE): SENSOR_SCHEMAS[CONF_SAMPLE_AGE],
+            cv.Optional(CONF_ECONOMY_SAVINGS): SENSOR_SCHEMAS[CONF_ECONOMY_SAVINGS],
+            cv.Optional(CONF_FLASH_WRITE_RATE): SENSOR_SCHEMAS[CONF_FLASH_WRITE_RATE],
+            cv.Optional(CONF_HISTORY): SENSOR_SCHEMAS[CONF_HISTORY],
+            cv.Optional(CONF_TANK_REMAINING): SENSOR_SCHEMAS[CONF_TANK_REMAINING],
+            cv.Optional(CONF_TANK_RUNTIME): SENSOR_SCHEMAS[CONF_TANK_RUNTIME],
+            cv.Optional(CONF_TANK_RUNTIME_AVERAGE): SENSOR_SCHEMAS[CONF_TANK_RUNTIME_AVERAGE],
+            cv.Optional(CONF_CALIBRATION_START_BUTTON): button.button_schema(
+                SunsterCalibrationStartButton,
+                icon="mdi:flag-outline",
+                entity_category="config",
+            ),
+            cv.Optional(CONF_CALIBRATION_FUEL_NUMBER): number.number_schema(
+                SunsterCalibrationFuelNumber,
+                unit_of_measurement=UNIT_MILLILITERS,
+                icon="mdi:beaker-outline",
+                entity_category="config",
+            ).extend({
+                cv.Optional("min_value", default=0.0): cv.float_,
+                cv.Optional("max_value", default=20000.0): cv.float_,
+                cv.Optional("step", default=1.0): cv.float_,
+                **NUMBER_EXTRA,
+            }),
+            cv.Optional(CONF_TANK_REFILL_BUTTON): button.button_schema(
+                SunsterTankRefillButton,
+                icon="mdi:gas-station",
+            ),
+            cv.Optional(CONF_TANK_ADD_FUEL_NUMBER): number.number_schema(
+                SunsterTankAddFuelNumber,
+                unit_of_measurement="L",
+                icon="mdi:gas-station-outline",
+            ).extend({
+                cv.Optional("min_value", default=0.0): cv.float_,
+                cv.Optional("max_value", default=50.0): cv.float_,
+                cv.Optional("step", default=0.1): cv.float_,
+                **NUMBER_EXTRA,
+            }),
+            cv.Optional(CONF_CYCLE_COST): SENSOR_SCHEMAS[CONF_CYCLE_COST],
+            cv.Optional(CONF_CYCLE_VOLTAGE_SAG): SENSOR_SCHEMAS[CONF_CYCLE_VOLTAGE_SAG],
+            cv.Optional(CONF_START_STOP_CYCLES): SENSOR_SCHEMAS[CONF_START_STOP_CYCLES],
+            cv.Optional(CONF_IDLE_DECISIONS): SENSOR_SCHEMAS[CONF_IDLE_DECISIONS],
+            cv.Optional(CONF_PUBLISHES_EMITTED): SENSOR_SCHEMAS[CONF_PUBLISHES_EMITTED],
+            cv.Optional(CONF_PUBLISHES_SUPPRESSED): SENSOR_SCHEMAS[CONF_PUBLISHES_SUPPRESSED],
+            **{cv.Optional(key): schema for key, (_, schema) in LINK_STAT_SENSORS.items()},
             cv.Optional(CONF_INJECTED_PER_PULSE_NUMBER): number.number_schema(
                 SunsterInjectedPerPulseNumber,
                 unit_of_measurement=UNIT_MILLILITERS,
@@ -297,6 +642,36 @@ CONFIG_SCHEMA = cv.All(
                 icon="mdi:restart",
                 entity_category="config",
             ),
+            cv.Optional(CONF_DUMP_TRACE_BUTTON): button.button_schema(
+                SunsterDumpTraceButton,
+                icon="mdi:text-box-search-outline",
+                entity_category="diagnostic",
+            ),
+            cv.Optional(CONF_EXPORT_PI_TELEMETRY_BUTTON): button.button_schema(
+                SunsterExportPiTelemetryButton,
+                icon="mdi:chart-line",
+                entity_category="diagnostic",
+            ),
+            cv.Optional(CONF_DUMP_CAPTURE_BUTTON): button.button_schema(
+                SunsterDumpCaptureButton,
+                icon="mdi:record-rec",
+                entity_category="diagnostic",
+            ),
+            cv.Optional(CONF_DUMP_HISTORY_BUTTON): button.button_schema(
+                SunsterDumpHistoryButton,
+                icon="mdi:history",
+                entity_category="diagnostic",
+            ),
+            cv.Optional(CONF_HISTORY_DAY_NUMBER): number.number_schema(
+                SunsterHistoryDayNumber,
+                unit_of_measurement="d",
+                icon="mdi:calendar-arrow-left",
+            ).extend({
+                cv.Optional("min_value", default=0.0): cv.float_,
+                cv.Optional("max_value", default=95.0): cv.float_range(min=0.0, max=95.0),
+                cv.Optional("step", default=1.0): cv.float_,
+                **NUMBER_EXTRA,
+            }),
             cv.Optional(CONF_CONTROL_MODE_SELECT): select.select_schema(
                 SunsterControlModeSelect,
                 icon="mdi:format-list-bulleted",
@@ -417,6 +792,20 @@ CONFIG_SCHEMA = cv.All(
 )
 
 
+def add_publish_filter(var, sensor_key, sens_config):
+    if sensor_key not in TELEMETRY_CHANNELS:
+        return
+    cg.add(
+        var.set_publish_filter(
+            TELEMETRY_CHANNELS[sensor_key],
+            sens_config.get(CONF_PUBLISH_DEADBAND, 0.0),
+            sens_config.get(CONF_PUBLISH_DEADBAND_PERCENT, 0.0),
+            sens_config[CONF_PUBLISH_MIN_INTERVAL],
+            sens_config[CONF_PUBLISH_HEARTBEAT],
+        )
+    )
+
+
 async def to_code(config):
     var = cg.new_Pvariable(config[CONF_ID])
     await cg.register_component(var, config)
@@ -432,6 +821,8 @@ async def to_code(config):
         cg.add(var.set_control_mode(cg.RawExpression("esphome::sunster_heater::ControlMode::ANTIFREEZE")))
     elif control_mode == CONTROL_MODE_FAN_ONLY:
         cg.add(var.set_control_mode(cg.RawExpression("esphome::sunster_heater::ControlMode::FAN_ONLY")))
+    elif control_mode == CONTROL_MODE_ECONOMY:
+        cg.add(var.set_control_mode(cg.RawExpression("esphome::sunster_heater::ControlMode::ECONOMY")))
     else:
         cg.add(var.set_control_mode(cg.RawExpression("esphome::sunster_heater::ControlMode::MANUAL")))
 
@@ -440,13 +831,52 @@ async def to_code(config):
 
     # Set injected per pulse
     cg.add(var.set_injected_per_pulse(config[CONF_INJECTED_PER_PULSE]))
+    cg.add(var.set_fuel_max_gap(config[CONF_FUEL_MAX_GAP]))
+    cg.add(var.set_calibrate_per_level(config[CONF_CALIBRATE_PER_LEVEL]))
+    cg.add(var.set_tank_capacity(config[CONF_TANK_CAPACITY]))
 
     # Passive sniff mode (log RX/decode only, never send)
     cg.add(var.set_passive_sniff_mode(config[CONF_PASSIVE_SNIFF]))
 
+    # Reject frames with bad checksum and resync within the buffered bytes
+    cg.add(var.set_strict_checksum(config[CONF_STRICT_CHECKSUM]))
+
+    # Simulated heater + cabin instead of the UART (bench testing of the control logic)
+    if CONF_SIMULATE in config:
+        sim = config[CONF_SIMULATE]
+        cg.add(
+            var.set_simulation(
+                cg.StructInitializer(
+                    SimConfig,
+                    ("ambient_c", sim[CONF_AMBIENT_TEMPERATURE]),
+                    ("initial_c", sim[CONF_INITIAL_TEMPERATURE]),
+                    ("heater_power_w", sim[CONF_HEATER_POWER]),
+                    ("heat_loss_w_per_k", sim[CONF_HEAT_LOSS]),
+                    ("thermal_mass_j_per_k", sim[CONF_THERMAL_MASS] * 1000.0),
+                    ("sensor_lag_s", float(sim[CONF_SENSOR_LAG].total_seconds)),
+                )
+            )
+        )
+
+    # Frame trace ring (copy on the frame path, formatted lazily or via dump button)
+    cg.add(var.set_frame_trace(config[CONF_FRAME_TRACE]))
+
+    # RAM capture ring for RX/TX frames and temperature samples (0 = disabled)
+    cg.add(var.set_capture_buffer_size(config[CONF_CAPTURE_BUFFER_SIZE]))
+    cg.add(var.set_pi_telemetry_size(config[CONF_PI_TELEMETRY_SIZE]))
+
+    # Pinning a frame layout drops the other decoders at compile time
+    if config[CONF_FRAME_LAYOUT] != FRAME_LAYOUT_AUTO:
+        cg.add_build_flag("-DSUNSTER_HEATER_FRAME_LAYOUT_PINNED")
+        cg.add_build_flag(f"-D{FRAME_LAYOUTS[config[CONF_FRAME_LAYOUT]]}")
+
     # Set polling interval
     cg.add(var.set_polling_interval(config[CONF_POLLING_INTERVAL]))
 
+    # Minimum gap between controller frames (event-driven TX on command change)
+    cg.add(var.set_min_tx_gap(config[CONF_MIN_TX_GAP]))
+    cg.add(var.set_control_period(config[CONF_CONTROL_PERIOD]))
+
     # Set voltage safety thresholds
     cg.add(var.set_min_voltage_start(config["min_voltage_start"]))
     cg.add(var.set_min_voltage_operate(config["min_voltage_operate"]))
@@ -465,6 +895,10 @@ async def to_code(config):
         cg.add(var.set_pi_min_on_time(config["pi_min_on_time"]))
     cg.add(var.set_t_lookahead(config[CONF_T_LOOKAHEAD]))
     cg.add(var.set_slope_window(config[CONF_SLOPE_WINDOW]))
+    cg.add(var.set_temperature_noise(config[CONF_TEMPERATURE_NOISE]))
+    cg.add(var.set_economy_band(config[CONF_ECONOMY_BAND]))
+    cg.add(var.set_cycle_aware_stop(config[CONF_CYCLE_AWARE_STOP]))
+    cg.add(var.set_cycle_penalty(config[CONF_CYCLE_PENALTY]))
     cg.add(var.set_output_off_threshold(config[CONF_OUTPUT_OFF_THRESHOLD]))
     cg.add(var.set_output_on_threshold(config[CONF_OUTPUT_ON_THRESHOLD]))
 
@@ -516,6 +950,7 @@ async def to_code(config):
 
             sens = await sensor.new_sensor(sens_config)
             cg.add(getattr(var, setter_method)(sens))
+            add_publish_filter(var, sensor_key, sens_config)
 
         for sensor_key, setter_method in text_sensors_to_create:
             if sensor_key in config:
@@ -529,6 +964,7 @@ async def to_code(config):
 
             sens = await text_sensor.new_text_sensor(sens_config)
             cg.add(getattr(var, setter_method)(sens))
+            add_publish_filter(var, sensor_key, sens_config)
 
         for sensor_key, setter_method in binary_sensors_to_create:
             if sensor_key in config:
@@ -542,6 +978,7 @@ async def to_code(config):
 
             sens = await binary_sensor.new_binary_sensor(sens_config)
             cg.add(getattr(var, setter_method)(sens))
+            add_publish_filter(var, sensor_key, sens_config)
     else:
         sensor_configs = [
             (CONF_INPUT_VOLTAGE, "set_input_voltage_sensor", sensor.new_sensor),
@@ -565,6 +1002,44 @@ async def to_code(config):
             if sensor_key in config:
                 sens = await new_sensor_func(config[sensor_key])
                 cg.add(getattr(var, setter_method)(sens))
+                add_publish_filter(var, sensor_key, config[sensor_key])
+
+    # Diagnostic sensors (never auto-created)
+    if CONF_COMMAND_LATENCY in config:
+        sens = await sensor.new_sensor(config[CONF_COMMAND_LATENCY])
+        cg.add(var.set_command_latency_sensor(sens))
+    if CONF_CONTROL_JITTER in config:
+        sens = await sensor.new_sensor(config[CONF_CONTROL_JITTER])
+        cg.add(var.set_control_jitter_sensor(sens))
+    if CONF_SAMPLE_AGE in config:
+        sens = await sensor.new_sensor(config[CONF_SAMPLE_AGE])
+        cg.add(var.set_sample_age_sensor(sens))
+    if CONF_ECONOMY_SAVINGS in config:
+        sens = await sensor.new_sensor(config[CONF_ECONOMY_SAVINGS])
+        cg.add(var.set_economy_savings_sensor(sens))
+    for key, setter in (
+        (CONF_FLASH_WRITE_RATE, var.set_flash_write_rate_sensor),
+        (CONF_CYCLE_COST, var.set_cycle_cost_sensor),
+        (CONF_CYCLE_VOLTAGE_SAG, var.set_cycle_voltage_sag_sensor),
+        (CONF_START_STOP_CYCLES, var.set_start_stop_cycles_sensor),
+        (CONF_IDLE_DECISIONS, var.set_idle_decisions_sensor),
+    ):
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(setter(sens))
+    if CONF_HISTORY in config:
+        sens = await text_sensor.new_text_sensor(config[CONF_HISTORY])
+        cg.add(var.set_history_sensor(sens))
+    if CONF_PUBLISHES_EMITTED in config:
+        sens = await sensor.new_sensor(config[CONF_PUBLISHES_EMITTED])
+        cg.add(var.set_publishes_emitted_sensor(sens))
+    if CONF_PUBLISHES_SUPPRESSED in config:
+        sens = await sensor.new_sensor(config[CONF_PUBLISHES_SUPPRESSED])
+        cg.add(var.set_publishes_suppressed_sensor(sens))
+    for key, (stat, _) in LINK_STAT_SENSORS.items():
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(var.set_link_stat_sensor(stat, sens))
 
     # Number component for injected per pulse
     if CONF_INJECTED_PER_PULSE_NUMBER in config:
@@ -578,11 +1053,62 @@ async def to_code(config):
         btn = await button.new_button(config[CONF_RESET_TOTAL_CONSUMPTION_BUTTON])
         cg.add(btn.set_sunster_heater(var))
 
+    # Button component for dumping the frame trace ring to the log
+    if CONF_DUMP_TRACE_BUTTON in config:
+        btn = await button.new_button(config[CONF_DUMP_TRACE_BUTTON])
+        cg.add(btn.set_sunster_heater(var))
+
+    # Button component for exporting PI step records as CSV
+    if CONF_EXPORT_PI_TELEMETRY_BUTTON in config:
+        btn = await button.new_button(config[CONF_EXPORT_PI_TELEMETRY_BUTTON])
+        cg.add(btn.set_sunster_heater(var))
+
+    # Button component for dumping the capture ring to the log
+    if CONF_DUMP_CAPTURE_BUTTON in config:
+        btn = await button.new_button(config[CONF_DUMP_CAPTURE_BUTTON])
+        cg.add(btn.set_sunster_heater(var))
+
+    # Pump calibration: start mark and measured fuel
+    if CONF_CALIBRATION_START_BUTTON in config:
+        btn = await button.new_button(config[CONF_CALIBRATION_START_BUTTON])
+        cg.add(btn.set_sunster_heater(var))
+    if CONF_CALIBRATION_FUEL_NUMBER in config:
+        num_config = config[CONF_CALIBRATION_FUEL_NUMBER]
+        num = await number.new_number(num_config, min_value=num_config["min_value"], max_value=num_config["max_value"], step=num_config["step"])
+        cg.add(num.set_sunster_heater(var))
+
+    # Tank level: sensors, refill button and partial-refill number
+    for key, setter in (
+        (CONF_TANK_REMAINING, var.set_tank_remaining_sensor),
+        (CONF_TANK_RUNTIME, var.set_tank_runtime_sensor),
+        (CONF_TANK_RUNTIME_AVERAGE, var.set_tank_runtime_average_sensor),
+    ):
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(setter(sens))
+            add_publish_filter(var, key, config[key])
+    if CONF_TANK_REFILL_BUTTON in config:
+        btn = await button.new_button(config[CONF_TANK_REFILL_BUTTON])
+        cg.add(btn.set_sunster_heater(var))
+    if CONF_TANK_ADD_FUEL_NUMBER in config:
+        num_config = config[CONF_TANK_ADD_FUEL_NUMBER]
+        num = await number.new_number(num_config, min_value=num_config["min_value"], max_value=num_config["max_value"], step=num_config["step"])
+        cg.add(num.set_sunster_heater(var))
+
+    # Usage history: dump button and day selector for the history text sensor
+    if CONF_DUMP_HISTORY_BUTTON in config:
+        btn = await button.new_button(config[CONF_DUMP_HISTORY_BUTTON])
+        cg.add(btn.set_sunster_heater(var))
+    if CONF_HISTORY_DAY_NUMBER in config:
+        num_config = config[CONF_HISTORY_DAY_NUMBER]
+        num = await number.new_number(num_config, min_value=num_config["min_value"], max_value=num_config["max_value"], step=num_config["step"])
+        cg.add(num.set_sunster_heater(var))
+
     # Select component for control mode
     if CONF_CONTROL_MODE_SELECT in config:
         sel = await select.new_select(
             config[CONF_CONTROL_MODE_SELECT],
-            options=["Manual", "Automatic", "Antifreeze", "Fan Only"]
+            options=["Manual", "Automatic", "Antifreeze", "Fan Only", "Autotune", "Economy"]
         )
         cg.add(sel.set_sunster_heater(var))
         cg.add(var.set_control_mode_select(sel))
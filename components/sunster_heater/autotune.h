@@ -0,0 +1,283 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Step-response identification for the automatic-mode PI controller.
+//
+// The heater is held at a low power level in stable combustion until the cabin temperature
+// trend is established (baseline), then stepped to a high level. A cabin with a heater is
+// lag dominant, so the response is treated as integrating plus dead time (SIMC):
+//   plant gain  k' = (max slope after step - baseline slope) / (high% - low%)   [°C/s per %]
+//   dead time   θ  = where the max-slope tangent leaves the baseline trend      [s]
+//   Kp = 1 / (k' (τc + θ)),  Ti = 4 (τc + θ),  Ki = Kp / Ti,  τc = θ,  t_lookahead = θ
+// The experiment ends once the slope has peaked, so it does not wait for steady state.
+// Dependency-free; SunsterHeater owns the heater and the safety checks.
+enum class AutotunePhase : uint8_t {
+  IDLE = 0,
+  WAIT_STABLE,  // heater starting at the low level
+  BASELINE,     // low level, measuring the baseline trend
+  STEP,         // high level, waiting for the slope to peak
+  DONE,
+  FAILED,
+};
+
+inline const char *autotune_phase_to_string(AutotunePhase phase) {
+  switch (phase) {
+    case AutotunePhase::IDLE: return "Idle";
+    case AutotunePhase::WAIT_STABLE: return "Waiting for stable combustion";
+    case AutotunePhase::BASELINE: return "Baseline";
+    case AutotunePhase::STEP: return "Step";
+    case AutotunePhase::DONE: return "Done";
+    case AutotunePhase::FAILED: return "Failed";
+    default: return "?";
+  }
+}
+
+struct AutotuneConfig {
+  float low_percent{30.0f};
+  float high_percent{100.0f};
+  float slope_window_s{45.0f};       // regression window for the temperature slope
+  float baseline_s{300.0f};          // time at the low level before the step
+  float stable_timeout_s{900.0f};    // start-up must reach stable combustion within this
+  float max_step_s{2700.0f};         // give up waiting for the slope peak after this
+  float max_temperature_c{30.0f};    // stop the step early once the cabin reaches this
+  float max_sample_age_s{120.0f};    // give up when no temperature sample arrives for this long
+};
+
+struct AutotuneResult {
+  float baseline_slope;  // °C/s at the low level
+  float max_slope;       // °C/s, peak after the step
+  float plant_gain;      // k', °C/s per %
+  float dead_time_s;
+  float kp;              // %/°C
+  float ki;              // %/(°C·s)
+  float t_lookahead_s;
+};
+
+class PiAutotuner {
+ public:
+  static constexpr size_t SAMPLES = 64;          // regression ring
+  static constexpr float MIN_SLOPE_GAIN = 0.0005f;  // °C/s, smaller step responses are noise
+  static constexpr float PEAK_FRACTION = 0.7f;   // slope below this fraction of the peak = peak passed
+  static constexpr float MIN_DEAD_TIME_S = 10.0f;
+
+  void start(uint32_t now, const AutotuneConfig &config) {
+    config_ = config;
+    phase_ = AutotunePhase::WAIT_STABLE;
+    failure_ = nullptr;
+    result_ = AutotuneResult{};
+    origin_ms_ = phase_ms_ = sample_ms_ = now;
+    count_ = head_ = 0;
+    max_slope_ = NAN;
+  }
+
+  void abort(const char *reason) {
+    if (!this->is_running())
+      return;
+    phase_ = AutotunePhase::FAILED;
+    failure_ = reason;
+  }
+
+  void reset() { phase_ = AutotunePhase::IDLE; }
+
+  // Feed one temperature sample; stable = heater is in STABLE_COMBUSTION. Returns the phase.
+  AutotunePhase update(uint32_t now, float temperature, bool stable) {
+    float phase_s = (now - phase_ms_) / 1000.0f;
+    sample_ms_ = now;
+    switch (phase_) {
+      case AutotunePhase::WAIT_STABLE:
+        if (stable) {
+          this->enter_(AutotunePhase::BASELINE, now);
+        } else if (phase_s >= config_.stable_timeout_s) {
+          this->fail_("no stable combustion");
+        }
+        break;
+      case AutotunePhase::BASELINE:
+        if (!stable) {
+          this->fail_("combustion lost");
+          break;
+        }
+        this->add_sample_(now, temperature);
+        if (phase_s >= config_.baseline_s && this->window_full_()) {
+          float mean_t, mean_c;
+          result_.baseline_slope = this->slope_(mean_t, mean_c);
+          // Baseline trend, extrapolated from the regression mean to the step time
+          step_s_ = this->seconds_(now);
+          step_c_ = mean_c + result_.baseline_slope * (step_s_ - mean_t);
+          this->enter_(AutotunePhase::STEP, now);
+        }
+        break;
+      case AutotunePhase::STEP:
+        if (!stable) {
+          this->fail_("combustion lost");
+          break;
+        }
+        this->add_sample_(now, temperature);
+        this->track_peak_();
+        if (this->peak_passed_() || temperature >= config_.max_temperature_c || phase_s >= config_.max_step_s) {
+          this->finish_();
+        }
+        break;
+      default:
+        break;
+    }
+    return phase_;
+  }
+
+  // Time limits that must hold even when no samples arrive (call periodically): the age of the
+  // last sample and each phase's duration. Returns the phase.
+  AutotunePhase check_timeouts(uint32_t now) {
+    if (!this->is_running())
+      return phase_;
+    float phase_s = (now - phase_ms_) / 1000.0f;
+    if ((now - sample_ms_) / 1000.0f > config_.max_sample_age_s) {
+      this->fail_("no temperature samples");
+    } else if (phase_ == AutotunePhase::WAIT_STABLE && phase_s >= config_.stable_timeout_s) {
+      this->fail_("no stable combustion");
+    } else if (phase_ == AutotunePhase::BASELINE && phase_s >= config_.baseline_s + config_.max_sample_age_s) {
+      this->fail_("no baseline");
+    } else if (phase_ == AutotunePhase::STEP && phase_s >= config_.max_step_s) {
+      this->finish_();
+    }
+    return phase_;
+  }
+
+  bool is_running() const {
+    return phase_ == AutotunePhase::WAIT_STABLE || phase_ == AutotunePhase::BASELINE || phase_ == AutotunePhase::STEP;
+  }
+  float requested_percent() const {
+    return phase_ == AutotunePhase::STEP ? config_.high_percent : config_.low_percent;
+  }
+  AutotunePhase phase() const { return phase_; }
+  const AutotuneResult &result() const { return result_; }
+  const char *failure_reason() const { return failure_ != nullptr ? failure_ : ""; }
+  float phase_elapsed_s(uint32_t now) const { return (now - phase_ms_) / 1000.0f; }
+
+ protected:
+  struct Sample {
+    float t;  // s since start()
+    float c;
+  };
+
+  float seconds_(uint32_t now) const { return (now - origin_ms_) / 1000.0f; }
+
+  void enter_(AutotunePhase phase, uint32_t now) {
+    phase_ = phase;
+    phase_ms_ = now;
+    count_ = head_ = 0;  // the regression window never spans a level change
+  }
+
+  void fail_(const char *reason) {
+    phase_ = AutotunePhase::FAILED;
+    failure_ = reason;
+  }
+
+  void add_sample_(uint32_t now, float temperature) {
+    samples_[head_] = Sample{this->seconds_(now), temperature};
+    head_ = (head_ + 1) % SAMPLES;
+    if (count_ < SAMPLES)
+      count_++;
+  }
+
+  const Sample &sample_(size_t age) const { return samples_[(head_ + SAMPLES - 1 - age) % SAMPLES]; }
+
+  // Samples inside the slope window, newest first
+  size_t window_count_() const {
+    if (count_ == 0)
+      return 0;
+    float newest = this->sample_(0).t;
+    size_t n = 1;
+    while (n < count_ && newest - this->sample_(n).t <= config_.slope_window_s)
+      n++;
+    return n;
+  }
+
+  bool window_full_() const {
+    size_t n = this->window_count_();
+    return n >= 3 && (n == SAMPLES || this->sample_(0).t - this->sample_(n - 1).t >= 0.75f * config_.slope_window_s);
+  }
+
+  // Least-squares slope over the window; the fitted line passes through (mean_t, mean_c)
+  float slope_(float &mean_t, float &mean_c) const {
+    size_t n = this->window_count_();
+    mean_t = mean_c = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+      mean_t += this->sample_(i).t;
+      mean_c += this->sample_(i).c;
+    }
+    mean_t /= n;
+    mean_c /= n;
+    float sxy = 0.0f, sxx = 0.0f;
+    for (size_t i = 0; i < n; i++) {
+      float dt = this->sample_(i).t - mean_t;
+      sxy += dt * (this->sample_(i).c - mean_c);
+      sxx += dt * dt;
+    }
+    return sxx > 0.0f ? sxy / sxx : 0.0f;
+  }
+
+  void track_peak_() {
+    if (!this->window_full_())
+      return;
+    float mean_t, mean_c;
+    last_slope_ = this->slope_(mean_t, mean_c);
+    if (std::isnan(max_slope_) || last_slope_ > max_slope_) {
+      max_slope_ = last_slope_;
+      peak_t_ = mean_t;
+      peak_c_ = mean_c;
+    }
+  }
+
+  bool peak_passed_() const {
+    // The peak must be a full window old so sensor noise on the rising edge does not end the step
+    return !std::isnan(max_slope_) && max_slope_ - result_.baseline_slope >= MIN_SLOPE_GAIN &&
+           last_slope_ - result_.baseline_slope < PEAK_FRACTION * (max_slope_ - result_.baseline_slope) &&
+           this->sample_(0).t - peak_t_ >= 1.5f * config_.slope_window_s;
+  }
+
+  void finish_() {
+    float gain = std::isnan(max_slope_) ? 0.0f : max_slope_ - result_.baseline_slope;
+    if (gain < MIN_SLOPE_GAIN) {
+      this->fail_("no measurable response");
+      return;
+    }
+    // Intersection of the max-slope tangent with the baseline trend (both relative to the step)
+    float dead_time = (peak_c_ - step_c_ - max_slope_ * (peak_t_ - step_s_)) / (result_.baseline_slope - max_slope_);
+    if (dead_time < MIN_DEAD_TIME_S)
+      dead_time = MIN_DEAD_TIME_S;
+
+    result_.max_slope = max_slope_;
+    result_.plant_gain = gain / (config_.high_percent - config_.low_percent);
+    result_.dead_time_s = dead_time;
+    float closed_loop = 2.0f * dead_time;  // τc + θ with τc = θ
+    result_.kp = 1.0f / (result_.plant_gain * closed_loop);
+    result_.ki = result_.kp / (4.0f * closed_loop);
+    result_.t_lookahead_s = dead_time;
+    phase_ = AutotunePhase::DONE;
+  }
+
+  AutotuneConfig config_;
+  AutotuneResult result_{};
+  AutotunePhase phase_{AutotunePhase::IDLE};
+  const char *failure_{nullptr};
+  uint32_t origin_ms_{0};
+  uint32_t phase_ms_{0};
+  uint32_t sample_ms_{0};  // last update()
+  Sample samples_[SAMPLES]{};
+  size_t head_{0};
+  size_t count_{0};
+  float step_s_{0.0f};
+  float step_c_{0.0f};
+  float max_slope_{NAN};
+  float last_slope_{0.0f};
+  float peak_t_{0.0f};
+  float peak_c_{0.0f};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
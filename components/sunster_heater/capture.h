@@ -0,0 +1,223 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Binary capture of bus traffic and temperature samples, recorded on the device into a
+// RAM ring (oldest records are evicted) and dumped to the log as base64.
+//
+// Stream layout (all integers little-endian):
+//   header:  "SHC" 0x01 | base_ms u32          (8 bytes; base_ms = time origin of the first record)
+//   record:  type u8 | dt_ms u16 | len u8 | payload[len]
+//     RX / TX      payload = raw frame bytes
+//     TEMPERATURE  payload = int16 centi-°C (INT16_MIN = NaN, clamped to +/-327.67 °C)
+//     TIME         payload = absolute ms u32; emitted when dt would overflow u16 (dt_ms = 0)
+// A record's absolute time is the previous record's time + dt_ms (or the TIME payload).
+enum class CaptureRecordType : uint8_t {
+  RX = 1,
+  TX = 2,
+  TEMPERATURE = 3,
+  TIME = 4,
+};
+
+class CaptureBuffer {
+ public:
+  static constexpr uint8_t MAGIC[4] = {'S', 'H', 'C', 0x01};
+  static constexpr size_t HEADER_SIZE = 8;
+  static constexpr size_t RECORD_HEADER_SIZE = 4;
+
+  // Allocates the ring once; returns false (capture disabled) if the allocation fails
+  bool allocate(size_t capacity) {
+    storage_.reset(new (std::nothrow) uint8_t[capacity]);
+    capacity_ = storage_ ? capacity : 0;
+    this->clear();
+    return capacity_ > 0;
+  }
+
+  bool is_enabled() const { return capacity_ > 0 && !paused_; }
+  void set_paused(bool paused) { paused_ = paused; }
+
+  void clear() {
+    head_ = tail_ = used_ = 0;
+    records_ = 0;
+    started_ = false;
+  }
+
+  void record(CaptureRecordType type, uint32_t now, const uint8_t *payload, uint8_t len) {
+    if (!this->is_enabled() || RECORD_HEADER_SIZE + len > capacity_)
+      return;
+    if (!started_) {
+      started_ = true;
+      base_ms_ = last_ms_ = now;
+    }
+    uint32_t dt = now - last_ms_;
+    if (dt > 0xFFFF) {
+      uint8_t abs[4] = {static_cast<uint8_t>(now), static_cast<uint8_t>(now >> 8), static_cast<uint8_t>(now >> 16),
+                        static_cast<uint8_t>(now >> 24)};
+      this->append_(CaptureRecordType::TIME, 0, abs, sizeof(abs));
+      dt = 0;
+    }
+    last_ms_ = now;
+    this->append_(type, static_cast<uint16_t>(dt), payload, len);
+  }
+
+  void record_temperature(uint32_t now, float celsius) {
+    int16_t centi = INT16_MIN;
+    if (!std::isnan(celsius)) {
+      // Clamped to the int16 range (INT16_MIN stays reserved for NaN); fmin/fmax also catch +/-inf
+      float scaled = std::fmax(INT16_MIN + 1.0f, std::fmin(INT16_MAX, celsius * 100.0f));
+      centi = static_cast<int16_t>(std::lround(scaled));
+    }
+    uint8_t payload[2] = {static_cast<uint8_t>(centi), static_cast<uint8_t>(static_cast<uint16_t>(centi) >> 8)};
+    this->record(CaptureRecordType::TEMPERATURE, now, payload, sizeof(payload));
+  }
+
+  // Logical stream = header + ring contents (oldest first); copies up to len bytes from offset
+  size_t stream_size() const { return HEADER_SIZE + used_; }
+  size_t read_stream(size_t offset, uint8_t *out, size_t len) const {
+    size_t n = 0;
+    while (n < len && offset < this->stream_size()) {
+      out[n++] = offset < HEADER_SIZE ? this->header_byte_(offset) : this->at_(offset - HEADER_SIZE);
+      offset++;
+    }
+    return n;
+  }
+
+  size_t capacity() const { return capacity_; }
+  size_t used() const { return used_; }
+  uint32_t records() const { return records_; }
+  uint32_t evicted() const { return evicted_; }
+
+ protected:
+  uint8_t at_(size_t logical) const { return storage_[(tail_ + logical) % capacity_]; }
+
+  uint8_t header_byte_(size_t i) const {
+    return i < sizeof(MAGIC) ? MAGIC[i] : static_cast<uint8_t>(base_ms_ >> (8 * (i - sizeof(MAGIC))));
+  }
+
+  void push_(uint8_t byte) {
+    storage_[head_] = byte;
+    head_ = (head_ + 1) % capacity_;
+    used_++;
+  }
+
+  // Drop the oldest record and move base_ms_ to its absolute time
+  void evict_() {
+    CaptureRecordType type = static_cast<CaptureRecordType>(this->at_(0));
+    uint16_t dt = this->at_(1) | (this->at_(2) << 8);
+    size_t len = this->at_(3);
+    if (type == CaptureRecordType::TIME) {
+      base_ms_ = static_cast<uint32_t>(this->at_(4)) | (static_cast<uint32_t>(this->at_(5)) << 8) |
+                 (static_cast<uint32_t>(this->at_(6)) << 16) | (static_cast<uint32_t>(this->at_(7)) << 24);
+    } else {
+      base_ms_ += dt;
+    }
+    size_t total = RECORD_HEADER_SIZE + len;
+    tail_ = (tail_ + total) % capacity_;
+    used_ -= total;
+    records_--;
+    evicted_++;
+  }
+
+  void append_(CaptureRecordType type, uint16_t dt, const uint8_t *payload, uint8_t len) {
+    size_t total = RECORD_HEADER_SIZE + len;
+    while (capacity_ - used_ < total)
+      this->evict_();
+    this->push_(static_cast<uint8_t>(type));
+    this->push_(static_cast<uint8_t>(dt));
+    this->push_(static_cast<uint8_t>(dt >> 8));
+    this->push_(len);
+    for (uint8_t i = 0; i < len; i++)
+      this->push_(payload[i]);
+    records_++;
+  }
+
+  std::unique_ptr<uint8_t[]> storage_;
+  size_t capacity_{0};
+  size_t head_{0};
+  size_t tail_{0};
+  size_t used_{0};
+  uint32_t records_{0};
+  uint32_t evicted_{0};
+  uint32_t base_ms_{0};
+  uint32_t last_ms_{0};
+  bool started_{false};
+  bool paused_{false};
+};
+
+// One decoded record of a dumped stream; payload points into the reader's buffer
+struct CaptureRecord {
+  CaptureRecordType type;
+  uint32_t time_ms;  // absolute, same time base as millis() on the device
+  const uint8_t *payload;
+  uint8_t len;
+};
+
+// Sequential reader for a dumped stream (header + records), for host-side replay tools.
+// TIME records are applied internally and not returned.
+class CaptureReader {
+ public:
+  CaptureReader(const uint8_t *data, size_t size) : data_(data), size_(size) {
+    valid_ = size >= CaptureBuffer::HEADER_SIZE;
+    for (size_t i = 0; valid_ && i < sizeof(CaptureBuffer::MAGIC); i++)
+      valid_ = data[i] == CaptureBuffer::MAGIC[i];
+    if (valid_)
+      time_ms_ = u32_(data + sizeof(CaptureBuffer::MAGIC));
+    pos_ = CaptureBuffer::HEADER_SIZE;
+  }
+
+  bool is_valid() const { return valid_; }
+  // Stream ended inside a record (e.g. a log line missing from the dump)
+  bool is_truncated() const { return truncated_; }
+
+  bool next(CaptureRecord &rec) {
+    while (valid_ && pos_ + CaptureBuffer::RECORD_HEADER_SIZE <= size_) {
+      const uint8_t *p = data_ + pos_;
+      uint8_t len = p[3];
+      if (pos_ + CaptureBuffer::RECORD_HEADER_SIZE + len > size_)
+        break;
+      pos_ += CaptureBuffer::RECORD_HEADER_SIZE + len;
+      const uint8_t *payload = p + CaptureBuffer::RECORD_HEADER_SIZE;
+      CaptureRecordType type = static_cast<CaptureRecordType>(p[0]);
+      if (type == CaptureRecordType::TIME) {
+        if (len >= 4)
+          time_ms_ = u32_(payload);
+        continue;
+      }
+      time_ms_ += static_cast<uint16_t>(p[1] | (p[2] << 8));
+      rec = CaptureRecord{type, time_ms_, payload, len};
+      return true;
+    }
+    truncated_ = valid_ && pos_ < size_;
+    return false;
+  }
+
+  static float temperature(const CaptureRecord &rec) {
+    if (rec.len < 2)
+      return NAN;
+    int16_t centi = static_cast<int16_t>(rec.payload[0] | (rec.payload[1] << 8));
+    return centi == INT16_MIN ? NAN : centi / 100.0f;
+  }
+
+ protected:
+  static uint32_t u32_(const uint8_t *p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) | (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+  }
+
+  const uint8_t *data_;
+  size_t size_;
+  size_t pos_{0};
+  uint32_t time_ms_{0};
+  bool valid_{false};
+  bool truncated_{false};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Stable IDs of the persisted tunables. Never renumber or reuse a tag; new parameters get
+// the next free number.
+enum class ConfigTag : uint16_t {
+  PI_KP = 1,
+  PI_KI = 2,
+  PI_KD = 3,
+  TARGET_TEMPERATURE = 4,
+  PI_OUTPUT_MIN_OFF = 5,
+  PI_OUTPUT_MIN_ON = 6,
+  INJECTED_PER_PULSE = 7,
+  PI_OFF_DELAY = 8,
+  PI_MIN_ON_TIME = 9,
+  PI_ON_DELAY = 10,
+  T_LOOKAHEAD = 11,
+  SLOPE_WINDOW = 12,
+  OUTPUT_OFF_THRESHOLD = 13,
+  OUTPUT_ON_THRESHOLD = 14,
+};
+
+// One tag-length-value record, stored in its own preference slot keyed by the tag. 16 bytes.
+struct ConfigRecord {
+  uint16_t tag;
+  uint8_t length;     // bytes used in value
+  uint8_t reserved;
+  uint8_t value[8];
+  uint32_t check;     // rejects never-written or foreign slots
+};
+
+// Tag-length-value config store.
+//
+// Each parameter lives in its own record keyed by a stable tag, so a change rewrites one small
+// record instead of the whole config, and adding a parameter needs no version bump: a tag that
+// was never written keeps its YAML default (records are only written once a value changes at
+// runtime). Records of tags this firmware does not know are never read or written, so they
+// survive a downgrade and the next upgrade. Values are bound to the component's members; the
+// component owns the preference slots.
+class ConfigStore {
+ public:
+  static constexpr size_t MAX_ENTRIES = 16;
+  static constexpr uint32_t MAGIC = 0x53484346u;
+
+  static uint32_t checksum(const ConfigRecord &rec) {
+    uint32_t check = MAGIC ^ (static_cast<uint32_t>(rec.tag) << 16) ^ (static_cast<uint32_t>(rec.length) << 8);
+    for (size_t i = 0; i < sizeof(rec.value); i++)
+      check = (check << 5 | check >> 27) ^ rec.value[i];
+    return check;
+  }
+  static bool is_valid(const ConfigRecord &rec, uint16_t tag) {
+    return rec.tag == tag && rec.length <= sizeof(rec.value) && rec.check == checksum(rec);
+  }
+
+  bool bind(ConfigTag tag, float *value) {
+    if (count_ >= MAX_ENTRIES)
+      return false;
+    entries_[count_++] = Entry{static_cast<uint16_t>(tag), value, bits_(*value), false, false};
+    return true;
+  }
+
+  size_t size() const { return count_; }
+  uint16_t tag(size_t i) const { return entries_[i].tag; }
+
+  // Boot: applies a loaded record; NaN or malformed values keep the current (YAML) value
+  bool apply(size_t i, const ConfigRecord &rec) {
+    Entry &entry = entries_[i];
+    if (!is_valid(rec, entry.tag) || rec.length < sizeof(float))
+      return false;
+    float value;
+    std::memcpy(&value, rec.value, sizeof(value));
+    if (std::isnan(value))
+      return false;
+    *entry.value = value;
+    this->mark_stored(i);
+    return true;
+  }
+
+  bool is_stored(size_t i) const { return entries_[i].stored; }
+  // The bound value differs from its record (or, without a record, from the YAML value)
+  bool is_dirty(size_t i) const { return entries_[i].force || bits_(*entries_[i].value) != entries_[i].stored_bits; }
+  // Write on the next save even if unchanged (migration)
+  void mark_dirty(size_t i) { entries_[i].force = true; }
+  int find(ConfigTag tag) const {
+    for (size_t i = 0; i < count_; i++) {
+      if (entries_[i].tag == static_cast<uint16_t>(tag))
+        return static_cast<int>(i);
+    }
+    return -1;
+  }
+
+  void encode(size_t i, ConfigRecord &rec) const {
+    std::memset(&rec, 0, sizeof(rec));
+    rec.tag = entries_[i].tag;
+    rec.length = sizeof(float);
+    std::memcpy(rec.value, entries_[i].value, sizeof(float));
+    rec.check = checksum(rec);
+  }
+  void mark_stored(size_t i) {
+    entries_[i].stored_bits = bits_(*entries_[i].value);
+    entries_[i].stored = true;
+    entries_[i].force = false;
+  }
+
+ protected:
+  struct Entry {
+    uint16_t tag;
+    float *value;
+    uint32_t stored_bits;  // value in the record (YAML value until stored), compared bitwise
+    bool stored;
+    bool force;
+  };
+
+  static uint32_t bits_(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+  }
+
+  Entry entries_[MAX_ENTRIES]{};
+  size_t count_{0};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
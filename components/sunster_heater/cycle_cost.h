@@ -0,0 +1,194 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Coarse heater phase for the cycle bookkeeping (mapped from HeaterState by the component)
+enum class CyclePhase : uint8_t {
+  OFF = 0,
+  STARTING,  // glow plug preheat / ignition / heating up
+  RUNNING,   // stable combustion
+  STOPPING,  // cooling down
+};
+
+// Measured cost of one start and one stop
+struct CycleCost {
+  float start_fuel_ml;   // fuel from start request to stable combustion
+  float start_s;
+  float glow_wh;         // glow plug energy (V x I) during the start
+  float voltage_sag_v;   // supply voltage before the start minus the minimum during it
+  float stop_fuel_ml;    // fuel burnt while cooling down (normally ~0)
+  float stop_s;
+};
+
+// Measures what a start-stop cycle really costs and decides whether bridging a predicted
+// off period at the minimum level is cheaper than stopping.
+//
+// Stopping and restarting costs one start (fuel while heating up, glow plug energy) plus the
+// cool-down; idling at 10 % costs idle_fuel x off time. The break-even idle time is
+//   t_be = (start fuel + stop fuel + penalty) / idle fuel rate
+// Idling is chosen when the predicted off period is shorter than t_be and is given up once it
+// has lasted t_be (ski-rental rule: never more than twice the cost of the better choice when
+// the prediction is wrong). Costs and off periods are exponential averages over recent cycles.
+class CycleCostTracker {
+ public:
+  static constexpr float AVERAGE_WEIGHT = 0.25f;  // weight of the newest cycle
+  static constexpr float MAX_OFF_S = 3600.0f;     // longer off periods are clamped
+  static constexpr float MAX_DT_S = 10.0f;        // longer gaps between frames are not integrated
+
+  // Once per heater status frame; fuel_ml is the running fuel counter, voltage 0 = not reported
+  void update(uint32_t now_ms, CyclePhase phase, float fuel_ml, float voltage, float glow_current) {
+    float dt = last_ms_ != 0 ? (now_ms - last_ms_) / 1000.0f : 0.0f;
+    last_ms_ = now_ms;
+    if (dt > MAX_DT_S)
+      dt = 0.0f;
+
+    if (phase != phase_) {
+      if (phase == CyclePhase::STARTING) {
+        start_ms_ = now_ms;
+        start_fuel_ml_ = fuel_ml;
+        voltage_ref_ = voltage_ > 0.0f ? voltage_ : voltage;
+        voltage_min_ = NAN;
+        glow_wh_ = 0.0f;
+      } else if (phase == CyclePhase::RUNNING && phase_ == CyclePhase::STARTING) {
+        this->finish_start_(now_ms, fuel_ml);
+      } else if (phase_ == CyclePhase::STARTING) {
+        failed_starts_++;  // back to OFF/STOPPING without reaching stable combustion
+      }
+      if (phase == CyclePhase::STOPPING) {
+        stop_ms_ = now_ms;
+        stop_fuel_ml_ = fuel_ml;
+      } else if (phase == CyclePhase::OFF && phase_ == CyclePhase::STOPPING) {
+        this->finish_stop_(now_ms, fuel_ml);
+      }
+      phase_ = phase;
+    }
+
+    if (phase == CyclePhase::STARTING) {
+      if (voltage > 0.0f && (std::isnan(voltage_min_) || voltage < voltage_min_))
+        voltage_min_ = voltage;
+      glow_wh_ += voltage * glow_current * dt / 3600.0f;
+    } else if (voltage > 0.0f) {
+      voltage_ = voltage;
+    }
+  }
+
+  // Off periods between an automatic stop and the next automatic start
+  void note_auto_stop(uint32_t now_ms) { off_since_ms_ = now_ms; }
+  void note_auto_start(uint32_t now_ms) {
+    if (off_since_ms_ == 0)
+      return;
+    float off_s = std::fmin((now_ms - off_since_ms_) / 1000.0f, MAX_OFF_S);
+    off_s_ = off_periods_ == 0 ? off_s : off_s_ + AVERAGE_WEIGHT * (off_s - off_s_);
+    last_off_s_ = off_s;
+    off_periods_++;
+    off_since_ms_ = 0;
+  }
+  void cancel_off_period() { off_since_ms_ = 0; }
+
+  bool has_cost() const { return starts_ > 0; }
+  // Average cost of one stop + restart in ml; penalty_ml prices battery drain / glow plug wear
+  float cycle_cost_ml(float penalty_ml) const {
+    return average_.start_fuel_ml + (stops_ > 0 ? average_.stop_fuel_ml : 0.0f) + penalty_ml;
+  }
+  float break_even_s(float idle_fuel_ml_s, float penalty_ml) const {
+    if (!this->has_cost() || !(idle_fuel_ml_s > 0.0f))
+      return 0.0f;
+    return this->cycle_cost_ml(penalty_ml) / idle_fuel_ml_s;
+  }
+
+  // Idle decision bookkeeping
+  void begin_idle(uint32_t now_ms) {
+    idle_since_ms_ = now_ms;
+    idle_decisions_++;
+  }
+  // bridged = the controller asked for heat again before idling was given up
+  void end_idle(uint32_t now_ms, bool bridged) {
+    if (idle_since_ms_ == 0)
+      return;
+    idle_s_ += (now_ms - idle_since_ms_) / 1000.0f;
+    if (bridged)
+      idle_bridged_++;
+    idle_since_ms_ = 0;
+  }
+  void count_stop_decision() { stop_decisions_++; }
+  bool is_idling() const { return idle_since_ms_ != 0; }
+  float idle_elapsed_s(uint32_t now_ms) const {
+    return idle_since_ms_ != 0 ? (now_ms - idle_since_ms_) / 1000.0f : 0.0f;
+  }
+
+  CyclePhase phase() const { return phase_; }
+  const CycleCost &last() const { return last_; }
+  const CycleCost &average() const { return average_; }
+  uint32_t starts() const { return starts_; }
+  uint32_t stops() const { return stops_; }
+  uint32_t failed_starts() const { return failed_starts_; }
+  uint32_t off_periods() const { return off_periods_; }
+  float average_off_s() const { return off_periods_ > 0 ? off_s_ : NAN; }
+  float last_off_s() const { return off_periods_ > 0 ? last_off_s_ : NAN; }
+  uint32_t idle_decisions() const { return idle_decisions_; }
+  uint32_t idle_bridged() const { return idle_bridged_; }
+  uint32_t stop_decisions() const { return stop_decisions_; }
+  float idle_s() const { return idle_s_; }
+
+ protected:
+  static void blend_(float &average, float sample, bool first) {
+    average = first ? sample : average + AVERAGE_WEIGHT * (sample - average);
+  }
+
+  void finish_start_(uint32_t now_ms, float fuel_ml) {
+    last_.start_fuel_ml = std::fmax(0.0f, fuel_ml - start_fuel_ml_);  // counter reset during the start
+    last_.start_s = (now_ms - start_ms_) / 1000.0f;
+    last_.glow_wh = glow_wh_;
+    last_.voltage_sag_v = std::isnan(voltage_min_) || !(voltage_ref_ > 0.0f) ? 0.0f
+                                                                              : std::fmax(0.0f, voltage_ref_ - voltage_min_);
+    bool first = starts_ == 0;
+    blend_(average_.start_fuel_ml, last_.start_fuel_ml, first);
+    blend_(average_.start_s, last_.start_s, first);
+    blend_(average_.glow_wh, last_.glow_wh, first);
+    blend_(average_.voltage_sag_v, last_.voltage_sag_v, first);
+    starts_++;
+  }
+
+  void finish_stop_(uint32_t now_ms, float fuel_ml) {
+    last_.stop_fuel_ml = std::fmax(0.0f, fuel_ml - stop_fuel_ml_);
+    last_.stop_s = (now_ms - stop_ms_) / 1000.0f;
+    bool first = stops_ == 0;
+    blend_(average_.stop_fuel_ml, last_.stop_fuel_ml, first);
+    blend_(average_.stop_s, last_.stop_s, first);
+    stops_++;
+  }
+
+  CyclePhase phase_{CyclePhase::OFF};
+  uint32_t last_ms_{0};
+  uint32_t start_ms_{0};
+  uint32_t stop_ms_{0};
+  float start_fuel_ml_{0.0f};
+  float stop_fuel_ml_{0.0f};
+  float voltage_{0.0f};      // last voltage outside a start
+  float voltage_ref_{0.0f};
+  float voltage_min_{NAN};
+  float glow_wh_{0.0f};
+  CycleCost last_{};
+  CycleCost average_{};
+  uint32_t starts_{0};
+  uint32_t stops_{0};
+  uint32_t failed_starts_{0};
+
+  uint32_t off_since_ms_{0};
+  float off_s_{0.0f};
+  float last_off_s_{0.0f};
+  uint32_t off_periods_{0};
+
+  uint32_t idle_since_ms_{0};
+  uint32_t idle_decisions_{0};
+  uint32_t idle_bridged_{0};
+  uint32_t stop_decisions_{0};
+  float idle_s_{0.0f};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Per power level steady-state response near the target: cabin slope (°C/s) and fuel rate
+// (ml/s), learned while a level has been held long enough for the slope to settle.
+//
+// Near the target the heat loss is about the same for every level, so holding the target is a
+// mix of a level with slope <= 0 and one with slope > 0. The time share of the upper level is
+// -s_lo / (s_hi - s_lo), which gives the fuel rate of that mix at zero net slope:
+//   f = f_lo + (f_hi - f_lo) * (-s_lo) / (s_hi - s_lo)
+// best_pair() picks the cheapest such mix (lower convex hull of (slope, fuel) at slope 0);
+// adjacent_pair() is what the PI ends up dithering between and serves as the savings baseline.
+// Level 0 is the heater off (fuel 0); its slope gives the loss for the heat-per-ml figure.
+class EconomyModel {
+ public:
+  static constexpr uint8_t LEVELS = 10;
+  static constexpr float MIN_WEIGHT_S = 300.0f;  // observation time before a level is used
+  static constexpr float MEMORY_S = 7200.0f;     // forgetting horizon (ambient drifts)
+  static constexpr float TIE_MARGIN = 0.02f;     // relative fuel difference treated as equal
+
+  // Weighted running mean with exponential forgetting; level 0..LEVELS
+  void observe(uint8_t level, float slope, float fuel_ml_s, float dt_s) {
+    if (level > LEVELS || dt_s <= 0.0f || std::isnan(slope) || std::isnan(fuel_ml_s))
+      return;
+    LevelStats &stats = levels_[level];
+    stats.weight = stats.weight * (1.0f - dt_s / MEMORY_S) + dt_s;
+    if (stats.weight < dt_s) stats.weight = dt_s;
+    float k = dt_s / stats.weight;
+    stats.slope = std::isnan(stats.slope) ? slope : stats.slope + k * (slope - stats.slope);
+    stats.fuel_ml_s = std::isnan(stats.fuel_ml_s) ? fuel_ml_s : stats.fuel_ml_s + k * (fuel_ml_s - stats.fuel_ml_s);
+  }
+
+  bool is_learned(uint8_t level) const { return level <= LEVELS && levels_[level].weight >= MIN_WEIGHT_S; }
+  float slope(uint8_t level) const { return levels_[level].slope; }
+  float fuel_ml_s(uint8_t level) const { return levels_[level].fuel_ml_s; }
+  float weight_s(uint8_t level) const { return levels_[level].weight; }
+
+  // Heat per ml relative to the off slope (°C per ml, cabin specific); NaN if not learned
+  float heat_per_ml(uint8_t level) const {
+    if (level == 0 || !this->is_learned(level) || !this->is_learned(0) || levels_[level].fuel_ml_s <= 0.0f)
+      return NAN;
+    return (levels_[level].slope - levels_[0].slope) / levels_[level].fuel_ml_s;
+  }
+
+  // Cheapest learned level pair (1..LEVELS) that holds zero slope
+  bool best_pair(uint8_t &low, uint8_t &high, float &fuel_ml_s) const {
+    bool found = false;
+    int best_span = 0;  // of the current best pair; low/high are outputs only
+    for (uint8_t lo = 1; lo <= LEVELS; lo++) {
+      if (!this->is_learned(lo) || levels_[lo].slope > 0.0f)
+        continue;
+      for (uint8_t hi = 1; hi <= LEVELS; hi++) {
+        if (!this->is_learned(hi) || levels_[hi].slope <= 0.0f)
+          continue;
+        // A wider pair swings the cabin more, so it must be clearly cheaper to win
+        float f = this->mix_fuel_(lo, hi);
+        int span = hi > lo ? hi - lo : lo - hi;
+        if (!found || f < fuel_ml_s * (1.0f - TIE_MARGIN) ||
+            (f <= fuel_ml_s * (1.0f + TIE_MARGIN) && span < best_span)) {
+          found = true;
+          best_span = span;
+          low = lo;
+          high = hi;
+          fuel_ml_s = f;
+        }
+      }
+    }
+    return found;
+  }
+
+  // Nearest learned levels around zero slope by level order (what the PI settles on)
+  bool adjacent_pair(uint8_t &low, uint8_t &high, float &fuel_ml_s) const {
+    int lo = -1;
+    for (uint8_t level = 1; level <= LEVELS; level++) {
+      if (this->is_learned(level) && levels_[level].slope <= 0.0f)
+        lo = level;
+    }
+    if (lo < 0)
+      return false;
+    for (uint8_t level = lo + 1; level <= LEVELS; level++) {
+      if (this->is_learned(level) && levels_[level].slope > 0.0f) {
+        low = lo;
+        high = level;
+        fuel_ml_s = this->mix_fuel_(low, high);
+        return true;
+      }
+    }
+    return false;
+  }
+
+ protected:
+  struct LevelStats {
+    float slope{NAN};
+    float fuel_ml_s{NAN};
+    float weight{0.0f};  // seconds of observation, decayed over MEMORY_S
+  };
+
+  float mix_fuel_(uint8_t lo, uint8_t hi) const {
+    const LevelStats &a = levels_[lo];
+    const LevelStats &b = levels_[hi];
+    float share = -a.slope / (b.slope - a.slope);
+    return a.fuel_ml_s + (b.fuel_ml_s - a.fuel_ml_s) * share;
+  }
+
+  LevelStats levels_[LEVELS + 1];
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "heater_frame.h"
+
+namespace esphome {
+namespace sunster_heater {
+
+enum class TraceDirection : uint8_t {
+  RX = 0,
+  TX,
+  TX_SUPPRESSED,  // built but not sent (passive sniff mode)
+};
+
+// TraceRecord::flags
+static const uint8_t TRACE_FLAG_ECHO = 0x01;      // own controller frame read back
+static const uint8_t TRACE_FLAG_REJECTED = 0x02;  // failed validation (strict checksum)
+static const uint8_t TRACE_FLAG_DECODED = 0x04;   // status frame decoded; state is valid
+
+struct TraceRecord {
+  uint32_t time_ms;
+  TraceDirection direction;
+  uint8_t flags;
+  uint8_t state;   // decoded heater state (TRACE_FLAG_DECODED)
+  uint8_t length;
+  uint8_t data[FrameParser::CAPACITY];
+
+  FrameView view() const { return FrameView{data, length}; }
+};
+
+// Fixed-size ring of frame trace records. push() is a header store plus one memcpy, so
+// tracing can stay enabled on the frame path; formatting happens when records are popped.
+// When full the oldest record is overwritten.
+template<size_t N> class TraceRing {
+ public:
+  void push(uint32_t now, TraceDirection direction, const FrameView &frame, uint8_t flags = 0, uint8_t state = 0) {
+    TraceRecord &rec = records_[head_];
+    rec.time_ms = now;
+    rec.direction = direction;
+    rec.flags = flags;
+    rec.state = state;
+    rec.length = static_cast<uint8_t>(frame.size < FrameParser::CAPACITY ? frame.size : FrameParser::CAPACITY);
+    memcpy(rec.data, frame.data, rec.length);
+    head_ = (head_ + 1) % N;
+    if (count_ == N) {
+      overwritten_++;
+    } else {
+      count_++;
+    }
+  }
+
+  bool pop(TraceRecord &out) {
+    if (count_ == 0)
+      return false;
+    out = records_[(head_ + N - count_) % N];
+    count_--;
+    return true;
+  }
+
+  size_t size() const { return count_; }
+  static constexpr size_t capacity() { return N; }
+  uint32_t overwritten() const { return overwritten_; }
+
+ protected:
+  TraceRecord records_[N]{};
+  size_t head_{0};
+  size_t count_{0};
+  uint32_t overwritten_{0};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Exact fuel pump pulse accounting.
+//
+// Pulses are counted as 64-bit milli-pulses, so a counter never stops registering small
+// increments (a float total stalls past 2^24 pulses, about 40 days of pumping at 5 Hz).
+// The pump frequency arrives in 0.1 Hz steps; between two frames the pulse count is the
+// trapezoid of both frequencies:
+//   milli-pulses = (f0 + f1) [0.1 Hz] * dt [ms] / 20
+// The division remainder is carried into the next interval, so the running sum is exact.
+// Conversion to ml happens only for publishing.
+class FuelCounter {
+ public:
+  static constexpr uint32_t MILLI_PER_PULSE = 1000;
+
+  // Milli-pulses pumped between two frames with frequencies f0 and f1 (raw 0.1 Hz)
+  uint64_t integrate(uint8_t f0_raw, uint8_t f1_raw, uint32_t dt_ms) {
+    uint64_t scaled = static_cast<uint64_t>(f0_raw + f1_raw) * dt_ms + remainder_;
+    remainder_ = static_cast<uint32_t>(scaled % 20);
+    return scaled / 20;
+  }
+
+  void clear_remainder() { remainder_ = 0; }
+
+  static double to_pulses(uint64_t milli_pulses) { return static_cast<double>(milli_pulses) / MILLI_PER_PULSE; }
+  static float to_ml(uint64_t milli_pulses, float ml_per_pulse) {
+    return static_cast<float>(to_pulses(milli_pulses) * ml_per_pulse);
+  }
+  static uint64_t from_pulses(double pulses) {
+    return pulses > 0.0 ? static_cast<uint64_t>(pulses * MILLI_PER_PULSE + 0.5) : 0;
+  }
+
+ protected:
+  uint32_t remainder_{0};  // in 1/20 milli-pulse
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
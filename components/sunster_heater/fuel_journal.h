@@ -0,0 +1,108 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// One journal slot: fuel pumped since the previous record. 16 bytes.
+struct FuelJournalRecord {
+  uint32_t seq;                  // 0 = empty slot
+  uint32_t day;                  // day the pulses were counted on (days since epoch)
+  uint32_t delta_milli_pulses;
+  uint32_t check;                // rejects never-written or foreign slots
+};
+
+struct FuelTotals {
+  uint32_t day;
+  uint64_t daily_milli_pulses;
+  uint64_t total_milli_pulses;
+};
+
+// Append-only journal for the fuel counters over a ring of small preference slots.
+//
+// Instead of rewriting the whole counter snapshot, each save appends one compact delta record
+// to the next slot, so writes rotate over SLOTS keys. The snapshot (base) is only rewritten
+// when the ring is about to overwrite a record it does not yet cover, i.e. once per SLOTS
+// records, and on resets. On boot the base is loaded and every record with a newer seq is
+// replayed in seq order; a power cut loses at most the delta not yet appended.
+// The component owns the storage; this class only decides slots and sequence numbers.
+class FuelJournal {
+ public:
+  static constexpr size_t SLOTS = 16;
+  static constexpr uint32_t MAGIC = 0x464A524Eu;
+
+  static bool is_valid(const FuelJournalRecord &rec) {
+    return rec.seq != 0 && rec.check == (rec.seq ^ rec.day ^ rec.delta_milli_pulses ^ MAGIC);
+  }
+
+  // Boot: apply the records newer than the base to totals (loaded from the base) in seq order
+  void replay(uint32_t base_seq, FuelTotals &totals, const FuelJournalRecord *slots) {
+    base_seq_ = last_seq_ = base_seq;
+    pending_ = 0;
+    next_slot_ = 0;
+    uint32_t newest = 0;
+    for (size_t i = 0; i < SLOTS; i++) {
+      if (is_valid(slots[i]) && slots[i].seq >= newest) {
+        newest = slots[i].seq;
+        next_slot_ = (i + 1) % SLOTS;
+      }
+    }
+    // Selection by seq; SLOTS is small
+    for (;;) {
+      const FuelJournalRecord *next = nullptr;
+      for (size_t i = 0; i < SLOTS; i++) {
+        if (is_valid(slots[i]) && slots[i].seq > last_seq_ && (next == nullptr || slots[i].seq < next->seq))
+          next = &slots[i];
+      }
+      if (next == nullptr)
+        break;
+      if (next->day != totals.day) {
+        totals.day = next->day;
+        totals.daily_milli_pulses = 0;
+      }
+      totals.daily_milli_pulses += next->delta_milli_pulses;
+      totals.total_milli_pulses += next->delta_milli_pulses;
+      last_seq_ = next->seq;
+      pending_++;
+      replayed_++;
+    }
+    if (newest > last_seq_)
+      last_seq_ = newest;  // stale records from before the base keep their numbers reserved
+  }
+
+  // The base must be rewritten (covering last_seq()) before the next append
+  bool needs_compaction() const { return pending_ >= SLOTS; }
+  void compacted() {
+    base_seq_ = last_seq_;
+    pending_ = 0;
+  }
+
+  // Fills rec for the next append and returns the slot to write it to
+  size_t append(uint32_t day, uint32_t delta_milli_pulses, FuelJournalRecord &rec) {
+    rec.seq = ++last_seq_;
+    rec.day = day;
+    rec.delta_milli_pulses = delta_milli_pulses;
+    rec.check = rec.seq ^ rec.day ^ rec.delta_milli_pulses ^ MAGIC;
+    size_t slot = next_slot_;
+    next_slot_ = (next_slot_ + 1) % SLOTS;
+    pending_++;
+    return slot;
+  }
+
+  uint32_t last_seq() const { return last_seq_; }
+  uint32_t base_seq() const { return base_seq_; }
+  size_t pending() const { return pending_; }
+  uint32_t replayed() const { return replayed_; }
+
+ protected:
+  uint32_t base_seq_{0};
+  uint32_t last_seq_{0};
+  size_t pending_{0};     // records newer than the base
+  size_t next_slot_{0};
+  uint32_t replayed_{0};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,337 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Communication constants
+static const uint8_t FRAME_START = 0xAA;
+static const uint8_t CONTROLLER_ID = 0x66;
+static const uint8_t HEATER_ID = 0x77;
+static const uint8_t CONTROLLER_FRAME_LENGTH = 0x0B;
+static const uint8_t HEATER_FRAME_LENGTH = 0x34;  // 0x34 for newer firmware (57 bytes)
+static const size_t CONTROLLER_FRAME_SIZE = 16;
+static const size_t HEATER_FRAME_SIZE = 57;
+static const size_t FRAME_OVERHEAD = 5;  // start, device id, command, length byte, checksum
+
+// Non-owning view of a frame. Views handed out by FrameParser point into its
+// buffer and are only valid until the next feed().
+struct FrameView {
+  const uint8_t *data{nullptr};
+  size_t size{0};
+
+  uint8_t operator[](size_t i) const { return data[i]; }
+  bool empty() const { return size == 0; }
+};
+
+// Sum of bytes 2..n-2 modulo 256 (last byte carries the checksum)
+inline uint8_t calculate_checksum(const FrameView &frame) {
+  if (frame.size < 4) {
+    return 0;
+  }
+  uint32_t sum = 0;
+  for (size_t i = 2; i < frame.size - 1; ++i) {
+    sum += frame.data[i];
+  }
+  return static_cast<uint8_t>(sum);
+}
+
+// Controller request frame: constexpr template where only byte 2 (command), byte 8
+// (power level 1-10) and byte 9 (requested state) vary. set() patches those bytes in
+// place and adjusts the checksum by the byte deltas, so an unchanged request costs
+// three compares and no rebuild.
+class ControllerFrame {
+ public:
+  static constexpr size_t SIZE = CONTROLLER_FRAME_SIZE;
+  static constexpr size_t COMMAND_OFFSET = 2;
+  static constexpr size_t POWER_OFFSET = 8;
+  static constexpr size_t STATE_OFFSET = 9;
+  static constexpr size_t CHECKSUM_OFFSET = SIZE - 1;
+
+  // Returns true if any byte changed
+  bool set(uint8_t command, uint8_t power_level, uint8_t state) {
+    bool changed = this->patch_(COMMAND_OFFSET, command);
+    changed |= this->patch_(POWER_OFFSET, power_level);
+    changed |= this->patch_(STATE_OFFSET, state);
+    return changed;
+  }
+
+  const uint8_t *data() const { return bytes_; }
+  FrameView view() const { return FrameView{bytes_, SIZE}; }
+  uint8_t command() const { return bytes_[COMMAND_OFFSET]; }
+  uint8_t power_level() const { return bytes_[POWER_OFFSET]; }
+  uint8_t state() const { return bytes_[STATE_OFFSET]; }
+
+ protected:
+  bool patch_(size_t offset, uint8_t value) {
+    uint8_t old = bytes_[offset];
+    if (old == value)
+      return false;
+    bytes_[offset] = value;
+    bytes_[CHECKSUM_OFFSET] = static_cast<uint8_t>(bytes_[CHECKSUM_OFFSET] + value - old);
+    return true;
+  }
+
+  // Status request, power 0, state "off"; checksum precomputed
+  uint8_t bytes_[SIZE]{FRAME_START, CONTROLLER_ID, 0x02, CONTROLLER_FRAME_LENGTH, 0x00, 0x00, 0x00, 0x00,
+                       0x00,        0x02,          0x00, 0x00,                    0x00, 0x00, 0x00,
+                       static_cast<uint8_t>(0x02 + CONTROLLER_FRAME_LENGTH + 0x02)};
+};
+
+// 57-byte heater status frame (from log analysis): 0=AA 1=77 2=cmd 3=0x34, 5=state, 6=power(1-10),
+// 10-11=voltage BE/10, 13=glow current/100, 14=cooling, 15=sub-state, 16-17=temp BE/10 (signed),
+// 20-21=duration BE, 23=pump/10 Hz, 28-29=fan BE. Bytes 46+ often 24 09 20 10 then varying.
+enum class StatusField : uint8_t {
+  STATE = 0,
+  POWER_LEVEL,
+  INPUT_VOLTAGE,
+  GLOW_CURRENT,
+  COOLING,
+  SUB_STATE,
+  HEAT_EXCHANGER_TEMPERATURE,
+  STATE_DURATION,
+  PUMP_FREQUENCY,
+  FAN_SPEED,
+};
+
+struct StatusFieldSpec {
+  uint8_t offset;
+  uint8_t width;  // 1 or 2 bytes (big-endian)
+  bool is_signed;
+  float scale;    // physical value = raw * scale
+};
+
+// Decoded status frame, filled once per frame and shared by all consumers
+struct HeaterTelemetry {
+  uint8_t state_raw;
+  uint8_t power_level;        // 1-10, 0 = not reported
+  uint16_t voltage_raw;       // 0.1 V
+  float input_voltage;
+  float glow_current;
+  bool cooling;
+  uint8_t sub_state;
+  float heat_exchanger_temperature;
+  uint16_t state_duration;
+  uint8_t pump_raw;           // 0.1 Hz
+  float pump_frequency;
+  uint16_t fan_speed;
+};
+
+// Frame layouts. Each layout is a type with its device id, length byte, frame size and
+// a FIELDS table indexed by StatusField; decoders are instantiated per layout so every
+// field access is a fixed-offset load. Add a firmware variant by adding a layout type
+// and a FRAME_LAYOUTS entry.
+struct HeaterLayout0x34 {
+  static constexpr const char *NAME = "heater_0x34";
+  static constexpr uint8_t DEVICE_ID = HEATER_ID;
+  static constexpr uint8_t LENGTH_BYTE = HEATER_FRAME_LENGTH;
+  static constexpr size_t SIZE = HEATER_FRAME_SIZE;
+  static constexpr StatusFieldSpec FIELDS[] = {
+      {5, 1, false, 1.0f},    // STATE
+      {6, 1, false, 1.0f},    // POWER_LEVEL (1-10)
+      {10, 2, false, 0.1f},   // INPUT_VOLTAGE [V]
+      {13, 1, false, 0.01f},  // GLOW_CURRENT [A]
+      {14, 1, false, 1.0f},   // COOLING (flag)
+      {15, 1, false, 1.0f},   // SUB_STATE
+      {16, 2, true, 0.1f},    // HEAT_EXCHANGER_TEMPERATURE [°C]
+      {20, 2, false, 1.0f},   // STATE_DURATION [s]
+      {23, 1, false, 0.1f},   // PUMP_FREQUENCY [Hz]
+      {28, 2, false, 1.0f},   // FAN_SPEED [rpm]
+  };
+};
+
+template<typename Layout> static constexpr bool layout_fields_fit(size_t i = 0) {
+  return i >= sizeof(Layout::FIELDS) / sizeof(Layout::FIELDS[0]) ||
+         (Layout::FIELDS[i].offset + Layout::FIELDS[i].width < Layout::SIZE && layout_fields_fit<Layout>(i + 1));
+}
+static_assert(layout_fields_fit<HeaterLayout0x34>(), "heater_0x34 field table exceeds the frame");
+
+// Typed view over a heater status frame of the given layout. matches() must hold first.
+template<typename Layout> class HeaterStatusFrame {
+ public:
+  explicit HeaterStatusFrame(const FrameView &frame) : data_(frame.data) {}
+
+  static bool matches(const FrameView &frame) {
+    return frame.size == Layout::SIZE && frame[1] == Layout::DEVICE_ID && frame[3] == Layout::LENGTH_BYTE;
+  }
+
+  template<StatusField F> int32_t raw() const {
+    constexpr StatusFieldSpec spec = Layout::FIELDS[static_cast<size_t>(F)];
+    if (spec.width == 1)
+      return data_[spec.offset];
+    uint16_t v = (static_cast<uint16_t>(data_[spec.offset]) << 8) | data_[spec.offset + 1];
+    return spec.is_signed ? static_cast<int32_t>(static_cast<int16_t>(v)) : static_cast<int32_t>(v);
+  }
+
+  template<StatusField F> float value() const {
+    return this->raw<F>() * Layout::FIELDS[static_cast<size_t>(F)].scale;
+  }
+
+  HeaterTelemetry decode() const {
+    HeaterTelemetry t;
+    t.state_raw = this->raw<StatusField::STATE>();
+    t.power_level = this->raw<StatusField::POWER_LEVEL>();
+    t.voltage_raw = this->raw<StatusField::INPUT_VOLTAGE>();
+    t.input_voltage = this->value<StatusField::INPUT_VOLTAGE>();
+    t.glow_current = this->value<StatusField::GLOW_CURRENT>();
+    t.cooling = this->raw<StatusField::COOLING>() != 0;
+    t.sub_state = this->raw<StatusField::SUB_STATE>();
+    t.heat_exchanger_temperature = this->value<StatusField::HEAT_EXCHANGER_TEMPERATURE>();
+    t.state_duration = this->raw<StatusField::STATE_DURATION>();
+    t.pump_raw = this->raw<StatusField::PUMP_FREQUENCY>();
+    t.pump_frequency = this->value<StatusField::PUMP_FREQUENCY>();
+    t.fan_speed = this->raw<StatusField::FAN_SPEED>();
+    return t;
+  }
+
+ protected:
+  const uint8_t *data_;
+};
+
+template<typename Layout> static HeaterTelemetry decode_status_frame(const FrameView &frame) {
+  return HeaterStatusFrame<Layout>(frame).decode();
+}
+
+// Registry entry; decode == nullptr for frames that are recognised but not decoded (controller echo)
+struct FrameLayout {
+  const char *name;
+  uint8_t device_id;
+  uint8_t length_byte;
+  uint8_t size;
+  HeaterTelemetry (*decode)(const FrameView &frame);
+};
+
+// frame_layout in YAML pins one heater layout (-DSUNSTER_HEATER_FRAME_LAYOUT_PINNED plus
+// -DSUNSTER_HEATER_FRAME_LAYOUT_<NAME>), so the other decoders are never instantiated.
+#if !defined(SUNSTER_HEATER_FRAME_LAYOUT_PINNED) || defined(SUNSTER_HEATER_FRAME_LAYOUT_HEATER_0X34)
+#define SUNSTER_HEATER_USE_LAYOUT_HEATER_0X34
+#endif
+
+static const FrameLayout FRAME_LAYOUTS[] = {
+    {"controller_0x0b", CONTROLLER_ID, CONTROLLER_FRAME_LENGTH, CONTROLLER_FRAME_SIZE, nullptr},
+#ifdef SUNSTER_HEATER_USE_LAYOUT_HEATER_0X34
+    {HeaterLayout0x34::NAME, HeaterLayout0x34::DEVICE_ID, HeaterLayout0x34::LENGTH_BYTE, HeaterLayout0x34::SIZE,
+     &decode_status_frame<HeaterLayout0x34>},
+#endif
+};
+
+inline const FrameLayout *find_frame_layout(uint8_t device_id, uint8_t length_byte) {
+  for (const auto &layout : FRAME_LAYOUTS) {
+    if (layout.device_id == device_id && layout.length_byte == length_byte)
+      return &layout;
+  }
+  return nullptr;
+}
+
+inline const FrameLayout *find_frame_layout(const FrameView &frame) {
+  if (frame.size < 4)
+    return nullptr;
+  const FrameLayout *layout = find_frame_layout(frame[1], frame[3]);
+  return (layout != nullptr && layout->size == frame.size) ? layout : nullptr;
+}
+
+// Registered layouts give their size; unknown ones fall back to the generic
+// length byte + FRAME_OVERHEAD (0x0B -> 16, 0x34 -> 57).
+inline size_t frame_size_for(uint8_t device_id, uint8_t length_byte) {
+  const FrameLayout *layout = find_frame_layout(device_id, length_byte);
+  return layout != nullptr ? layout->size : static_cast<size_t>(length_byte) + FRAME_OVERHEAD;
+}
+
+// Byte-wise frame decoder: SYNC (wait for 0xAA) -> HEADER (id, cmd, length byte)
+// -> BODY -> CHECKSUM. Works on a fixed buffer, never allocates.
+// After a rejected frame, resync() queues the bytes after the next 0xAA candidate for
+// replay, so sync is recovered from data already received instead of the next frame.
+class FrameParser {
+ public:
+  enum class State : uint8_t { SYNC, HEADER, BODY, CHECKSUM };
+  enum class Result : uint8_t { NONE, FRAME, OVERSIZE };
+
+  static constexpr size_t CAPACITY = 64;
+  static constexpr size_t HEADER_SIZE = 4;  // start, device id, command, length byte
+  static_assert(HEATER_FRAME_SIZE <= CAPACITY, "registered layouts must fit the parser buffer");
+
+  Result feed(uint8_t byte) {
+    switch (state_) {
+      case State::SYNC:
+        if (byte != FRAME_START)
+          return Result::NONE;
+        buffer_[0] = byte;
+        length_ = 1;
+        expected_ = 0;
+        state_ = State::HEADER;
+        return Result::NONE;
+
+      case State::HEADER:
+        buffer_[length_++] = byte;
+        if (length_ < HEADER_SIZE)
+          return Result::NONE;
+        expected_ = frame_size_for(buffer_[1], buffer_[3]);
+        if (expected_ > CAPACITY) {
+          this->resync();
+          return Result::OVERSIZE;
+        }
+        state_ = (length_ + 1 == expected_) ? State::CHECKSUM : State::BODY;
+        return Result::NONE;
+
+      case State::BODY:
+        buffer_[length_++] = byte;
+        if (length_ + 1 == expected_)
+          state_ = State::CHECKSUM;
+        return Result::NONE;
+
+      case State::CHECKSUM:
+        buffer_[length_++] = byte;
+        state_ = State::SYNC;
+        return Result::FRAME;
+    }
+    return Result::NONE;
+  }
+
+  // Drop the current candidate (complete or partial) and queue everything after its
+  // start byte, beginning at the next 0xAA, for replay via take_replay().
+  void resync() {
+    size_t next = 1;
+    while (next < length_ && buffer_[next] != FRAME_START)
+      next++;
+    size_t tail = length_ - next;
+    size_t pending = replay_len_ - replay_pos_;
+    // tail + pending never exceeds CAPACITY: each resync drops at least the start byte
+    uint8_t merged[CAPACITY];
+    memcpy(merged, buffer_ + next, tail);
+    memcpy(merged + tail, replay_ + replay_pos_, pending);
+    memcpy(replay_, merged, tail + pending);
+    replay_pos_ = 0;
+    replay_len_ = tail + pending;
+    this->reset();
+  }
+
+  bool has_replay() const { return replay_pos_ < replay_len_; }
+  uint8_t take_replay() { return replay_[replay_pos_++]; }
+
+  // Completed frame; valid right after feed() returned FRAME
+  FrameView frame() const { return FrameView{buffer_, length_}; }
+  bool in_frame() const { return state_ != State::SYNC; }
+  State state() const { return state_; }
+  size_t buffered() const { return in_frame() ? length_ : 0; }
+
+  void reset() {
+    state_ = State::SYNC;
+    length_ = 0;
+    expected_ = 0;
+  }
+
+ protected:
+  uint8_t buffer_[CAPACITY]{};
+  uint8_t replay_[CAPACITY]{};
+  size_t replay_pos_{0};
+  size_t replay_len_{0};
+  size_t length_{0};
+  size_t expected_{0};
+  State state_{State::SYNC};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
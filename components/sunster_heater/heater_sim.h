@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "heater_frame.h"
+
+namespace esphome {
+namespace sunster_heater {
+
+// Closed-loop heater + cabin simulation. Takes controller frames, answers with heater status
+// frames (heater_0x34 layout) and models the cabin as a first-order thermal mass with a
+// lagged temperature sensor. Dependency-free so it can also be driven from a host program.
+struct SimConfig {
+  float ambient_c{0.0f};
+  float initial_c{5.0f};
+  float heater_power_w{2000.0f};     // heat output at power level 10
+  float heat_loss_w_per_k{40.0f};    // cabin UA
+  float thermal_mass_j_per_k{100000.0f};
+  float sensor_lag_s{60.0f};         // first-order lag between cabin air and sensor
+  float ml_per_pulse{0.022f};
+  float preheat_s{40.0f};            // POLLING_STATE (glow plug)
+  float heating_up_s{80.0f};         // HEATING_UP, heat ramps to the requested level
+  float cooling_s{150.0f};           // STOPPING_COOLING
+  float settle_band_c{0.5f};         // settling criterion for the metrics
+};
+
+// Scenario metrics on the sensor temperature. Timing/overshoot restart when the target
+// changes; fuel and start count are cumulative.
+struct SimMetrics {
+  float elapsed_s{0.0f};
+  float overshoot_c{0.0f};       // max sensor - target after first reaching the target
+  float settled_at_s{NAN};       // start of the current stay inside target +/- band (NaN = outside)
+  float fuel_ml{0.0f};
+  uint32_t starts{0};
+  bool target_reached{false};
+};
+
+class HeaterSimulator {
+ public:
+  // Raw state codes as reported in byte 5 (see HeaterState)
+  static constexpr uint8_t OFF = 0x00;
+  static constexpr uint8_t PREHEAT = 0x01;
+  static constexpr uint8_t HEATING_UP = 0x02;
+  static constexpr uint8_t STABLE = 0x03;
+  static constexpr uint8_t COOLING = 0x04;
+  static constexpr uint8_t VENTILATION = 0x06;
+
+  static constexpr float PUMP_MIN_HZ = 1.6f;  // level 1
+  static constexpr float PUMP_MAX_HZ = 5.5f;  // level 10
+  static constexpr float MAX_STEP_S = 1.0f;   // Euler sub-step
+
+  void configure(const SimConfig &config) {
+    config_ = config;
+    cabin_c_ = sensor_c_ = exchanger_c_ = config.initial_c;
+  }
+
+  // Controller request: byte 8 power level, byte 9 requested state (0x06 start, 0x05 off, 0x14 fan only)
+  void apply_controller_frame(const FrameView &frame) {
+    if (frame.size < CONTROLLER_FRAME_SIZE)
+      return;
+    power_level_ = frame[8] < 1 ? 1 : (frame[8] > 10 ? 10 : frame[8]);
+    uint8_t request = frame[9];
+    if (request == 0x06 && state_ == OFF) {
+      this->enter_(PREHEAT);
+      metrics_.starts++;
+    } else if (request == 0x05 && (state_ == PREHEAT || state_ == HEATING_UP || state_ == STABLE)) {
+      this->enter_(COOLING);
+    } else if (request == 0x05 && state_ == VENTILATION) {
+      this->enter_(OFF);
+    } else if (request == 0x14 && state_ == OFF) {
+      this->enter_(VENTILATION);
+    }
+  }
+
+  void step(float dt_s, float target_c) {
+    if (target_c != target_c_) {
+      target_c_ = target_c;
+      metrics_ = SimMetrics{0.0f, 0.0f, NAN, metrics_.fuel_ml, metrics_.starts, false};
+    }
+    while (dt_s > 0.0f) {
+      float h = dt_s < MAX_STEP_S ? dt_s : MAX_STEP_S;
+      this->substep_(h);
+      dt_s -= h;
+    }
+  }
+
+  // 57-byte status frame for the current state
+  void build_status_frame(uint8_t *out) const {
+    for (size_t i = 0; i < HeaterLayout0x34::SIZE; i++)
+      out[i] = 0;
+    out[0] = FRAME_START;
+    out[1] = HeaterLayout0x34::DEVICE_ID;
+    out[2] = 0x02;
+    out[3] = HeaterLayout0x34::LENGTH_BYTE;
+    put_(out, StatusField::STATE, state_);
+    put_(out, StatusField::POWER_LEVEL, power_level_);
+    put_(out, StatusField::INPUT_VOLTAGE, state_ == PREHEAT ? 124 : 128);
+    put_(out, StatusField::GLOW_CURRENT, state_ == PREHEAT ? 850 : 0);
+    put_(out, StatusField::COOLING, state_ == COOLING ? 1 : 0);
+    put_(out, StatusField::HEAT_EXCHANGER_TEMPERATURE, static_cast<int32_t>(std::lround(exchanger_c_ * 10.0f)));
+    put_(out, StatusField::STATE_DURATION, static_cast<int32_t>(state_s_));
+    put_(out, StatusField::PUMP_FREQUENCY, static_cast<int32_t>(std::lround(pump_hz_ * 10.0f)));
+    put_(out, StatusField::FAN_SPEED, fan_rpm_);
+    out[HeaterLayout0x34::SIZE - 1] = calculate_checksum(FrameView{out, HeaterLayout0x34::SIZE});
+  }
+
+  float cabin_temperature() const { return cabin_c_; }
+  float sensor_temperature() const { return sensor_c_; }
+  uint8_t state() const { return state_; }
+  const SimMetrics &metrics() const { return metrics_; }
+  const SimConfig &config() const { return config_; }
+
+ protected:
+  static void put_(uint8_t *out, StatusField field, int32_t raw) {
+    const StatusFieldSpec &spec = HeaterLayout0x34::FIELDS[static_cast<size_t>(field)];
+    if (spec.width == 1) {
+      out[spec.offset] = static_cast<uint8_t>(raw);
+    } else {
+      out[spec.offset] = static_cast<uint8_t>(raw >> 8);
+      out[spec.offset + 1] = static_cast<uint8_t>(raw);
+    }
+  }
+
+  void enter_(uint8_t state) {
+    state_ = state;
+    state_s_ = 0.0f;
+  }
+
+  float level_pump_hz_() const { return PUMP_MIN_HZ + (PUMP_MAX_HZ - PUMP_MIN_HZ) * (power_level_ - 1) / 9.0f; }
+
+  void substep_(float h) {
+    state_s_ += h;
+    float heat_w = 0.0f;
+    switch (state_) {
+      case PREHEAT:
+        pump_hz_ = 0.0f;
+        fan_rpm_ = 1200;
+        if (state_s_ >= config_.preheat_s)
+          this->enter_(HEATING_UP);
+        break;
+      case HEATING_UP: {
+        float ramp = state_s_ / config_.heating_up_s;
+        pump_hz_ = PUMP_MIN_HZ + (this->level_pump_hz_() - PUMP_MIN_HZ) * (ramp < 1.0f ? ramp : 1.0f);
+        fan_rpm_ = 1800 + static_cast<uint16_t>(2000.0f * ramp);
+        heat_w = ramp * pump_hz_ / PUMP_MAX_HZ * config_.heater_power_w;
+        if (state_s_ >= config_.heating_up_s)
+          this->enter_(STABLE);
+        break;
+      }
+      case STABLE:
+        pump_hz_ = this->level_pump_hz_();
+        fan_rpm_ = 1800 + static_cast<uint16_t>(300 * power_level_);
+        heat_w = pump_hz_ / PUMP_MAX_HZ * config_.heater_power_w;
+        break;
+      case COOLING:
+        pump_hz_ = 0.0f;
+        fan_rpm_ = 4000;
+        // Residual heat blown out of the exchanger
+        heat_w = config_.heater_power_w * 0.2f * std::exp(-state_s_ / 30.0f);
+        if (state_s_ >= config_.cooling_s)
+          this->enter_(OFF);
+        break;
+      case VENTILATION:
+        pump_hz_ = 0.0f;
+        fan_rpm_ = 1800 + static_cast<uint16_t>(300 * power_level_);
+        break;
+      default:
+        pump_hz_ = 0.0f;
+        fan_rpm_ = 0;
+        break;
+    }
+
+    metrics_.fuel_ml += pump_hz_ * h * config_.ml_per_pulse;
+    cabin_c_ += h * (heat_w - config_.heat_loss_w_per_k * (cabin_c_ - config_.ambient_c)) / config_.thermal_mass_j_per_k;
+    sensor_c_ += (cabin_c_ - sensor_c_) * (h / (config_.sensor_lag_s + h));
+    float exchanger_target = cabin_c_ + 180.0f * heat_w / config_.heater_power_w;
+    exchanger_c_ += (exchanger_target - exchanger_c_) * (h / (20.0f + h));
+    this->update_metrics_(h);
+  }
+
+  void update_metrics_(float h) {
+    metrics_.elapsed_s += h;
+    if (std::isnan(target_c_))
+      return;
+    if (!metrics_.target_reached && sensor_c_ >= target_c_)
+      metrics_.target_reached = true;
+    if (metrics_.target_reached && sensor_c_ - target_c_ > metrics_.overshoot_c)
+      metrics_.overshoot_c = sensor_c_ - target_c_;
+    bool inside = std::fabs(sensor_c_ - target_c_) <= config_.settle_band_c;
+    if (!inside) {
+      metrics_.settled_at_s = NAN;
+    } else if (std::isnan(metrics_.settled_at_s)) {
+      metrics_.settled_at_s = metrics_.elapsed_s;
+    }
+  }
+
+  SimConfig config_;
+  SimMetrics metrics_;
+  float target_c_{NAN};
+  float cabin_c_{5.0f};
+  float sensor_c_{5.0f};
+  float exchanger_c_{5.0f};
+  uint8_t state_{OFF};
+  float state_s_{0.0f};
+  uint8_t power_level_{1};
+  float pump_hz_{0.0f};
+  uint16_t fan_rpm_{0};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
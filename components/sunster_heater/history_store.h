@@ -0,0 +1,176 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace esphome {
+namespace sunster_heater {
+
+// One hour or one day of usage. 16 bytes; an index of 0 marks an empty bucket.
+struct HistoryBucket {
+  uint32_t index;           // hours or days since the epoch (UTC)
+  uint32_t fuel_dl;         // fuel in 0.1 ml
+  uint16_t burner_min;      // minutes in HEATING_UP / STABLE_COMBUSTION
+  uint16_t level_min;       // sum of power level (1-10) per burner minute; mean = level_min / burner_min
+  uint16_t min_voltage_cv;  // lowest reported supply voltage in 0.01 V, 0 = none
+  uint8_t starts;
+  uint8_t reserved;
+
+  float fuel_ml() const { return fuel_dl / 10.0f; }
+  float mean_power_percent() const { return burner_min > 0 ? level_min * 10.0f / burner_min : 0.0f; }
+  float min_voltage() const { return min_voltage_cv / 100.0f; }
+};
+
+// Preference chunk: buckets are persisted in groups so each save stays small
+static constexpr size_t HISTORY_CHUNK = 8;
+struct HistoryChunk {
+  HistoryBucket buckets[HISTORY_CHUNK];
+};
+
+// On-device usage history: hourly buckets for the last two days and daily buckets for the
+// last 96 days. Both rings are addressed by index % size, so an hour or day without data
+// simply stays empty (its slot still holds an older index). The open hour accumulates in RAM
+// with full resolution and is folded into its hourly slot and the daily bucket on rollover;
+// only the chunks touched by a rollover need saving.
+class HistoryStore {
+ public:
+  static constexpr size_t HOURS = 48;
+  static constexpr size_t DAYS = 96;
+  static constexpr size_t HOUR_CHUNKS = HOURS / HISTORY_CHUNK;
+  static constexpr size_t DAY_CHUNKS = DAYS / HISTORY_CHUNK;
+
+  // Accumulation for the open hour
+  void add_fuel(uint64_t milli_pulses) { open_.fuel_mp += milli_pulses; }
+  void add_burn(uint32_t dt_ms, uint8_t level) {
+    open_.burner_ms += dt_ms;
+    open_.level_ms += static_cast<uint64_t>(dt_ms) * level;
+  }
+  void add_start() { open_.starts++; }
+  void add_voltage(float voltage) {
+    uint16_t cv = static_cast<uint16_t>(voltage * 100.0f + 0.5f);
+    if (cv > 0 && (open_.min_voltage_cv == 0 || cv < open_.min_voltage_cv))
+      open_.min_voltage_cv = cv;
+  }
+
+  // Closes the open hour once hour_index moves on. Returns true when buckets changed; the
+  // chunks to persist are then hour_chunk_dirty() / day_chunk_dirty(). hour_index 0 = clock unknown.
+  bool roll(uint32_t hour_index, float ml_per_pulse) {
+    if (hour_index == 0)
+      return false;
+    if (open_hour_ == 0) {
+      open_hour_ = hour_index;  // data collected before the clock was known goes to this hour
+      return false;
+    }
+    if (hour_index == open_hour_)
+      return false;
+    this->close_(ml_per_pulse);
+    open_hour_ = hour_index;
+    return true;
+  }
+
+  // Current open hour as a bucket (not yet in the ring)
+  HistoryBucket open_bucket(float ml_per_pulse) const {
+    HistoryBucket bucket{};
+    this->fill_(bucket, open_hour_, ml_per_pulse);
+    return bucket;
+  }
+
+  // Day as far as recorded, including the open hour when it belongs to that day
+  HistoryBucket day_view(uint32_t day_index, float ml_per_pulse) const {
+    HistoryBucket day{day_index, 0, 0, 0, 0, 0, 0};
+    const HistoryBucket *stored = this->day(day_index);
+    if (stored != nullptr)
+      day = *stored;
+    if (open_hour_ != 0 && open_hour_ / 24 == day_index)
+      merge_(day, this->open_bucket(ml_per_pulse));
+    return day;
+  }
+
+  // Bucket for hour/day index, nullptr if the ring holds no data for it
+  const HistoryBucket *hour(uint32_t index) const { return find_(hours_, HOURS, index); }
+  const HistoryBucket *day(uint32_t index) const { return find_(days_, DAYS, index); }
+  uint32_t open_hour() const { return open_hour_; }
+
+  HistoryChunk *hour_chunk(size_t chunk) { return reinterpret_cast<HistoryChunk *>(&hours_[chunk * HISTORY_CHUNK]); }
+  HistoryChunk *day_chunk(size_t chunk) { return reinterpret_cast<HistoryChunk *>(&days_[chunk * HISTORY_CHUNK]); }
+  size_t hour_chunk_dirty() const { return dirty_hour_chunk_; }
+  size_t day_chunk_dirty() const { return dirty_day_chunk_; }
+
+  // Last day index format_day() renders (9999-12-31); a uint32_t epoch ends in 2106
+  static constexpr uint32_t MAX_DAY = 2932896;
+
+  // "YYYY-MM-DD" for a day index (civil from days, proleptic Gregorian), clamped to MAX_DAY.
+  // The field clamps never trigger; they let the compiler see the 10-character bound.
+  static void format_day(uint32_t day, char *buf, size_t size) {
+    if (day > MAX_DAY) day = MAX_DAY;
+    uint32_t z = day + 719468;
+    uint32_t era = z / 146097;
+    uint32_t doe = z - era * 146097;
+    uint32_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    uint32_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    uint32_t mp = (5 * doy + 2) / 153;
+    uint32_t d = doy - (153 * mp + 2) / 5 + 1;
+    uint32_t m = mp < 10 ? mp + 3 : mp - 9;
+    uint32_t y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+    snprintf(buf, size, "%04u-%02u-%02u", (unsigned) (y > 9999 ? 9999 : y), (unsigned) (m > 12 ? 12 : m),
+             (unsigned) (d > 31 ? 31 : d));
+  }
+
+ protected:
+  struct OpenHour {
+    uint64_t fuel_mp{0};
+    uint32_t burner_ms{0};
+    uint64_t level_ms{0};
+    uint16_t min_voltage_cv{0};
+    uint8_t starts{0};
+  };
+
+  static const HistoryBucket *find_(const HistoryBucket *ring, size_t size, uint32_t index) {
+    const HistoryBucket &bucket = ring[index % size];
+    return bucket.index == index && index != 0 ? &bucket : nullptr;
+  }
+
+  void fill_(HistoryBucket &bucket, uint32_t index, float ml_per_pulse) const {
+    bucket.index = index;
+    bucket.fuel_dl = static_cast<uint32_t>(open_.fuel_mp / 1000.0 * ml_per_pulse * 10.0 + 0.5);
+    bucket.burner_min = static_cast<uint16_t>((open_.burner_ms + 30000u) / 60000u);
+    bucket.level_min = static_cast<uint16_t>((open_.level_ms + 30000u) / 60000u);
+    bucket.min_voltage_cv = open_.min_voltage_cv;
+    bucket.starts = open_.starts;
+  }
+
+  static void merge_(HistoryBucket &day, const HistoryBucket &hour) {
+    day.fuel_dl += hour.fuel_dl;
+    day.burner_min += hour.burner_min;
+    day.level_min += hour.level_min;
+    day.starts = static_cast<uint8_t>(day.starts + hour.starts > 255 ? 255 : day.starts + hour.starts);
+    if (hour.min_voltage_cv != 0 && (day.min_voltage_cv == 0 || hour.min_voltage_cv < day.min_voltage_cv))
+      day.min_voltage_cv = hour.min_voltage_cv;
+  }
+
+  void close_(float ml_per_pulse) {
+    HistoryBucket &hour = hours_[open_hour_ % HOURS];
+    this->fill_(hour, open_hour_, ml_per_pulse);
+
+    uint32_t day_index = open_hour_ / 24;
+    HistoryBucket &day = days_[day_index % DAYS];
+    if (day.index != day_index)
+      day = HistoryBucket{day_index, 0, 0, 0, 0, 0, 0};
+    merge_(day, hour);
+
+    dirty_hour_chunk_ = (open_hour_ % HOURS) / HISTORY_CHUNK;
+    dirty_day_chunk_ = (day_index % DAYS) / HISTORY_CHUNK;
+    open_ = OpenHour{};
+  }
+
+  HistoryBucket hours_[HOURS]{};
+  HistoryBucket days_[DAYS]{};
+  OpenHour open_;
+  uint32_t open_hour_{0};
+  size_t dirty_hour_chunk_{0};
+  size_t dirty_day_chunk_{0};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
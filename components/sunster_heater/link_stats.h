@@ -0,0 +1,119 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Link-layer statistics exposed as optional diagnostic sensors (index into SunsterHeater::link_stat_sensors_)
+enum class LinkStat : uint8_t {
+  TX_FRAMES = 0,
+  RX_FRAMES,
+  CHECKSUM_FAILURES,
+  ECHO_FRAMES,
+  RESYNCS,
+  OVERSIZE_RESETS,
+  PARTIAL_TIMEOUTS,
+  COMM_TIMEOUTS,
+  RTT_MIN,
+  RTT_AVG,
+  RTT_P95,
+  COUNT,
+};
+static const uint8_t LINK_STAT_COUNT = static_cast<uint8_t>(LinkStat::COUNT);
+
+// Labels for dump_config, indexed by LinkStat
+static const char *const LINK_STAT_NAMES[LINK_STAT_COUNT] = {
+    "Link TX Frames",
+    "Link RX Frames",
+    "Link Checksum Failures",
+    "Link Echo Frames",
+    "Link Resyncs",
+    "Link Oversize Resets",
+    "Link Partial Timeouts",
+    "Link Comm Timeouts",
+    "Link RTT Min",
+    "Link RTT Avg",
+    "Link RTT P95",
+};
+
+// TX->RX round-trip histogram with fixed 10 ms buckets; the last bucket collects overflow.
+// Percentiles are resolved to the bucket's upper edge (capped at the observed maximum).
+class RttHistogram {
+ public:
+  static constexpr uint32_t BUCKET_MS = 10;
+  static constexpr size_t BUCKETS = 64;  // 0..640 ms
+
+  void add(uint32_t rtt_ms) {
+    size_t bucket = rtt_ms / BUCKET_MS;
+    if (bucket >= BUCKETS)
+      bucket = BUCKETS - 1;
+    buckets_[bucket]++;
+    if (count_ == 0 || rtt_ms < min_)
+      min_ = rtt_ms;
+    if (rtt_ms > max_)
+      max_ = rtt_ms;
+    sum_ += rtt_ms;
+    count_++;
+  }
+
+  uint32_t percentile(uint8_t pct) const {
+    if (count_ == 0)
+      return 0;
+    uint64_t rank = (static_cast<uint64_t>(count_) * pct + 99) / 100;
+    uint32_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++) {
+      seen += buckets_[i];
+      if (seen >= rank) {
+        uint32_t upper = (i + 1) * BUCKET_MS;
+        return upper < max_ ? upper : max_;
+      }
+    }
+    return max_;
+  }
+
+  uint32_t count() const { return count_; }
+  uint32_t min() const { return min_; }
+  uint32_t max() const { return max_; }
+  float avg() const { return count_ > 0 ? static_cast<float>(sum_) / count_ : 0.0f; }
+
+ protected:
+  uint32_t buckets_[BUCKETS]{};
+  uint32_t count_{0};
+  uint32_t min_{0};
+  uint32_t max_{0};
+  uint64_t sum_{0};
+};
+
+struct LinkStats {
+  uint32_t tx_frames{0};
+  uint32_t rx_frames{0};          // valid heater frames
+  uint32_t checksum_failures{0};  // counted in lenient mode too
+  uint32_t echo_frames{0};        // own controller frames read back from the bus
+  uint32_t resyncs{0};
+  uint32_t oversize_resets{0};
+  uint32_t partial_timeouts{0};   // incomplete frame dropped after 100 ms silence
+  uint32_t comm_timeouts{0};      // transitions into "heater not responding"
+  RttHistogram rtt;
+
+  float value(LinkStat stat) const {
+    switch (stat) {
+      case LinkStat::TX_FRAMES: return tx_frames;
+      case LinkStat::RX_FRAMES: return rx_frames;
+      case LinkStat::CHECKSUM_FAILURES: return checksum_failures;
+      case LinkStat::ECHO_FRAMES: return echo_frames;
+      case LinkStat::RESYNCS: return resyncs;
+      case LinkStat::OVERSIZE_RESETS: return oversize_resets;
+      case LinkStat::PARTIAL_TIMEOUTS: return partial_timeouts;
+      case LinkStat::COMM_TIMEOUTS: return comm_timeouts;
+      case LinkStat::RTT_MIN: return rtt.min();
+      case LinkStat::RTT_AVG: return rtt.avg();
+      case LinkStat::RTT_P95: return rtt.percentile(95);
+      default: return 0.0f;
+    }
+  }
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Everything the component persists, in commit order (the fuel base before the journal, so a
+// base written in the same commit already covers the pending delta)
+enum class PersistRecord : uint8_t {
+  FUEL_BASE = 0,
+  FUEL_JOURNAL,
+  CONFIG,
+  TANK,
+  PUMP_CALIBRATION,
+  HISTORY,
+  COUNT,
+};
+static const uint8_t PERSIST_RECORD_COUNT = static_cast<uint8_t>(PersistRecord::COUNT);
+
+inline const char *persist_record_to_string(PersistRecord record) {
+  switch (record) {
+    case PersistRecord::FUEL_BASE: return "fuel base";
+    case PersistRecord::FUEL_JOURNAL: return "fuel journal";
+    case PersistRecord::CONFIG: return "config";
+    case PersistRecord::TANK: return "tank";
+    case PersistRecord::PUMP_CALIBRATION: return "pump calibration";
+    case PersistRecord::HISTORY: return "history";
+    default: return "?";
+  }
+}
+
+// Write scheduling for all persisted records.
+//
+// Callers only mark records dirty (with an optional hold time, e.g. a debounce for slider
+// changes). Once any record is due, the component writes every dirty record and commits them
+// to flash in one go, at a moment it picks outside the control step and the TX/RX exchange.
+// A steep supply voltage drop towards min_voltage_operate requests an immediate flush, so the
+// counters are on flash before the battery is gone.
+class PersistenceService {
+ public:
+  static constexpr float BROWNOUT_MARGIN_V = 1.0f;    // watch below min_voltage_operate + this
+  static constexpr float BROWNOUT_RATE_V_S = 0.5f;    // falling at least this fast
+  static constexpr float BROWNOUT_CRITICAL_V = 0.3f;  // or this close to the limit at any rate
+  static constexpr float BROWNOUT_REARM_V = 0.5f;     // hysteresis above the margin
+
+  // restart: a pending deadline is pushed out (debounce); otherwise the earliest one holds
+  void mark(PersistRecord record, uint32_t now_ms, uint32_t hold_ms = 0, bool restart = false) {
+    uint8_t i = static_cast<uint8_t>(record);
+    uint32_t due = now_ms + hold_ms;
+    if (!(dirty_ & (1u << i)) || restart || static_cast<int32_t>(due - due_ms_[i]) < 0)
+      due_ms_[i] = due;
+    dirty_ |= 1u << i;
+  }
+  bool is_dirty(PersistRecord record) const { return dirty_ & (1u << static_cast<uint8_t>(record)); }
+  bool any_dirty() const { return dirty_ != 0; }
+  bool any_due(uint32_t now_ms) const {
+    for (uint8_t i = 0; i < PERSIST_RECORD_COUNT; i++) {
+      if ((dirty_ & (1u << i)) && static_cast<int32_t>(now_ms - due_ms_[i]) >= 0)
+        return true;
+    }
+    return false;
+  }
+  void clear(PersistRecord record) { dirty_ &= ~(1u << static_cast<uint8_t>(record)); }
+
+  void committed(uint8_t records, uint32_t duration_us) {
+    commits_++;
+    records_ += records;
+    last_commit_us_ = duration_us;
+    if (duration_us > max_commit_us_)
+      max_commit_us_ = duration_us;
+  }
+
+  // Per voltage reading; true once per brownout (re-armed after recovery)
+  bool check_brownout(uint32_t now_ms, float voltage, float min_voltage) {
+    if (!(voltage > 0.0f) || !(min_voltage > 0.0f))
+      return false;
+    float rate = 0.0f;  // V/s, positive when falling
+    if (last_voltage_ms_ != 0 && now_ms != last_voltage_ms_)
+      rate = (last_voltage_ - voltage) * 1000.0f / (now_ms - last_voltage_ms_);
+    last_voltage_ = voltage;
+    last_voltage_ms_ = now_ms;
+
+    if (voltage > min_voltage + BROWNOUT_MARGIN_V + BROWNOUT_REARM_V) {
+      armed_ = true;
+      return false;
+    }
+    if (armed_ && voltage < min_voltage + BROWNOUT_MARGIN_V &&
+        (rate >= BROWNOUT_RATE_V_S || voltage < min_voltage + BROWNOUT_CRITICAL_V)) {
+      armed_ = false;
+      brownout_flushes_++;
+      return true;
+    }
+    return false;
+  }
+
+  uint32_t commits() const { return commits_; }
+  uint32_t records() const { return records_; }
+  uint32_t last_commit_us() const { return last_commit_us_; }
+  uint32_t max_commit_us() const { return max_commit_us_; }
+  uint32_t brownout_flushes() const { return brownout_flushes_; }
+
+ protected:
+  uint32_t dirty_{0};
+  uint32_t due_ms_[PERSIST_RECORD_COUNT]{};
+
+  uint32_t commits_{0};
+  uint32_t records_{0};
+  uint32_t last_commit_us_{0};
+  uint32_t max_commit_us_{0};
+
+  float last_voltage_{0.0f};
+  uint32_t last_voltage_ms_{0};
+  bool armed_{true};
+  uint32_t brownout_flushes_{0};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
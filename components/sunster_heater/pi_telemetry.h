@@ -0,0 +1,107 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Outcome of one automatic-mode control step
+enum class PiDecision : uint8_t {
+  HOLD = 0,       // no change (between thresholds while off, or not yet in stable combustion)
+  TURN_ON,
+  TURN_OFF,
+  SET_LEVEL,      // power level from PI output
+  MIN_LEVEL,      // held at 10% (between thresholds, min on-time, auto-stop disabled)
+  WARMUP,         // slope warmup at 10%, no PI output
+  PREHEAT,        // heater starting, fixed 10%
+  COOLDOWN,       // heater stopping, output 0
+  INACTIVE,       // power switch off, sensor invalid or grace period expired
+  ECONOMY,        // ECONOMY mode: level from the learned cheapest pair inside the band
+  IDLE,           // held at 10% instead of stopping: predicted off period cheaper than a cycle
+};
+
+inline const char *pi_decision_to_string(PiDecision decision) {
+  switch (decision) {
+    case PiDecision::HOLD: return "hold";
+    case PiDecision::TURN_ON: return "on";
+    case PiDecision::TURN_OFF: return "off";
+    case PiDecision::SET_LEVEL: return "level";
+    case PiDecision::MIN_LEVEL: return "min";
+    case PiDecision::WARMUP: return "warmup";
+    case PiDecision::PREHEAT: return "preheat";
+    case PiDecision::COOLDOWN: return "cooldown";
+    case PiDecision::INACTIVE: return "inactive";
+    case PiDecision::ECONOMY: return "eco";
+    case PiDecision::IDLE: return "idle";
+    default: return "?";
+  }
+}
+
+// One control step. Terms that were not computed for the decision are NaN.
+struct PiStepRecord {
+  uint32_t time_ms;
+  float dt_s;
+  float target;
+  float measured;
+  float t_pred;
+  float slope;         // °C/s
+  float error;         // target - t_pred
+  float p_term;        // Kp * error
+  float i_term;        // integrator after the anti-windup update
+  float output;        // PI output [-100, 100] %
+  PiDecision decision;
+  uint8_t power_percent;  // requested power after the step
+  uint8_t heater_state;   // HeaterState
+  bool enabled;
+  uint32_t sample_age_ms;  // age of the held sensor sample at this step
+  uint32_t jitter_ms;      // lateness against the control schedule
+};
+
+// Ring of PiStepRecords addressed by a running sequence number, so an export can walk a
+// stable range while new steps keep arriving (evicted records are skipped). The size is set
+// once from the config; without storage push() hands out a scratch record and nothing is kept.
+class PiTelemetryRing {
+ public:
+  // Allocates the ring once; returns false (recording disabled) if the allocation fails
+  bool allocate(size_t capacity) {
+    records_.reset(new (std::nothrow) PiStepRecord[capacity]());
+    capacity_ = records_ ? capacity : 0;
+    next_seq_ = 0;
+    return capacity_ > 0;
+  }
+
+  PiStepRecord &push() {
+    if (capacity_ == 0) {
+      scratch_ = PiStepRecord{};
+      return scratch_;
+    }
+    PiStepRecord &rec = records_[next_seq_ % capacity_];
+    rec = PiStepRecord{};
+    next_seq_++;
+    return rec;
+  }
+
+  // Oldest sequence number still held
+  uint32_t first_seq() const { return next_seq_ > capacity_ ? next_seq_ - capacity_ : 0; }
+  uint32_t next_seq() const { return next_seq_; }
+  size_t size() const { return next_seq_ - this->first_seq(); }
+  size_t capacity() const { return capacity_; }
+
+  const PiStepRecord *get(uint32_t seq) const {
+    if (seq < this->first_seq() || seq >= next_seq_)
+      return nullptr;
+    return &records_[seq % capacity_];
+  }
+
+ protected:
+  std::unique_ptr<PiStepRecord[]> records_;
+  size_t capacity_{0};
+  uint32_t next_seq_{0};
+  PiStepRecord scratch_{};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Telemetry entities that go through a PublishFilter (index into SunsterHeater::publish_filters_)
+enum class TelemetryChannel : uint8_t {
+  STATE = 0,
+  POWER_LEVEL,
+  INPUT_VOLTAGE,
+  GLOW_PLUG_STATUS,
+  COOLING_DOWN,
+  HEAT_EXCHANGER_TEMPERATURE,
+  STATE_DURATION,
+  PUMP_FREQUENCY,
+  FAN_SPEED,
+  HOURLY_CONSUMPTION,
+  DAILY_CONSUMPTION,
+  TOTAL_CONSUMPTION,
+  TANK_REMAINING,
+  TANK_RUNTIME,
+  TANK_RUNTIME_AVERAGE,
+  PI_OUTPUT,
+  PREDICTED_TEMPERATURE,
+  SLOPE,
+  LOW_VOLTAGE_ERROR,
+  COUNT,
+};
+static const uint8_t TELEMETRY_CHANNEL_COUNT = static_cast<uint8_t>(TelemetryChannel::COUNT);
+
+// Publish-on-change with deadband, minimum interval and forced heartbeat.
+// A value is published when it moved by more than max(deadband, deadband_percent of the
+// last published value) and min_interval has passed, or when heartbeat has elapsed.
+class PublishFilter {
+ public:
+  void configure(float deadband, float deadband_percent, uint32_t min_interval_ms, uint32_t heartbeat_ms) {
+    deadband_ = deadband;
+    deadband_percent_ = deadband_percent;
+    min_interval_ms_ = min_interval_ms;
+    heartbeat_ms_ = heartbeat_ms;
+  }
+
+  bool should_publish(float value, uint32_t now) const {
+    if (!published_)
+      return true;
+    if (std::isnan(value) != std::isnan(last_value_))
+      return this->interval_elapsed_(now);
+    float threshold = std::fmax(deadband_, std::fabs(last_value_) * deadband_percent_ / 100.0f);
+    float delta = std::fabs(value - last_value_);
+    bool changed = (threshold > 0.0f) ? (delta >= threshold) : (delta > 0.0f);
+    return this->should_publish(changed, now);
+  }
+
+  // For text/binary entities: caller decides whether the value changed
+  bool should_publish(bool changed, uint32_t now) const {
+    if (!published_)
+      return true;
+    if (heartbeat_ms_ > 0 && now - last_publish_ >= heartbeat_ms_)
+      return true;
+    return changed && this->interval_elapsed_(now);
+  }
+
+  void mark_published(float value, uint32_t now) {
+    published_ = true;
+    last_value_ = value;
+    last_publish_ = now;
+  }
+
+  float get_deadband() const { return deadband_; }
+  float get_deadband_percent() const { return deadband_percent_; }
+  uint32_t get_min_interval() const { return min_interval_ms_; }
+  uint32_t get_heartbeat() const { return heartbeat_ms_; }
+
+ protected:
+  bool interval_elapsed_(uint32_t now) const { return now - last_publish_ >= min_interval_ms_; }
+
+  float deadband_{0.0f};
+  float deadband_percent_{0.0f};
+  uint32_t min_interval_ms_{0};
+  uint32_t heartbeat_ms_{60000};
+  bool published_{false};
+  float last_value_{NAN};
+  uint32_t last_publish_{0};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Persisted calibration: dose factor per power level and the running session
+struct PumpCalibrationData {
+  uint16_t level_permille[10];        // dose at level n = injected_per_pulse x level_permille[n-1] / 1000
+  uint8_t active;                     // a session is running (marked, not yet applied)
+  uint8_t reserved[3];
+  uint64_t session_milli_pulses[10];  // raw pump milli-pulses per level since the mark
+};
+
+enum class CalibrationResult : uint8_t {
+  BASE = 0,        // injected_per_pulse updated
+  LEVEL,           // one level's dose factor updated
+  NOT_ACTIVE,      // no session marked
+  TOO_FEW_PULSES,  // not enough fuel since the mark for a useful result
+  OUT_OF_RANGE,    // result implausible, nothing changed
+};
+
+// Pump dose calibration from a measured amount of fuel.
+//
+// A session starts at a mark and counts raw pump milli-pulses per reported power level. When
+// the fuel actually used (e.g. the refill volume) is entered, the dose follows from
+//   measured = injected_per_pulse x sum(pulses[n] x factor[n])
+// A session spent (almost) entirely at one level calibrates that level's factor when per-level
+// calibration is enabled; otherwise injected_per_pulse is solved for. The fuel counters store
+// pulses already scaled by the level factor, so ml = counter x injected_per_pulse everywhere.
+class PumpCalibration {
+ public:
+  static constexpr size_t LEVELS = 10;
+  static constexpr uint16_t UNITY = 1000;
+  static constexpr uint64_t MIN_MILLI_PULSES = 100000;  // 100 pulses, about 2 ml
+  static constexpr float SINGLE_LEVEL_SHARE = 0.9f;
+  static constexpr float MIN_FACTOR = 0.25f;
+  static constexpr float MAX_FACTOR = 4.0f;
+
+  PumpCalibration() { this->reset_levels(); }
+
+  void load(const PumpCalibrationData &data) {
+    data_ = data;
+    for (size_t i = 0; i < LEVELS; i++) {
+      float factor = data_.level_permille[i] / static_cast<float>(UNITY);
+      if (factor < MIN_FACTOR || factor > MAX_FACTOR)
+        data_.level_permille[i] = UNITY;  // never written or corrupt
+    }
+  }
+  const PumpCalibrationData &data() const { return data_; }
+
+  void reset_levels() {
+    for (size_t i = 0; i < LEVELS; i++)
+      data_.level_permille[i] = UNITY;
+  }
+
+  // Dose factor for a reported power level (1-10); other values use 1
+  float factor(uint8_t level) const {
+    return level >= 1 && level <= LEVELS ? data_.level_permille[level - 1] / static_cast<float>(UNITY) : 1.0f;
+  }
+
+  // Raw pump milli-pulses -> counter milli-pulses at the level's dose. The rounding remainder is
+  // carried per level, so a fraction left at one factor is never scaled by another.
+  uint64_t scale(uint64_t raw_milli_pulses, uint8_t level) {
+    if (level < 1 || level > LEVELS || data_.level_permille[level - 1] == UNITY)
+      return raw_milli_pulses;
+    uint64_t scaled = raw_milli_pulses * data_.level_permille[level - 1] + remainders_[level - 1];
+    remainders_[level - 1] = static_cast<uint16_t>(scaled % UNITY);
+    return scaled / UNITY;
+  }
+
+  // Session
+  void mark() {
+    for (size_t i = 0; i < LEVELS; i++)
+      data_.session_milli_pulses[i] = 0;
+    data_.active = 1;
+  }
+  void cancel() { data_.active = 0; }
+  bool is_active() const { return data_.active != 0; }
+  void count(uint64_t raw_milli_pulses, uint8_t level) {
+    if (this->is_active() && level >= 1 && level <= LEVELS)
+      data_.session_milli_pulses[level - 1] += raw_milli_pulses;
+  }
+  uint64_t session_milli_pulses() const {
+    uint64_t sum = 0;
+    for (size_t i = 0; i < LEVELS; i++)
+      sum += data_.session_milli_pulses[i];
+    return sum;
+  }
+
+  // Ends the session with the measured fuel. Updates ml_per_pulse (BASE) or one level factor
+  // (LEVEL, reported in level); other results leave everything unchanged.
+  CalibrationResult apply(float measured_ml, bool per_level, float &ml_per_pulse, uint8_t &level) {
+    if (!this->is_active())
+      return CalibrationResult::NOT_ACTIVE;
+    uint64_t total = this->session_milli_pulses();
+    if (total < MIN_MILLI_PULSES || !(measured_ml > 0.0f) || !(ml_per_pulse > 0.0f))
+      return CalibrationResult::TOO_FEW_PULSES;
+
+    size_t dominant = 0;
+    double weighted = 0.0;  // sum(pulses x factor)
+    for (size_t i = 0; i < LEVELS; i++) {
+      if (data_.session_milli_pulses[i] > data_.session_milli_pulses[dominant])
+        dominant = i;
+      weighted += data_.session_milli_pulses[i] / 1000.0 * data_.level_permille[i] / UNITY;
+    }
+
+    if (per_level && data_.session_milli_pulses[dominant] >= total * SINGLE_LEVEL_SHARE) {
+      double own = data_.session_milli_pulses[dominant] / 1000.0;
+      double others = weighted - own * data_.level_permille[dominant] / UNITY;
+      double factor = (measured_ml / ml_per_pulse - others) / own;
+      if (factor < MIN_FACTOR || factor > MAX_FACTOR)
+        return CalibrationResult::OUT_OF_RANGE;
+      data_.level_permille[dominant] = static_cast<uint16_t>(factor * UNITY + 0.5);
+      level = static_cast<uint8_t>(dominant + 1);
+      data_.active = 0;
+      return CalibrationResult::LEVEL;
+    }
+
+    double base = measured_ml / weighted;
+    if (base < ml_per_pulse * MIN_FACTOR || base > ml_per_pulse * MAX_FACTOR)
+      return CalibrationResult::OUT_OF_RANGE;
+    ml_per_pulse = static_cast<float>(base);
+    data_.active = 0;
+    return CalibrationResult::BASE;
+  }
+
+ protected:
+  PumpCalibrationData data_{};
+  uint16_t remainders_[LEVELS]{};  // < UNITY, in 1/1000 counter milli-pulses
+};
+
+inline const char *calibration_result_to_string(CalibrationResult result) {
+  switch (result) {
+    case CalibrationResult::BASE: return "injected per pulse updated";
+    case CalibrationResult::LEVEL: return "level factor updated";
+    case CalibrationResult::NOT_ACTIVE: return "no calibration started";
+    case CalibrationResult::TOO_FEW_PULSES: return "too few pulses since the mark";
+    case CalibrationResult::OUT_OF_RANGE: return "result out of range";
+    default: return "?";
+  }
+}
+
+}  // namespace sunster_heater
+}  // namespace esphome
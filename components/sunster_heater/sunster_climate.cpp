@@ -23,6 +23,9 @@ climate::ClimateTraits SunsterClimate::traits() {
   traits.add_supported_mode(climate::CLIMATE_MODE_FAN_ONLY);
   traits.add_feature_flags(climate::CLIMATE_SUPPORTS_CURRENT_TEMPERATURE |
                            climate::CLIMATE_SUPPORTS_ACTION);
+  // ECO preset = ECONOMY control mode (PI plus the learned cheapest power levels)
+  traits.add_supported_preset(climate::CLIMATE_PRESET_NONE);
+  traits.add_supported_preset(climate::CLIMATE_PRESET_ECO);
   traits.set_visual_min_temperature(min_temperature_);
   traits.set_visual_max_temperature(max_temperature_);
   traits.set_visual_temperature_step(1.0f);
@@ -40,7 +43,8 @@ void SunsterClimate::control(const climate::ClimateCall &call) {
         heater_->turn_off();
         break;
       case climate::CLIMATE_MODE_HEAT:
-        heater_->set_control_mode(ControlMode::AUTOMATIC);
+        // Keep ECONOMY if it is already selected; HEAT otherwise means AUTOMATIC
+        if (heater_->get_control_mode() != ControlMode::ECONOMY) heater_->set_control_mode(ControlMode::AUTOMATIC);
         heater_->set_automatic_master_enabled(true);
         heater_->turn_on();
         break;
@@ -59,11 +63,22 @@ void SunsterClimate::control(const climate::ClimateCall &call) {
     }
   }
 
+  if (call.get_preset().has_value()) {
+    climate::ClimatePreset preset = *call.get_preset();
+    ControlMode cm = heater_->get_control_mode();
+    if (preset == climate::CLIMATE_PRESET_ECO && cm != ControlMode::ECONOMY) {
+      heater_->set_control_mode(ControlMode::ECONOMY);
+    } else if (preset == climate::CLIMATE_PRESET_NONE && cm == ControlMode::ECONOMY) {
+      heater_->set_control_mode(ControlMode::AUTOMATIC);
+    }
+  }
+
   // Target temperature → temperature in AUTOMATIC, power level in MANUAL
   if (call.get_target_temperature().has_value()) {
     float target = *call.get_target_temperature();
     ControlMode cm = heater_->get_control_mode();
-    if (cm == ControlMode::AUTOMATIC || cm == ControlMode::ANTIFREEZE) {
+    if (cm == ControlMode::AUTOMATIC || cm == ControlMode::ECONOMY || cm == ControlMode::ANTIFREEZE ||
+        cm == ControlMode::AUTOTUNE) {
       heater_->set_target_temperature(target);
     } else if (cm == ControlMode::MANUAL) {
       heater_->set_power_level_percent(std::max(10.0f, std::min(100.0f, target)));
@@ -87,8 +102,10 @@ void SunsterClimate::update() {
   bool heater_on = heater_->get_heater_enabled();
   bool is_heating = heater_->is_heating();
 
+  this->preset = cmode == ControlMode::ECONOMY ? climate::CLIMATE_PRESET_ECO : climate::CLIMATE_PRESET_NONE;
   switch (cmode) {
     case ControlMode::AUTOMATIC:
+    case ControlMode::ECONOMY:
       this->target_temperature = heater_->get_target_temperature();
       if (heater_->is_automatic_master_enabled()) {
         this->mode = climate::CLIMATE_MODE_HEAT;
@@ -113,6 +130,7 @@ void SunsterClimate::update() {
       break;
 
     case ControlMode::ANTIFREEZE:
+    case ControlMode::AUTOTUNE:  // step experiment, shown as heating towards the target
       this->target_temperature = heater_->get_target_temperature();
       this->mode = climate::CLIMATE_MODE_HEAT;
       this->action = is_heating ? climate::CLIMATE_ACTION_HEATING
@@ -9,6 +9,7 @@
 #include <ctime>
 #include <string>
 #include <cmath>
+#include <cstring>
 #include <algorithm>
 #ifndef M_PI
 #define M_PI 3.1415926535897932384626433832795
@@ -17,19 +18,6 @@
 namespace esphome {
 namespace sunster_heater {
 
-// Helper function for checksum calculation
-uint8_t calculate_checksum(const std::vector<uint8_t> &frame) {
-  if (frame.size() < 4) {
-    return 0;
-  }
-  uint32_t sum = 0;
-  // Sum all bytes from index 2 to second-to-last byte
-  for (size_t i = 2; i < frame.size() - 1; ++i) {
-    sum += frame[i];
-  }
-  return static_cast<uint8_t>(sum % 256);
-}
-
 void SunsterHeater::setup() {
   ESP_LOGCONFIG(TAG, "Setting up Sunster Heater...");
   
@@ -38,6 +26,9 @@ void SunsterHeater::setup() {
     this->mark_failed();
     return;
   }
+  if (this->parent_->get_baud_rate() > 0) {
+    this->rx_byte_us_ = 10000000 / this->parent_->get_baud_rate();  // 8N1: 10 bits per byte
+  }
   
   // Initialize state
   this->current_state_ = HeaterState::OFF;
@@ -53,54 +44,98 @@ void SunsterHeater::setup() {
   this->last_consumption_update_ = millis();
   this->current_day_ = get_days_since_epoch();
   
-  // Setup persistent storage for fuel consumption
-  this->pref_fuel_consumption_ = global_preferences->make_preference<FuelConsumptionData>(fnv1_hash("fuel_consumption"));
-  load_fuel_consumption_data();
+  if (capture_buffer_size_ > 0 && !capture_.allocate(capture_buffer_size_)) {
+    ESP_LOGW(TAG, "Could not allocate %u byte capture buffer, capture disabled", (unsigned) capture_buffer_size_);
+  }
+  if (!pi_telemetry_.allocate(pi_telemetry_size_)) {
+    ESP_LOGW(TAG, "Could not allocate %u PI step records, PI telemetry disabled", (unsigned) pi_telemetry_size_);
+  }
 
-  // Load persisted config (PI, target temp, hysteresis, injected_per_pulse)
-  this->pref_config_ = global_preferences->make_preference<HeaterConfigData>(fnv1_hash("heater_config"));
+  // Load persisted config (PI, target temp, thresholds, injected_per_pulse): one record per parameter.
+  // First: the fuel counters below are converted with the saved injected_per_pulse.
+  this->pref_config_ = global_preferences->make_preference<HeaterConfigData>(fnv1_hash("heater_config"));  // legacy
   load_config_data();
   publish_all_config_entities_();
 
+  // Setup persistent storage for fuel consumption
+  this->pref_fuel_consumption_ = global_preferences->make_preference<FuelConsumptionDataV2>(fnv1_hash("fuel_consumption_v2"));
+  this->pref_fuel_consumption_legacy_ = global_preferences->make_preference<FuelConsumptionData>(fnv1_hash("fuel_consumption"));
+  for (size_t i = 0; i < FuelJournal::SLOTS; i++) {
+    this->pref_fuel_journal_[i] = global_preferences->make_preference<FuelJournalRecord>(fnv1_hash("fuel_journal") + i);
+  }
+  load_fuel_consumption_data();
+
+  this->pref_pump_calibration_ = global_preferences->make_preference<PumpCalibrationData>(fnv1_hash("pump_calibration"));
+  PumpCalibrationData calibration;
+  if (this->pref_pump_calibration_.load(&calibration)) {
+    pump_calibration_.load(calibration);
+  }
+
+  this->pref_tank_ = global_preferences->make_preference<TankData>(fnv1_hash("fuel_tank"));
+  TankData tank;
+  if (this->pref_tank_.load(&tank)) {
+    tank_.load(tank);
+  }
+
+  // Usage history: one preference per chunk of buckets, saved when an hour closes
+  for (size_t i = 0; i < HistoryStore::HOUR_CHUNKS; i++) {
+    this->pref_history_hours_[i] = global_preferences->make_preference<HistoryChunk>(fnv1_hash("history_hours") + i);
+    this->pref_history_hours_[i].load(history_.hour_chunk(i));
+  }
+  for (size_t i = 0; i < HistoryStore::DAY_CHUNKS; i++) {
+    this->pref_history_days_[i] = global_preferences->make_preference<HistoryChunk>(fnv1_hash("history_days") + i);
+    this->pref_history_days_[i].load(history_.day_chunk(i));
+  }
+  history_total_mp_ = total_fuel_mp_;
+
   // Initialize hourly consumption sensor with initial value
   if (hourly_consumption_sensor_) {
-    hourly_consumption_sensor_->publish_state(0.0f);
+    publish_filtered_(hourly_consumption_sensor_, TelemetryChannel::HOURLY_CONSUMPTION, 0.0f);
   }
   
   // Register callback for external temperature sensor to trigger PI controller only on new values
+  temperature_estimator_.configure(temperature_noise_, slope_window_s_);
   if (external_temperature_sensor_) {
     external_temperature_sensor_->add_on_state_callback([this](float state) {
+      if (capture_.is_enabled()) {
+        capture_.record_temperature(millis(), state);
+      }
       // Validate: NaN and plausibility (-50°C to +100°C)
       if (std::isnan(state) || state < -50.0f || state > 100.0f) {
         ESP_LOGW(TAG, "[PI] Invalid sensor value received: %.1f°C, skipping PI calculation", state);
         return;
       }
+      if (!temperature_estimator_.update(millis(), state)) {
+        ESP_LOGW(TAG, "[PI] Outlier %.2f°C rejected (estimate %.2f°C)", state, temperature_estimator_.temperature());
+        return;
+      }
       
       external_temperature_ = state;
-      last_external_temperature_ = state;
+      external_sample_ms_ = millis();
       // Reset grace period timer if sensor is back online
       if (time_external_temp_lost_ != 0) {
         ESP_LOGI(TAG, "External temperature sensor recovered, resetting grace period");
         time_external_temp_lost_ = 0;
       }
-      // Trigger PI controller only if in automatic mode
-      if (control_mode_ == ControlMode::AUTOMATIC) {
-        handle_automatic_mode();
+      // The PI runs on the control scheduler from loop(); autotune identifies from the samples themselves
+      if (control_mode_ == ControlMode::AUTOTUNE) {
+        handle_autotune_();
       }
     });
-    ESP_LOGD(TAG, "Registered callback for external temperature sensor - PI will run only on new values");
+    ESP_LOGD(TAG, "Registered callback for external temperature sensor - samples are held for the control scheduler");
   }
+  next_control_ms_ = millis() + control_period_ms_;
   
   ESP_LOGCONFIG(TAG, "Sunster Heater setup completed");
   ESP_LOGCONFIG(TAG, "Control mode: %s", control_mode_ == ControlMode::AUTOMATIC ? "Automatic" : "Manual");
   ESP_LOGCONFIG(TAG, "Default power level: %.0f%%", default_power_percent_);
   ESP_LOGCONFIG(TAG, "Injected per pulse: %.2f ml", injected_per_pulse_);
-  ESP_LOGCONFIG(TAG, "Daily consumption: %.2f ml", daily_consumption_ml_);
+  ESP_LOGCONFIG(TAG, "Daily consumption: %.2f ml", get_daily_consumption());
   
   // Send initial status request immediately after boot (unless passive sniff mode)
   if (!passive_sniff_mode_) {
     send_controller_frame();
-    last_send_time_ = millis();
+    tx_scheduler_started_ = true;
     ESP_LOGD(TAG, "Initial status request sent");
   } else {
     ESP_LOGI(TAG, "Passive sniff mode: only logging RX frames and decode attempts, not sending");
@@ -108,55 +143,32 @@ void SunsterHeater::setup() {
 }
 
 void SunsterHeater::update() {
-  // Deferred config save (avoids blocking control callbacks; NVS write ~25–50 ms)
-  if (config_dirty_ && (millis() - config_last_change_ >= CONFIG_SAVE_DEBOUNCE_MS)) {
-    save_config_data();
-    config_dirty_ = false;
-  }
-
-  // Update external temperature reading if sensor is available
-  // Note: PI controller is triggered by sensor callback, not here
-  if (external_temperature_sensor_ != nullptr && external_temperature_sensor_->has_state()) {
-    float new_temp = external_temperature_sensor_->state;
-    // Track temperature change (for fallback, but callback is primary mechanism)
-    bool temp_changed = (std::isnan(last_external_temperature_) || 
-                        std::fabs(new_temp - last_external_temperature_) > 0.01f);  // 0.01°C Toleranz
-    external_temperature_ = new_temp;
-    last_external_temperature_ = new_temp;
-    
-    // Reset grace period timer if sensor is back online
-    if (time_external_temp_lost_ != 0) {
-      ESP_LOGI(TAG, "External temperature sensor recovered, resetting grace period");
-      time_external_temp_lost_ = 0;
-    }
-  } else if (external_temperature_sensor_ != nullptr && time_external_temp_lost_ == 0) {
-    // Sensor just lost signal - start grace period timer
+  // external_temperature_ only takes samples accepted by the sensor callback (range check and
+  // outlier gate); here a sensor without a valid value only starts the grace period
+  if (external_temperature_sensor_ != nullptr && time_external_temp_lost_ == 0 && !external_sensor_online_()) {
     time_external_temp_lost_ = millis();
     ESP_LOGW(TAG, "External temperature sensor lost signal, starting %ds grace period", PI_SENSOR_GRACE_PERIOD_MS / 1000);
   }
   
   // Check for daily reset
   check_daily_reset();
+  roll_history_();
   
   // Check voltage safety
   check_voltage_safety();
+  if (control_mode_ == ControlMode::AUTOTUNE) {
+    check_autotune_safety_();
+  }
   
-  // Handle automatic mode (PI controller) - only when no callback is registered
-  // (callback is registered in setup() and is the primary trigger)
-  // Fallback if callback does not fire:
-  if (control_mode_ == ControlMode::AUTOMATIC && external_temperature_sensor_ == nullptr) {
-    handle_automatic_mode();
-  } else if (pi_output_sensor_ && control_mode_ != ControlMode::AUTOMATIC) {
+  // Automatic mode (PI controller) runs from service_control_() in loop()
+  if (pi_output_sensor_ && !is_pi_mode()) {
     last_pi_output_ = 0.0f;
-    pi_output_sensor_->publish_state(0.0f);
+    publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, 0.0f);
   }
   // Handle antifreeze mode logic
   if (control_mode_ == ControlMode::ANTIFREEZE) {
     handle_antifreeze_mode();
   }
-
-  // Always check for incoming data, regardless of state
-  check_uart_data();
   
   // Determine if we should send frames
   // Send frames at different intervals based on heater state:
@@ -174,89 +186,629 @@ void SunsterHeater::update() {
     }
   }
   
-  // Send controller frame at appropriate intervals (skip in passive sniff mode)
+  // Keep-alive: send controller frame at appropriate intervals (skip in passive sniff mode).
+  // Command changes are sent right away from loop().
   if (!passive_sniff_mode_ && (now - last_send_time_ >= send_interval)) {
     send_controller_frame();
-    last_send_time_ = now;
   }
   
   // Update instantaneous hourly consumption rate (ml/h) based on current pump frequency
-  if (hourly_consumption_sensor_) {
-    // Calculate instantaneous consumption rate: Hz * ml/pulse * 3600 seconds/hour
-    float instantaneous_consumption_ml_per_hour = pump_frequency_ * injected_per_pulse_ * 3600.0f;
-    hourly_consumption_sensor_->publish_state(instantaneous_consumption_ml_per_hour);
+  // (publish filter drops the repeats while the pump frequency is steady)
+  publish_filtered_(hourly_consumption_sensor_, TelemetryChannel::HOURLY_CONSUMPTION, get_instantaneous_consumption_rate());
+  publish_tank_();
+  publish_diagnostics_();
+}
+
+void SunsterHeater::loop() {
+  // RX is drained here (bounded per iteration) so frame latency no longer depends on
+  // update_interval; control and publishing stay on the update() cadence.
+  if (simulator_ != nullptr) {
+    service_simulation_();
+  }
+  check_uart_data();
+  service_tx_();
+  service_control_();
+  service_persistence_();
+  if (capture_dumping_) {
+    service_capture_dump_();
+  }
+  if (pi_exporting_) {
+    service_pi_export_();
+  }
+  if (history_dumping_) {
+    service_history_dump_();
+  }
+  // Trace records are formatted here, one per loop and only between frames
+  if ((passive_sniff_mode_ || trace_dump_remaining_ > 0) && trace_.size() > 0 && !rx_parser_.in_frame()) {
+    drain_trace_();
   }
 }
 
-void SunsterHeater::check_uart_data() {
-  while (this->available()) {
-    uint8_t byte;
-    this->read_byte(&byte);
-    
-    // Look for frame start
-    if (!frame_sync_ && byte == FRAME_START) {
-      rx_buffer_.clear();
-      rx_buffer_.push_back(byte);
-      frame_sync_ = true;
-      ESP_LOGVV(TAG, "Frame start detected");
+void SunsterHeater::service_control_() {
+  uint32_t now = millis();
+  if (static_cast<int32_t>(now - next_control_ms_) < 0) {
+    return;
+  }
+  // Fixed rate: the next step is due one period after the nominal time of this one, so loop()
+  // latency shows up as jitter instead of drift. Periods missed entirely are skipped, not replayed.
+  uint32_t jitter = now - next_control_ms_;
+  uint32_t missed = jitter / control_period_ms_;
+  control_overruns_ += missed;
+  next_control_ms_ += (missed + 1) * control_period_ms_;
+  jitter -= missed * control_period_ms_;
+
+  control_steps_++;
+  control_jitter_ms_ = jitter;
+  control_jitter_sum_ms_ += jitter;
+  control_jitter_max_ms_ = std::max(control_jitter_max_ms_, jitter);
+  control_jitter_window_max_ms_ = std::max(control_jitter_window_max_ms_, jitter);
+  sample_age_ms_ = external_sample_ms_ != 0 ? now - external_sample_ms_ : 0;
+  sample_age_max_ms_ = std::max(sample_age_max_ms_, sample_age_ms_);
+
+  if (is_pi_mode()) {
+    handle_automatic_mode();
+  }
+  learn_economy_(now, control_period_ms_ * (missed + 1) / 1000.0f);
+}
+
+// The held sample is no longer fit to control on: no accepted sample for a few sensor intervals
+// (at least PI_SAMPLE_STALE_MIN_MS, at most the grace period)
+bool SunsterHeater::external_sample_stale_() const {
+  if (external_sample_ms_ == 0) return false;
+  float interval_s = temperature_estimator_.sample_interval_s();
+  uint32_t limit = PI_SAMPLE_STALE_MIN_MS;
+  if (!std::isnan(interval_s)) {
+    limit = std::max(limit, static_cast<uint32_t>(interval_s * PI_SAMPLE_STALE_INTERVALS * 1000.0f));
+  }
+  return sample_age_ms_ > std::min(limit, PI_SENSOR_GRACE_PERIOD_MS);
+}
+
+// ECONOMY: inside the band around the target, alternate between the cheapest learned level pair
+// (high below target - band/2, low above target + band/2) instead of the PI's 10 % steps.
+// Returns false (PI level stays) while the model has no pair or T_pred is outside the band.
+bool SunsterHeater::economy_level_(float t_pred, float &pct) {
+  if (control_mode_ != ControlMode::ECONOMY || current_state_ != HeaterState::STABLE_COMBUSTION ||
+      std::fabs(t_pred - target_temperature_) > economy_band_) {
+    return false;
+  }
+  uint8_t low = 0, high = 0;
+  float fuel_ml_s;
+  if (!economy_model_.best_pair(low, high, fuel_ml_s)) {
+    return false;
+  }
+  if (t_pred < target_temperature_ - economy_band_ / 2.0f) {
+    economy_high_ = true;
+  } else if (t_pred > target_temperature_ + economy_band_ / 2.0f) {
+    economy_high_ = false;
+  }
+  pct = (economy_high_ ? high : low) * 10.0f;
+  economy_active_ = true;
+  return true;
+}
+
+// Runs every control step in every mode: learns the (slope, fuel) of the level being held once
+// the slope has settled, and accrues ECONOMY savings against the PI's adjacent-level mix.
+void SunsterHeater::learn_economy_(uint32_t now, float dt_s) {
+  bool active = economy_active_;
+  economy_active_ = false;
+  if (!temperature_estimator_.is_initialized() || sample_age_ms_ > 60000u) {
+    return;
+  }
+  uint8_t level;
+  if (current_state_ == HeaterState::STABLE_COMBUSTION && heater_enabled_ && pump_frequency_ > 0.0f) {
+    level = power_level_;
+  } else if (current_state_ == HeaterState::OFF && !heater_enabled_) {
+    level = 0;
+  } else {
+    economy_signature_ = 0;
+    return;
+  }
+  uint32_t signature = 0x10000u | (static_cast<uint32_t>(current_state_) << 8) | level;
+  if (signature != economy_signature_) {
+    economy_signature_ = signature;
+    economy_hold_since_ = now;
+  }
+  float fuel_ml_s = level > 0 ? pump_frequency_ * dose_ml_per_pulse_() : 0.0f;
+  uint32_t settle_ms = static_cast<uint32_t>((slope_window_s_ + t_lookahead_s_) * 1000.0f);
+  if (now - economy_hold_since_ >= settle_ms &&
+      std::fabs(temperature_estimator_.temperature() - target_temperature_) <= 2.0f * economy_band_) {
+    economy_model_.observe(level, temperature_estimator_.rate(), fuel_ml_s, dt_s);
+  }
+
+  uint8_t low = 0, high = 0;
+  float baseline_ml_s;
+  if (active && economy_model_.adjacent_pair(low, high, baseline_ml_s)) {
+    economy_savings_ml_ += (baseline_ml_s - fuel_ml_s) * dt_s;
+    economy_hold_s_ += dt_s;
+  }
+}
+
+CyclePhase SunsterHeater::cycle_phase_() const {
+  switch (current_state_) {
+    case HeaterState::POLLING_STATE:
+    case HeaterState::HEATING_UP:
+      return CyclePhase::STARTING;
+    case HeaterState::STABLE_COMBUSTION:
+      return CyclePhase::RUNNING;
+    case HeaterState::STOPPING_COOLING:
+      return CyclePhase::STOPPING;
+    default:
+      return CyclePhase::OFF;
+  }
+}
+
+// Fuel rate at 10 %: learned level 1 from the economy model, else the pump while at level 1
+float SunsterHeater::idle_fuel_rate_() const {
+  if (economy_model_.is_learned(1)) return economy_model_.fuel_ml_s(1);
+  if (current_state_ == HeaterState::STABLE_COMBUSTION && power_level_ == 1 && pump_frequency_ > 0.0f) {
+    return pump_frequency_ * injected_per_pulse_ * pump_calibration_.factor(1);
+  }
+  return NAN;
+}
+
+// Length of the off period a stop would start: average of the measured automatic off periods,
+// else the time the learned off slope needs to move the PI output from the off to the on threshold
+float SunsterHeater::predicted_off_s_() const {
+  if (cycle_tracker_.off_periods() > 0) return cycle_tracker_.average_off_s();
+  if (economy_model_.is_learned(0) && economy_model_.slope(0) < 0.0f && pi_kp_ > 0.0f) {
+    return (output_on_threshold_ - output_off_threshold_) / (pi_kp_ * -economy_model_.slope(0));
+  }
+  return NAN;
+}
+
+// PI wants the heater off: keep it at 10 % if the predicted off period costs less fuel at 10 % than
+// a stop and restart, but never longer than the break-even time. Unknown costs always stop.
+bool SunsterHeater::idle_instead_of_stop_(uint32_t now) {
+  if (!cycle_aware_stop_) return false;
+  float break_even_s = cycle_tracker_.break_even_s(idle_fuel_rate_(), cycle_penalty_ml_);
+  if (cycle_tracker_.is_idling()) {
+    float idled_s = cycle_tracker_.idle_elapsed_s(now);
+    if (idled_s < break_even_s) return true;
+    ESP_LOGI(TAG, "[CYCLE] Idled %.0fs (break-even %.0fs), stopping", idled_s, break_even_s);
+    cycle_tracker_.end_idle(now, false);
+    cycle_tracker_.count_stop_decision();
+    return false;
+  }
+  float off_s = predicted_off_s_();
+  if (break_even_s <= 0.0f || std::isnan(off_s) || off_s >= break_even_s) {
+    ESP_LOGD(TAG, "[CYCLE] Stopping: predicted off %.0fs, break-even %.0fs", off_s, break_even_s);
+    cycle_tracker_.count_stop_decision();
+    return false;
+  }
+  ESP_LOGI(TAG, "[CYCLE] Idling at 10%%: predicted off %.0fs < break-even %.0fs (cycle %.1f ml)", off_s,
+           break_even_s, cycle_tracker_.cycle_cost_ml(cycle_penalty_ml_));
+  cycle_tracker_.begin_idle(now);
+  return true;
+}
+
+void SunsterHeater::service_tx_() {
+  if (passive_sniff_mode_ || !tx_scheduler_started_) {
+    return;
+  }
+  // Event-driven TX: send as soon as the commanded frame content changes,
+  // rate-limited by min_tx_gap_ms_. The periodic keep-alive stays in update().
+  // Changes that follow the heater's own state (e.g. Start -> Running) are sent the
+  // same way but only request_tx_() starts the command latency clock.
+  if (controller_signature_() == last_tx_signature_) {
+    command_pending_since_ = 0;
+    return;
+  }
+  if (millis() - last_send_time_ >= min_tx_gap_ms_) {
+    ESP_LOGV(TAG, "Command changed, sending controller frame immediately");
+    send_controller_frame();
+  }
+}
+
+void SunsterHeater::request_tx_() {
+  if (tx_scheduler_started_ && command_pending_since_ == 0) {
+    command_pending_since_ = millis();
+  }
+}
+
+bool SunsterHeater::tx_pending_() const {
+  if (command_pending_since_ != 0) return true;
+  return !passive_sniff_mode_ && tx_scheduler_started_ && controller_signature_() != last_tx_signature_;
+}
+
+void SunsterHeater::record_command_latency_(uint32_t latency_ms) {
+  last_command_latency_ms_ = latency_ms;
+  max_command_latency_ms_ = std::max(max_command_latency_ms_, latency_ms);
+  command_latency_sum_ms_ += latency_ms;
+  command_latency_count_++;
+  ESP_LOGD(TAG, "Command-to-wire latency: %u ms", (unsigned) latency_ms);
+  if (command_latency_sensor_) {
+    command_latency_sensor_->publish_state(latency_ms);
+  }
+}
+
+void SunsterHeater::record_rx_latency_(uint32_t latency_us) {
+  rx_latency_last_us_ = latency_us;
+  rx_latency_max_us_ = std::max(rx_latency_max_us_, latency_us);
+  rx_latency_sum_us_ += latency_us;
+  rx_latency_count_++;
+}
+
+void SunsterHeater::set_publish_filter(TelemetryChannel channel, float deadband, float deadband_percent,
+                                       uint32_t min_interval_ms, uint32_t heartbeat_ms) {
+  publish_filters_[static_cast<uint8_t>(channel)].configure(deadband, deadband_percent, min_interval_ms, heartbeat_ms);
+}
+
+void SunsterHeater::publish_filtered_(sensor::Sensor *sens, TelemetryChannel channel, float value, bool force) {
+  if (sens == nullptr) return;
+  PublishFilter &filter = publish_filters_[static_cast<uint8_t>(channel)];
+  uint32_t now = millis();
+  if (!force && !filter.should_publish(value, now)) {
+    publishes_suppressed_++;
+    return;
+  }
+  filter.mark_published(value, now);
+  publishes_emitted_++;
+  sens->publish_state(value);
+}
+
+void SunsterHeater::publish_filtered_(text_sensor::TextSensor *sens, TelemetryChannel channel, const char *value) {
+  if (sens == nullptr) return;
+  PublishFilter &filter = publish_filters_[static_cast<uint8_t>(channel)];
+  uint32_t now = millis();
+  if (!filter.should_publish(sens->state != value, now)) {
+    publishes_suppressed_++;
+    return;
+  }
+  filter.mark_published(NAN, now);
+  publishes_emitted_++;
+  sens->publish_state(value);
+}
+
+void SunsterHeater::publish_filtered_(binary_sensor::BinarySensor *sens, TelemetryChannel channel, bool value,
+                                      bool force) {
+  if (sens == nullptr) return;
+  PublishFilter &filter = publish_filters_[static_cast<uint8_t>(channel)];
+  uint32_t now = millis();
+  if (!force && !filter.should_publish(value ? 1.0f : 0.0f, now)) {
+    publishes_suppressed_++;
+    return;
+  }
+  filter.mark_published(value ? 1.0f : 0.0f, now);
+  publishes_emitted_++;
+  sens->publish_state(value);
+}
+
+void SunsterHeater::publish_diagnostics_() {
+  uint32_t now = millis();
+  if (last_diagnostics_publish_ != 0 && now - last_diagnostics_publish_ < DIAGNOSTICS_INTERVAL_MS) return;
+  last_diagnostics_publish_ = now;
+  if (publishes_emitted_sensor_) publishes_emitted_sensor_->publish_state(publishes_emitted_);
+  if (publishes_suppressed_sensor_) publishes_suppressed_sensor_->publish_state(publishes_suppressed_);
+  if (control_jitter_sensor_) control_jitter_sensor_->publish_state(control_jitter_window_max_ms_);
+  control_jitter_window_max_ms_ = 0;
+  if (economy_savings_sensor_) economy_savings_sensor_->publish_state(economy_savings_ml_);
+  if (flash_write_rate_sensor_) flash_write_rate_sensor_->publish_state(flash_writes_per_hour_());
+  if (cycle_cost_sensor_ && cycle_tracker_.has_cost())
+    cycle_cost_sensor_->publish_state(cycle_tracker_.cycle_cost_ml(cycle_penalty_ml_));
+  if (cycle_voltage_sag_sensor_ && cycle_tracker_.has_cost())
+    cycle_voltage_sag_sensor_->publish_state(cycle_tracker_.last().voltage_sag_v);
+  if (start_stop_cycles_sensor_) start_stop_cycles_sensor_->publish_state(cycle_tracker_.starts());
+  if (idle_decisions_sensor_) idle_decisions_sensor_->publish_state(cycle_tracker_.idle_decisions());
+  if (sample_age_sensor_ && external_sample_ms_ != 0) sample_age_sensor_->publish_state((now - external_sample_ms_) / 1000.0f);
+  for (uint8_t i = 0; i < LINK_STAT_COUNT; i++) {
+    if (link_stat_sensors_[i]) link_stat_sensors_[i]->publish_state(link_stats_.value(static_cast<LinkStat>(i)));
+  }
+  if (simulator_ != nullptr) {
+    const SimMetrics &m = simulator_->metrics();
+    ESP_LOGI(TAG, "[sim] t=%.0fs cabin=%.2f sensor=%.2f target=%.1f overshoot=%.2f settled_at=%.0fs fuel=%.1fml starts=%u",
+             m.elapsed_s, simulator_->cabin_temperature(), simulator_->sensor_temperature(), target_temperature_,
+             m.overshoot_c, m.settled_at_s, m.fuel_ml, (unsigned) m.starts);
+  }
+}
+
+void SunsterHeater::dump_capture() {
+  if (capture_.capacity() == 0) {
+    ESP_LOGW(TAG, "Capture disabled (set capture_buffer_size)");
+    return;
+  }
+  if (capture_dumping_) return;
+  // Recording is paused until the last chunk is out so the stream stays consistent
+  capture_.set_paused(true);
+  capture_dumping_ = true;
+  capture_dump_offset_ = 0;
+  ESP_LOGI(TAG, "[capture] begin %u bytes, %u records (%u evicted)", (unsigned) capture_.stream_size(),
+           (unsigned) capture_.records(), (unsigned) capture_.evicted());
+}
+
+void SunsterHeater::service_capture_dump_() {
+  uint8_t chunk[CAPTURE_DUMP_CHUNK];
+  for (uint8_t line = 0; line < CAPTURE_DUMP_LINES_PER_LOOP; line++) {
+    size_t n = capture_.read_stream(capture_dump_offset_, chunk, sizeof(chunk));
+    if (n == 0) {
+      ESP_LOGI(TAG, "[capture] end");
+      capture_dumping_ = false;
+      capture_.set_paused(false);
+      return;
+    }
+    ESP_LOGI(TAG, "[capture] %s", base64_encode(chunk, n).c_str());
+    capture_dump_offset_ += n;
+  }
+}
+
+void SunsterHeater::export_pi_telemetry() {
+  if (pi_exporting_) return;
+  pi_export_seq_ = pi_telemetry_.first_seq();
+  pi_export_end_seq_ = pi_telemetry_.next_seq();
+  pi_exporting_ = true;
+  ESP_LOGI(TAG, "[pi_csv] %u steps", (unsigned) (pi_export_end_seq_ - pi_export_seq_));
+  ESP_LOGI(TAG, "[pi_csv] t_ms,dt_s,target,measured,t_pred,slope,error,p,i,output,decision,power,state,enabled,sample_age_ms,jitter_ms");
+}
+
+void SunsterHeater::service_pi_export_() {
+  for (uint8_t line = 0; line < PI_EXPORT_LINES_PER_LOOP; line++) {
+    if (pi_export_seq_ >= pi_export_end_seq_) {
+      ESP_LOGI(TAG, "[pi_csv] end");
+      pi_exporting_ = false;
+      return;
+    }
+    const PiStepRecord *rec = pi_telemetry_.get(pi_export_seq_++);
+    if (rec == nullptr) continue;  // overwritten while exporting
+    ESP_LOGI(TAG, "[pi_csv] %u,%.2f,%.2f,%.2f,%.2f,%.5f,%.3f,%.2f,%.2f,%.1f,%s,%u,%u,%u,%u,%u", (unsigned) rec->time_ms,
+             rec->dt_s, rec->target, rec->measured, rec->t_pred, rec->slope, rec->error, rec->p_term, rec->i_term,
+             rec->output, pi_decision_to_string(rec->decision), (unsigned) rec->power_percent,
+             (unsigned) rec->heater_state, (unsigned) rec->enabled, (unsigned) rec->sample_age_ms,
+             (unsigned) rec->jitter_ms);
+  }
+}
+
+uint32_t SunsterHeater::wall_clock_s_() {
+#ifdef USE_TIME
+  if (time_component_ != nullptr) {
+    auto now = time_component_->now();
+    if (now.is_valid()) return now.timestamp;
+  }
+#endif
+  std::time_t now = std::time(nullptr);
+  return now < 1609459200 ? 0 : static_cast<uint32_t>(now);  // not synced yet
+}
+
+void SunsterHeater::record_history_(const HeaterTelemetry &t, bool start) {
+  uint32_t now = millis();
+  uint32_t dt = history_frame_ms_ != 0 ? now - history_frame_ms_ : 0;
+  history_frame_ms_ = now;
+  if (dt > fuel_max_gap_ms_) dt = fuel_max_gap_ms_;
+
+  // Fuel comes from the exact counter; a reset restarts the reference
+  if (total_fuel_mp_ >= history_total_mp_) {
+    history_.add_fuel(total_fuel_mp_ - history_total_mp_);
+  }
+  history_total_mp_ = total_fuel_mp_;
+  if ((current_state_ == HeaterState::HEATING_UP || current_state_ == HeaterState::STABLE_COMBUSTION) &&
+      t.power_level > 0 && t.power_level <= 10) {
+    history_.add_burn(dt, t.power_level);
+  }
+  if (start) history_.add_start();
+  if (t.voltage_raw > 0) history_.add_voltage(t.input_voltage);
+  roll_history_();
+}
+
+void SunsterHeater::roll_history_() {
+  bool clock_known = history_.open_hour() != 0;
+  if (!history_.roll(wall_clock_s_() / 3600, injected_per_pulse_)) {
+    if (!clock_known && history_.open_hour() != 0) publish_history_();  // first synced time
+    return;
+  }
+  history_dirty_hours_ |= 1u << history_.hour_chunk_dirty();
+  history_dirty_days_ |= 1u << history_.day_chunk_dirty();
+  persist_(PersistRecord::HISTORY);
+  publish_history_();
+}
+
+void SunsterHeater::set_history_day(uint8_t days_ago) {
+  history_day_ = days_ago < HistoryStore::DAYS ? days_ago : HistoryStore::DAYS - 1;
+  publish_history_();
+}
+
+void SunsterHeater::publish_history_() {
+  if (history_sensor_ == nullptr) return;
+  uint32_t today = wall_clock_s_() / 86400;
+  if (today == 0) {
+    history_sensor_->publish_state("time not synced");
+    return;
+  }
+  char date[12];
+  HistoryStore::format_day(today - history_day_, date, sizeof(date));
+  HistoryBucket day = history_.day_view(today - history_day_, injected_per_pulse_);
+  char buf[96];
+  if (day.min_voltage_cv > 0) {
+    snprintf(buf, sizeof(buf), "%s: %.1f ml, %u min, %u starts, %.0f%% avg, min %.2f V", date, day.fuel_ml(),
+             (unsigned) day.burner_min, (unsigned) day.starts, day.mean_power_percent(), day.min_voltage());
+  } else {
+    snprintf(buf, sizeof(buf), "%s: %.1f ml, %u min, %u starts, %.0f%% avg", date, day.fuel_ml(),
+             (unsigned) day.burner_min, (unsigned) day.starts, day.mean_power_percent());
+  }
+  history_sensor_->publish_state(buf);
+}
+
+void SunsterHeater::dump_history() {
+  if (history_dumping_) return;
+  uint32_t hour = wall_clock_s_() / 3600;
+  if (hour == 0) {
+    ESP_LOGW(TAG, "[history] Time not synced, nothing to dump");
+    return;
+  }
+  history_dump_days_ = true;
+  history_dump_index_ = hour / 24 >= HistoryStore::DAYS ? hour / 24 - (HistoryStore::DAYS - 1) : 1;
+  history_dump_end_ = hour / 24;
+  history_dumping_ = true;
+  ESP_LOGI(TAG, "[history] day,fuel_ml,burner_min,starts,avg_power_pct,min_voltage (UTC)");
+}
+
+void SunsterHeater::service_history_dump_() {
+  for (uint8_t line = 0; line < HISTORY_DUMP_LINES_PER_LOOP; line++) {
+    if (history_dump_index_ > history_dump_end_) {
+      if (!history_dump_days_) {
+        ESP_LOGI(TAG, "[history] end");
+        history_dumping_ = false;
+        return;
+      }
+      // Days done, continue with the hourly buckets of the last two days
+      uint32_t hour = wall_clock_s_() / 3600;
+      history_dump_days_ = false;
+      history_dump_index_ = hour >= HistoryStore::HOURS ? hour - (HistoryStore::HOURS - 1) : 1;
+      history_dump_end_ = hour;
+      ESP_LOGI(TAG, "[history] hour,fuel_ml,burner_min,starts,avg_power_pct,min_voltage (UTC)");
       continue;
     }
-    
-    if (frame_sync_) {
-      rx_buffer_.push_back(byte);
-      this->last_received_time_ = millis();
-      
-      // Check if we have enough bytes to determine frame length
-      if (rx_buffer_.size() >= 4) {
-        uint8_t expected_length = (rx_buffer_[3] == HEATER_FRAME_LENGTH) ? 57 : 16;
-        
-        if (rx_buffer_.size() >= expected_length) {
-          // Frame complete: log raw RX and decode only in passive sniff mode (avoids blocking)
-          if (passive_sniff_mode_) {
-            log_frame_raw("RX", rx_buffer_);
-            log_decode_attempt(rx_buffer_, expected_length);
-          }
-          
-          // First check if this is a controller frame echo (should be silently ignored)
-          if (rx_buffer_[1] == CONTROLLER_ID) {
-            ESP_LOGVV(TAG, "Ignoring controller frame echo");
-            rx_buffer_.clear();
-            frame_sync_ = false;
-            continue;
+    uint32_t index = history_dump_index_++;
+    HistoryBucket bucket{};
+    char label[20];
+    if (history_dump_days_) {
+      bucket = history_.day_view(index, injected_per_pulse_);
+      HistoryStore::format_day(index, label, sizeof(label));
+    } else {
+      const HistoryBucket *stored = history_.hour(index);
+      if (index == history_.open_hour()) {
+        bucket = history_.open_bucket(injected_per_pulse_);
+      } else if (stored != nullptr) {
+        bucket = *stored;
+      }
+      HistoryStore::format_day(index / 24, label, sizeof(label));
+      size_t len = strlen(label);
+      snprintf(label + len, sizeof(label) - len, " %02u:00", (unsigned) (index % 24));
+    }
+    if (bucket.fuel_dl == 0 && bucket.burner_min == 0 && bucket.starts == 0) continue;  // nothing recorded
+    ESP_LOGI(TAG, "[history] %s,%.1f,%u,%u,%.0f,%.2f", label, bucket.fuel_ml(), (unsigned) bucket.burner_min,
+             (unsigned) bucket.starts, bucket.mean_power_percent(), bucket.min_voltage());
+  }
+}
+
+bool SunsterHeater::read_rx_byte_(uint8_t *byte) {
+  if (simulator_ != nullptr) {
+    if (sim_rx_pos_ >= sim_rx_len_) return false;
+    *byte = sim_rx_[sim_rx_pos_++];
+    return true;
+  }
+  return this->available() && this->read_byte(byte);
+}
+
+size_t SunsterHeater::rx_buffered_() {
+  // The simulator hands over a whole frame at once, so its bytes are not backdated
+  if (simulator_ != nullptr) return 0;
+  int available = this->available();
+  return available > 0 ? static_cast<size_t>(available) : 0;
+}
+
+void SunsterHeater::service_simulation_() {
+  uint32_t now = millis();
+  if (sim_last_step_ == 0) sim_last_step_ = now;
+  if (now - sim_last_step_ < 100) return;
+  simulator_->step((now - sim_last_step_) / 1000.0f, target_temperature_);
+  sim_last_step_ = now;
+}
+
+void SunsterHeater::check_uart_data() {
+  uint32_t start_us = micros();
+  uint32_t bytes = 0;
+  // Arrival estimate for the bytes already waiting, so time spent in the UART buffer counts
+  // as latency: the backlog took buffered * rx_byte_us_ to arrive, back to back; if a frame
+  // was still coming in at the previous drain, the bytes kept its pace since then. Each
+  // byte gets the earlier of the two, half a byte time in. Bytes that arrive during the
+  // drain are stamped when read.
+  size_t buffered = rx_buffered_();
+  uint8_t byte;
+  // Bounded drain: at 4800 baud only ~8 bytes arrive per 16 ms loop, so the budget
+  // just keeps a burst (e.g. after a blocking log call) from stalling the loop.
+  while (true) {
+    // Bytes queued by a resync are re-parsed before new UART data
+    if (rx_parser_.has_replay()) {
+      byte = rx_parser_.take_replay();
+    } else if (bytes < RX_BYTES_PER_LOOP && (micros() - start_us) < RX_TIME_BUDGET_US && read_rx_byte_(&byte)) {
+      if (bytes < buffered) {
+        rx_byte_arrival_us_ = start_us - (buffered - bytes) * rx_byte_us_ + rx_byte_us_ / 2;
+        uint32_t paced_us = rx_drain_end_us_ + bytes * rx_byte_us_ + rx_byte_us_ / 2;
+        if (rx_stream_open_ && static_cast<int32_t>(paced_us - rx_byte_arrival_us_) < 0) {
+          rx_byte_arrival_us_ = paced_us;
+        }
+      } else {
+        rx_byte_arrival_us_ = micros();
+      }
+      bytes++;
+      if (rx_parser_.in_frame() || byte == FRAME_START) {
+        this->last_received_time_ = millis();
+      }
+    } else {
+      break;
+    }
+
+    switch (rx_parser_.feed(byte)) {
+      case FrameParser::Result::NONE:
+        break;
+
+      case FrameParser::Result::OVERSIZE:
+        ESP_LOGW(TAG, "Frame too long, resetting");
+        link_stats_.oversize_resets++;
+        break;
+
+      case FrameParser::Result::FRAME: {
+        FrameView frame = rx_parser_.frame();
+        if (capture_.is_enabled()) {
+          capture_.record(CaptureRecordType::RX, millis(), frame.data, static_cast<uint8_t>(frame.size));
+        }
+        // Controller frame echo (our own TX on the single-wire bus) is silently ignored
+        if (frame[1] == CONTROLLER_ID) {
+          ESP_LOGVV(TAG, "Ignoring controller frame echo");
+          link_stats_.echo_frames++;
+          trace_frame_(TraceDirection::RX, frame, TRACE_FLAG_ECHO);
+          break;
+        }
+
+        if (validate_frame(frame)) {
+          link_stats_.rx_frames++;
+          comm_timeout_active_ = false;
+          if (rtt_tx_time_ != 0) {
+            link_stats_.rtt.add(millis() - rtt_tx_time_);
+            rtt_tx_time_ = 0;
           }
-          
-          if (validate_frame(rx_buffer_, expected_length)) {
-            process_heater_frame(rx_buffer_);
+          process_heater_frame(frame);
+          // From the arrival of the newest byte read; a frame found in resync replay ended no
+          // later than that
+          record_rx_latency_(micros() - rx_byte_arrival_us_);
+          // Trace after processing so the record carries the decoded state (raw frame -> ring, no formatting)
+          const FrameLayout *layout = find_frame_layout(frame);
+          if (layout != nullptr && layout->decode != nullptr) {
+            trace_frame_(TraceDirection::RX, frame, TRACE_FLAG_DECODED, static_cast<uint8_t>(current_state_));
           } else {
-            ESP_LOGW(TAG, "Invalid frame received");
+            trace_frame_(TraceDirection::RX, frame);
           }
-          
-          rx_buffer_.clear();
-          frame_sync_ = false;
-        } else if (rx_buffer_.size() > expected_length + 10) {
-          // Frame too long, reset
-          ESP_LOGW(TAG, "Frame too long, resetting");
-          rx_buffer_.clear();
-          frame_sync_ = false;
+        } else {
+          // Rejected: look for the next 0xAA inside the bytes we already have
+          ESP_LOGW(TAG, "Invalid frame received, resyncing");
+          link_stats_.resyncs++;
+          trace_frame_(TraceDirection::RX, frame, TRACE_FLAG_REJECTED);
+          rx_parser_.resync();
         }
+        break;
       }
     }
   }
-  
+  // Drain cost (parser and frame handling), timed once per loop() for dump_config
+  rx_drain_end_us_ = micros();
+  if (bytes > 0) {
+    rx_drain_us_ += rx_drain_end_us_ - start_us;
+    rx_drain_bytes_ += bytes;
+  }
+
   // Timeout check for incomplete frames
-  if (frame_sync_ && (millis() - last_received_time_) > 100) {
+  if (rx_parser_.in_frame() && (millis() - last_received_time_) > 100) {
     ESP_LOGV(TAG, "Frame timeout, resetting");
-    rx_buffer_.clear();
-    frame_sync_ = false;
+    link_stats_.partial_timeouts++;
+    rx_parser_.reset();
   }
+  rx_stream_open_ = rx_parser_.in_frame();
 }
 
-bool SunsterHeater::validate_frame(const std::vector<uint8_t> &frame, uint8_t expected_length) {
-  if (frame.size() != expected_length) {
-    ESP_LOGV(TAG, "Frame length mismatch: expected %d, got %d", expected_length, frame.size());
+bool SunsterHeater::validate_frame(const FrameView &frame) {
+  if (frame.size < 4) {
+    ESP_LOGV(TAG, "Frame too short: %u bytes", (unsigned) frame.size);
     return false;
   }
-  
+
   if (frame[0] != FRAME_START) {
     ESP_LOGV(TAG, "Invalid frame start: 0x%02X", frame[0]);
     return false;
@@ -267,121 +819,137 @@ bool SunsterHeater::validate_frame(const std::vector<uint8_t> &frame, uint8_t ex
   
   // Verify checksum
   uint8_t calculated_checksum = calculate_checksum(frame);
-  uint8_t received_checksum = frame[frame.size() - 1];
+  uint8_t received_checksum = frame[frame.size - 1];
   
   if (calculated_checksum != received_checksum) {
+    link_stats_.checksum_failures++;
     ESP_LOGD(TAG, "Checksum mismatch: calculated 0x%02X, received 0x%02X", 
              calculated_checksum, received_checksum);
-    // Don't reject on checksum mismatch - just log it
-    // The working version doesn't validate checksums either
+    // Only reject in strict mode; the original controller firmware doesn't validate checksums either
+    if (strict_checksum_) {
+      return false;
+    }
   }
   
   return true;
 }
 
-void SunsterHeater::log_frame_raw(const char* direction, const std::vector<uint8_t> &frame) {
-  if (frame.empty()) return;
-  std::string hex;
-  hex.reserve(frame.size() * 3 + 1);
-  for (size_t i = 0; i < frame.size(); ++i) {
-    if (i) hex += ' ';
-    char buf[4];
-    snprintf(buf, sizeof(buf), "%02X", frame[i]);
-    hex += buf;
+void SunsterHeater::trace_frame_(TraceDirection direction, const FrameView &frame, uint8_t flags, uint8_t state) {
+  if (frame_trace_ || passive_sniff_mode_) {
+    trace_.push(millis(), direction, frame, flags, state);
   }
-  ESP_LOGI(TAG, "[%s] raw (%zu bytes): %s", direction, frame.size(), hex.c_str());
 }
 
-void SunsterHeater::log_decode_attempt(const std::vector<uint8_t> &frame, uint8_t expected_length) {
-  if (frame.size() < 4) return;
-  uint8_t calc_csum = calculate_checksum(frame);
-  uint8_t recv_csum = frame[frame.size() - 1];
-  ESP_LOGI(TAG, "[decode] len=%d expected=%d device_id=0x%02X len_byte=0x%02X checksum calc=0x%02X recv=0x%02X %s",
-           (int)frame.size(), expected_length, frame[1], frame[3], calc_csum, recv_csum,
-           calc_csum == recv_csum ? "OK" : "MISMATCH");
-  if (frame[3] == HEATER_FRAME_LENGTH && frame.size() >= 57) {
-    uint8_t state_raw = frame[5];
-    uint8_t power_raw = frame[6];
-    uint16_t voltage_raw = read_uint16_be(frame, 10);
-    uint8_t glow_raw = frame[13];
-    uint8_t cooling = frame[14];
-    uint8_t byte15 = frame.size() > 15 ? frame[15] : 0;
-    int16_t temp_raw = static_cast<int16_t>(read_uint16_be(frame, 16));
-    uint16_t duration_raw = read_uint16_be(frame, 20);
-    uint8_t pump_raw = frame[23];
-    uint16_t fan_raw = read_uint16_be(frame, 28);
-    ESP_LOGI(TAG, "[decode] long frame: state=0x%02X power=%u voltage_raw=%u(%.1fV) glow=%.2fA cooling=%u byte15=0x%02X temp_raw=%d(%.1fC) duration=%u pump=%.1fHz fan=%u",
-             state_raw, power_raw, voltage_raw, voltage_raw / 10.0f, glow_raw / 100.0f, cooling, byte15,
-             (int)temp_raw, temp_raw / 10.0f, duration_raw, pump_raw / 10.0f, fan_raw);
-  } else if (frame[3] == CONTROLLER_FRAME_LENGTH && frame.size() >= 16) {
-    ESP_LOGI(TAG, "[decode] short frame (controller): cmd=0x%02X power=0x%02X state_byte=0x%02X",
-             frame[2], frame[8], frame[9]);
+void SunsterHeater::dump_trace() {
+  if (trace_dump_remaining_ > 0) return;
+  trace_dump_remaining_ = trace_.size();
+  ESP_LOGI(TAG, "[trace] %u records (%u overwritten)", (unsigned) trace_.size(), (unsigned) trace_.overwritten());
+}
+
+void SunsterHeater::drain_trace_() {
+  TraceRecord rec;
+  if (!trace_.pop(rec)) {
+    trace_dump_remaining_ = 0;
+    return;
+  }
+  if (trace_dump_remaining_ > 0) trace_dump_remaining_--;
+  static const char *const DIRECTIONS[] = {"RX", "TX", "TX (suppressed)"};
+  const char *direction = DIRECTIONS[static_cast<uint8_t>(rec.direction)];
+  log_frame_raw(direction, rec);
+  // Full decode is only worth the log volume while sniffing
+  if (passive_sniff_mode_ && rec.direction == TraceDirection::RX) {
+    log_decode_attempt(rec.view());
   }
 }
 
-void SunsterHeater::send_controller_frame() {
-  std::vector<uint8_t> frame;
-  
-  // Build controller frame
-  frame.push_back(FRAME_START);           // 0: Start byte
-  frame.push_back(CONTROLLER_ID);         // 1: Controller ID
-  
-  // Determine command based on current state and desired state
-  if (!heater_enabled_) {
-    if (current_state_ != HeaterState::OFF) {
-      frame.push_back(0x06);              // 2: Stop command
-    } else {
-      frame.push_back(0x02);              // 2: Status request
-    }
+void SunsterHeater::log_frame_raw(const char *direction, const TraceRecord &rec) {
+  static const char HEX_DIGITS[] = "0123456789ABCDEF";
+  char hex[FrameParser::CAPACITY * 3 + 1];
+  size_t pos = 0;
+  for (size_t i = 0; i < rec.length; ++i) {
+    if (i) hex[pos++] = ' ';
+    hex[pos++] = HEX_DIGITS[rec.data[i] >> 4];
+    hex[pos++] = HEX_DIGITS[rec.data[i] & 0x0F];
+  }
+  hex[pos] = '\0';
+  const char *note = (rec.flags & TRACE_FLAG_ECHO) ? " echo" : (rec.flags & TRACE_FLAG_REJECTED) ? " rejected" : "";
+  if (rec.flags & TRACE_FLAG_DECODED) {
+    ESP_LOGI(TAG, "[%s] t=%u raw (%u bytes, state %s): %s", direction, (unsigned) rec.time_ms, (unsigned) rec.length,
+             state_to_string(static_cast<HeaterState>(rec.state)), hex);
   } else {
-    if (hardware_stopping_cooling_stale_) {
-      frame.push_back(0x06);              // 2: Stop command (force hardware out of STOPPING_COOLING)
-    } else if (current_state_ == HeaterState::OFF) {
-      frame.push_back(0x06);              // 2: Start command
-    } else {
-      frame.push_back(0x02);              // 2: Status request
-    }
+    ESP_LOGI(TAG, "[%s] t=%u raw (%u bytes%s): %s", direction, (unsigned) rec.time_ms, (unsigned) rec.length, note, hex);
   }
+}
 
-  frame.push_back(CONTROLLER_FRAME_LENGTH); // 3: Frame length
-  frame.push_back(0x00);                    // 4: Unknown
-  frame.push_back(0x00);                    // 5: Unknown
-  frame.push_back(0x00);                    // 6: Unknown
-  frame.push_back(0x00);                    // 7: Unknown
-  frame.push_back(power_level_);            // 8: Power level (1-10)
+void SunsterHeater::log_decode_attempt(const FrameView &frame) {
+  if (frame.size < 4) return;
+  uint8_t calc_csum = calculate_checksum(frame);
+  uint8_t recv_csum = frame[frame.size - 1];
+  ESP_LOGI(TAG, "[decode] len=%d device_id=0x%02X len_byte=0x%02X checksum calc=0x%02X recv=0x%02X %s",
+           (int)frame.size, frame[1], frame[3], calc_csum, recv_csum,
+           calc_csum == recv_csum ? "OK" : "MISMATCH");
+  const FrameLayout *layout = find_frame_layout(frame);
+  if (layout != nullptr && layout->decode != nullptr) {
+    HeaterTelemetry t = layout->decode(frame);
+    ESP_LOGI(TAG, "[decode] %s: state=0x%02X power=%u voltage_raw=%u(%.1fV) glow=%.2fA cooling=%u byte15=0x%02X temp=%.1fC duration=%u pump=%.1fHz fan=%u",
+             layout->name, t.state_raw, t.power_level, t.voltage_raw, t.input_voltage, t.glow_current, t.cooling, t.sub_state,
+             t.heat_exchanger_temperature, t.state_duration, t.pump_frequency, t.fan_speed);
+  } else if (layout != nullptr) {
+    ESP_LOGI(TAG, "[decode] %s (controller): cmd=0x%02X power=0x%02X state_byte=0x%02X",
+             layout->name, frame[2], frame[8], frame[9]);
+  } else {
+    ESP_LOGI(TAG, "[decode] unknown layout");
+  }
+}
 
-  // Set requested state
+void SunsterHeater::controller_command_bytes_(uint8_t &cmd, uint8_t &state) const {
+  // Byte 2: command, byte 9: requested state
   if (!heater_enabled_) {
     if (current_state_ != HeaterState::OFF) {
-      frame.push_back(0x05);              // 9: Set off
+      cmd = 0x06;    // Stop command
+      state = 0x05;  // Set off
     } else {
-      frame.push_back(0x02);              // 9: Off
+      cmd = 0x02;    // Status request
+      state = 0x02;  // Off
     }
+    return;
+  }
+  if (hardware_stopping_cooling_stale_) {
+    cmd = 0x06;  // Stop command (force hardware out of STOPPING_COOLING)
+  } else if (current_state_ == HeaterState::OFF) {
+    cmd = 0x06;  // Start command
   } else {
-    if (control_mode_ == ControlMode::FAN_ONLY) {
-      frame.push_back(0x14);              // 9: Ventilation (fan only)
-    } else if (hardware_stopping_cooling_stale_) {
-      frame.push_back(0x05);              // 9: Set off (force hardware to acknowledge OFF)
-    } else if (current_state_ == HeaterState::OFF) {
-      frame.push_back(0x06);              // 9: Start
-    } else {
-      frame.push_back(0x08);              // 9: Running
-    }
+    cmd = 0x02;  // Status request
+  }
+  if (control_mode_ == ControlMode::FAN_ONLY) {
+    state = 0x14;  // Ventilation (fan only)
+  } else if (hardware_stopping_cooling_stale_) {
+    state = 0x05;  // Set off (force hardware to acknowledge OFF)
+  } else if (current_state_ == HeaterState::OFF) {
+    state = 0x06;  // Start
+  } else {
+    state = 0x08;  // Running
   }
-  
-  frame.push_back(0x00);                    // 10: Unknown
-  frame.push_back(0x00);                    // 11: Unknown
-  frame.push_back(0x00);                    // 12: Unknown
-  frame.push_back(0x00);                    // 13: Unknown
-  frame.push_back(0x00);                    // 14: Unknown
-  
-  // Calculate and add checksum
-  uint8_t checksum = calculate_checksum(frame);
-  frame.push_back(checksum);                // 15: Checksum
+}
+
+uint32_t SunsterHeater::controller_signature_() const {
+  uint8_t cmd, state;
+  controller_command_bytes_(cmd, state);
+  return static_cast<uint32_t>(cmd) | (static_cast<uint32_t>(power_level_) << 8) | (static_cast<uint32_t>(state) << 16);
+}
+
+void SunsterHeater::send_controller_frame() {
+  uint8_t cmd, state;
+  controller_command_bytes_(cmd, state);
+
+  // Patch command (2), power level (8) and requested state (9) into the frame template;
+  // the checksum is adjusted incrementally and an unchanged request is sent as is.
+  tx_frame_.set(cmd, power_level_, state);
+  FrameView frame = tx_frame_.view();
   
   if (passive_sniff_mode_) {
-    log_frame_raw("TX (suppressed)", frame);
-    ESP_LOGI(TAG, "TX not sent (passive sniff mode): enabled=%s, power=%d, state=0x%02X",
+    trace_frame_(TraceDirection::TX_SUPPRESSED, frame);
+    ESP_LOGV(TAG, "TX not sent (passive sniff mode): enabled=%s, power=%d, state=0x%02X",
              YESNO(heater_enabled_), power_level_, frame[9]);
     return;
   }
@@ -391,39 +959,56 @@ void SunsterHeater::send_controller_frame() {
     ESP_LOGW(TAG, "Sending STOP to force hardware out of stale STOPPING_COOLING before START");
   }
 
-  // Send frame
-  this->write_array(frame.data(), frame.size());
+  // Send frame (simulation: the simulated heater answers with a status frame via the RX path)
+  if (simulator_ != nullptr) {
+    simulator_->apply_controller_frame(frame);
+    simulator_->build_status_frame(sim_rx_);
+    sim_rx_len_ = HEATER_FRAME_SIZE;
+    sim_rx_pos_ = 0;
+  } else {
+    this->write_array(tx_frame_.data(), ControllerFrame::SIZE);
+  }
+  uint32_t now = millis();
+  if (capture_.is_enabled()) {
+    capture_.record(CaptureRecordType::TX, now, tx_frame_.data(), ControllerFrame::SIZE);
+  }
+  trace_frame_(TraceDirection::TX, frame);
+  last_send_time_ = now;
+  link_stats_.tx_frames++;
+  rtt_tx_time_ = now != 0 ? now : 1;
+  last_tx_signature_ = controller_signature_();
+  if (command_pending_since_ != 0) {
+    record_command_latency_(now - command_pending_since_);
+    command_pending_since_ = 0;
+  }
 
   // Track start command for grace period (heater needs time to start, don't sync OFF too soon)
   if (heater_enabled_ && (frame[2] == 0x06 || frame[9] == 0x06)) {
-    last_start_request_time_ = millis();
+    last_start_request_time_ = now;
   }
 
   ESP_LOGV(TAG, "Sent controller frame: enabled=%s, power=%d, state=0x%02X",
            YESNO(heater_enabled_), power_level_, frame[9]);
 }
 
-// 57-byte heater frame (from log analysis): 0=AA 1=77 2=cmd 3=0x34, 5=state, 6=power(1-10),
-// 10-11=voltage BE/10, 13=0xB8 const, 14=cooling, 15=sub-state, 16-17=temp BE/10,
-// 20-21=duration BE, 23=pump/10 Hz, 28-29=fan BE. Bytes 46+ often 24 09 20 10 then varying.
-void SunsterHeater::process_heater_frame(const std::vector<uint8_t> &frame) {
-  if (frame[3] == HEATER_FRAME_LENGTH && frame.size() >= 57) {
-    // Long frame from heater
-    ESP_LOGV(TAG, "Processing heater status frame");
-    
-    // Parse heater state (byte 5)
-    uint8_t state_raw = frame[5];
-    HeaterState new_state = static_cast<HeaterState>(state_raw);
+void SunsterHeater::process_heater_frame(const FrameView &frame) {
+  const FrameLayout *layout = find_frame_layout(frame);
+  if (layout == nullptr) {
+    log_unknown_layout_(frame);
+    return;
+  }
+  if (layout->decode != nullptr) {
+    // Status frame from heater: decode once, all consumers work on the telemetry struct
+    ESP_LOGV(TAG, "Processing heater status frame (%s)", layout->name);
+    const HeaterTelemetry t = layout->decode(frame);
+    HeaterState new_state = static_cast<HeaterState>(t.state_raw);
 
     // Override stale STOPPING_COOLING: heater firmware sometimes gets stuck
     // If no activity (fan=0, pump=0) for >5 min, treat as OFF on ESP side
     // and set flag so send_controller_frame() sends STOP to force hardware out
     if (new_state == HeaterState::STOPPING_COOLING) {
-      uint16_t duration = read_uint16_be(frame, 20);
-      uint16_t fan_raw = read_uint16_be(frame, 28);
-      uint8_t pump_raw = frame[23];
-      if (duration > STOPPING_COOLING_TIMEOUT_S && fan_raw == 0 && pump_raw == 0) {
-        ESP_LOGW(TAG, "Stale STOPPING_COOLING (%us, fan=0, pump=0) -> treating as OFF", duration);
+      if (t.state_duration > STOPPING_COOLING_TIMEOUT_S && t.fan_speed == 0 && t.pump_raw == 0) {
+        ESP_LOGW(TAG, "Stale STOPPING_COOLING (%us, fan=0, pump=0) -> treating as OFF", t.state_duration);
         new_state = HeaterState::OFF;
         hardware_stopping_cooling_stale_ = true;
       }
@@ -435,10 +1020,7 @@ void SunsterHeater::process_heater_frame(const std::vector<uint8_t> &frame) {
       if (new_state == HeaterState::STABLE_COMBUSTION) {
         time_stable_combustion_entered_ = millis();
         last_pi_time_ = 0;  // so first PI step uses default dt_s
-        slope_warmup_done_ = false;  // reset slope and wait slope_window before PI
-        slope_filtered_ = 0.0f;
-        temp_prev_ = external_temperature_;
-        time_prev_ = millis();
+        slope_warmup_done_ = false;  // wait slope_window before PI
       } else {
         time_stable_combustion_entered_ = 0;
         slope_warmup_done_ = false;
@@ -470,151 +1052,208 @@ void SunsterHeater::process_heater_frame(const std::vector<uint8_t> &frame) {
     }
     
     // Update all sensors
-    update_sensors(frame);
-    
-  } else if (frame[3] == CONTROLLER_FRAME_LENGTH && frame.size() >= 16) {
+    update_sensors(t);
+
+    CyclePhase phase = cycle_phase_();
+    record_history_(t, phase == CyclePhase::STARTING && cycle_tracker_.phase() != CyclePhase::STARTING);
+
+    uint32_t starts = cycle_tracker_.starts();
+    cycle_tracker_.update(millis(), phase, get_total_consumption(),
+                          t.voltage_raw > 0 ? t.input_voltage : 0.0f, t.glow_current);
+    if (cycle_tracker_.starts() != starts) {
+      const CycleCost &cost = cycle_tracker_.last();
+      ESP_LOGI(TAG, "[CYCLE] Start: %.1f ml in %.0fs, glow plug %.2f Wh, voltage sag %.2f V", cost.start_fuel_ml,
+               cost.start_s, cost.glow_wh, cost.voltage_sag_v);
+    }
+  } else {
     // Short frame (controller echo)
     ESP_LOGVV(TAG, "Received controller frame echo");
     // Usually just an echo of our own transmission
   }
 }
 
-void SunsterHeater::update_sensors(const std::vector<uint8_t> &frame) {
+void SunsterHeater::log_unknown_layout_(const FrameView &frame) {
+  // Compact signature: device id, length byte, size. Each is logged once, later frames only counted.
+  uint32_t signature = (static_cast<uint32_t>(frame[1]) << 16) | (static_cast<uint32_t>(frame[3]) << 8) |
+                       static_cast<uint32_t>(frame.size & 0xFF);
+  unknown_layout_frames_++;
+  for (uint8_t i = 0; i < unknown_layouts_seen_count_; i++) {
+    if (unknown_layouts_seen_[i] == signature) return;
+  }
+  if (unknown_layouts_seen_count_ >= MAX_UNKNOWN_LAYOUTS) {
+    // Table full: a new layout cannot be remembered, so it would be logged on every frame
+    if (unknown_layout_suppressed_frames_++ == 0) {
+      ESP_LOGW(TAG, "More than %u unknown frame layouts, further layouts suppressed (counted only)",
+               (unsigned) MAX_UNKNOWN_LAYOUTS);
+    }
+    return;
+  }
+  unknown_layouts_seen_[unknown_layouts_seen_count_++] = signature;
+  ESP_LOGW(TAG, "Unknown frame layout id=0x%02X len=0x%02X size=%u cmd=0x%02X (logged once per layout)",
+           frame[1], frame[3], (unsigned) frame.size, frame[2]);
+}
+
+void SunsterHeater::update_sensors(const HeaterTelemetry &t) {
   // State sensor
   if (state_sensor_) {
-    state_sensor_->publish_state(state_to_string(current_state_));
+    publish_filtered_(state_sensor_, TelemetryChannel::STATE, state_to_string(current_state_));
   }
   
-  // Power level (byte 6)
-  uint8_t power_level_raw = frame[6];
-  if (power_level_sensor_ && power_level_raw > 0 && power_level_raw <= 10) {
-    power_level_sensor_->publish_state(power_level_raw * 10);
+  // Power level reported by the heater (1-10)
+  if (power_level_sensor_ && t.power_level > 0 && t.power_level <= 10) {
+    publish_filtered_(power_level_sensor_, TelemetryChannel::POWER_LEVEL, t.power_level * 10);
   }
   
-  // Input voltage (bytes 10-11, uint16 big-endian / 10.0) - newer protocol
-  if (input_voltage_sensor_ && frame.size() > 11) {
-    uint16_t voltage_raw = read_uint16_be(frame, 10);
-    if (voltage_raw > 0) {
-      input_voltage_ = voltage_raw / 10.0f;
-      input_voltage_sensor_->publish_state(input_voltage_);
+  // Input voltage (heater reports 0 V while off)
+  if (t.voltage_raw > 0) {
+    input_voltage_ = t.input_voltage;
+    if (input_voltage_sensor_) {
+      publish_filtered_(input_voltage_sensor_, TelemetryChannel::INPUT_VOLTAGE, input_voltage_);
+    }
+    // Supply collapsing (battery disconnected): get the counters to flash while it still works
+    if (persistence_.check_brownout(millis(), input_voltage_, min_voltage_operate_)) {
+      ESP_LOGW(TAG, "Supply voltage %.1f V falling towards %.1f V, flushing preferences", input_voltage_,
+               min_voltage_operate_);
+      if (total_fuel_mp_ != journaled_total_mp_) persist_(PersistRecord::FUEL_JOURNAL);
+      commit_persistence_();
     }
   }
   
   // Glow plug status (derived from state + fan): Preheat / Ignition / Off
-  if (glow_plug_status_sensor_ && frame.size() > 29) {
-    uint16_t fan = read_uint16_be(frame, 28);
+  if (glow_plug_status_sensor_) {
     const char *status = "Off";
     if (current_state_ == HeaterState::POLLING_STATE) {
-      status = (fan == 0) ? "Preheat" : "Ignition";
+      status = (t.fan_speed == 0) ? "Preheat" : "Ignition";
     }
-    glow_plug_status_sensor_->publish_state(status);
+    publish_filtered_(glow_plug_status_sensor_, TelemetryChannel::GLOW_PLUG_STATUS, status);
   }
   
-  // Cooling down flag (byte 14)
-  uint8_t cooling_flag = frame[14];
+  // Cooling down flag
+  cooling_down_ = t.cooling;
   if (cooling_down_sensor_) {
-    cooling_down_ = (cooling_flag != 0);
-    cooling_down_sensor_->publish_state(cooling_down_);
+    publish_filtered_(cooling_down_sensor_, TelemetryChannel::COOLING_DOWN, cooling_down_);
   }
   
-  // Heat exchanger temperature (bytes 16-17, int16 big-endian / 10.0) - newer protocol
-  if (heat_exchanger_temperature_sensor_ && frame.size() > 17) {
-    // Read as signed int16 to handle negative temperatures correctly
-    int16_t temp_raw = static_cast<int16_t>(read_uint16_be(frame, 16));
-    heat_exchanger_temperature_ = temp_raw / 10.0f;
-    heat_exchanger_temperature_sensor_->publish_state(heat_exchanger_temperature_);
-    
-    // Update current temperature for climate control (no duplicate temperature sensor)
-    current_temperature_ = heat_exchanger_temperature_;
+  // Heat exchanger temperature; also used as current temperature for climate control
+  heat_exchanger_temperature_ = t.heat_exchanger_temperature;
+  current_temperature_ = heat_exchanger_temperature_;
+  if (heat_exchanger_temperature_sensor_) {
+    publish_filtered_(heat_exchanger_temperature_sensor_, TelemetryChannel::HEAT_EXCHANGER_TEMPERATURE, heat_exchanger_temperature_);
   }
   
-  // State duration (bytes 20-21)
-  if (state_duration_sensor_ && frame.size() > 21) {
-    uint16_t duration_raw = read_uint16_be(frame, 20);
-    state_duration_sensor_->publish_state(duration_raw);
+  // State duration
+  state_duration_ = t.state_duration;
+  if (state_duration_sensor_) {
+    publish_filtered_(state_duration_sensor_, TelemetryChannel::STATE_DURATION, state_duration_);
   }
   
-  // Pump frequency (byte 23)
-  if (pump_frequency_sensor_ && frame.size() > 23) {
-    uint8_t pump_raw = frame[23];
-    float new_pump_frequency = pump_raw / 10.0f;
-    
-    // Update fuel consumption based on pump frequency change
-    update_fuel_consumption(new_pump_frequency);
-    
-    pump_frequency_ = new_pump_frequency;
-    pump_frequency_sensor_->publish_state(pump_frequency_);
+  // Pump frequency: update fuel consumption before storing the new frequency
+  update_fuel_consumption(t.pump_raw, t.power_level);
+  pump_frequency_ = t.pump_frequency;
+  pump_level_ = t.power_level;
+  if (pump_frequency_sensor_) {
+    publish_filtered_(pump_frequency_sensor_, TelemetryChannel::PUMP_FREQUENCY, pump_frequency_);
   }
   
-  // Fan speed (bytes 28-29)
-  if (fan_speed_sensor_ && frame.size() > 29) {
-    fan_speed_ = read_uint16_be(frame, 28);
-    fan_speed_sensor_->publish_state(fan_speed_);
+  // Fan speed
+  fan_speed_ = t.fan_speed;
+  if (fan_speed_sensor_) {
+    publish_filtered_(fan_speed_sensor_, TelemetryChannel::FAN_SPEED, fan_speed_);
   }
 }
 
-void SunsterHeater::update_fuel_consumption(float pump_frequency) {
+void SunsterHeater::update_fuel_consumption(uint8_t pump_raw, uint8_t level) {
   uint32_t current_time = millis();
   uint32_t time_delta = current_time - last_consumption_update_;
-  
-  // Only update if the heater is in a state where fuel is being consumed
-  if (current_state_ == HeaterState::STABLE_COMBUSTION || 
-      current_state_ == HeaterState::HEATING_UP) {
-    
-    // If pump frequency > 0, fuel is being injected
-    if (pump_frequency > 0.0f && time_delta > 0) {
-      // Calculate fuel consumption based on pump frequency and time
-      // pump_frequency is in Hz (pulses per second)
-      float time_seconds = time_delta / 1000.0f;
-      float pulses = pump_frequency * time_seconds;
-      float consumed_ml = pulses * injected_per_pulse_;
-      
-      // Update daily consumption counter
-      daily_consumption_ml_ += consumed_ml;
-      total_fuel_pulses_ += pulses;  // Keep as float for precision
-      
-      // Update total consumption
-      total_consumption_ml_ = total_fuel_pulses_ * injected_per_pulse_;
-      
-      // Calculate instantaneous consumption rate for logging
-      float instantaneous_ml_per_hour = pump_frequency * injected_per_pulse_ * 3600.0f;
-      
-      ESP_LOGVV(TAG, "Fuel consumption rate: %.2f ml/h, total daily: %.2f ml", 
-                instantaneous_ml_per_hour, daily_consumption_ml_);
-      
-      // Update daily consumption sensor
-      if (daily_consumption_sensor_) {
-        daily_consumption_sensor_->publish_state(daily_consumption_ml_);
-      }
-      
-      // Update total consumption sensor
-      if (total_consumption_sensor_) {
-        total_consumption_sensor_->publish_state(total_consumption_ml_);
-      }
-      
-      // Save data periodically (every 30 seconds to reduce flash wear)
-      static uint32_t last_save = 0;
-      if (current_time - last_save > 30000) {
-        save_fuel_consumption_data();
-        last_save = current_time;
-      }
+  bool fuel_state = current_state_ == HeaterState::STABLE_COMBUSTION || current_state_ == HeaterState::HEATING_UP;
+
+  // Integrate only while the heater is (or just was) in a state where fuel is being consumed,
+  // trapezoid between the previous and this frame's pump frequency
+  if ((fuel_state || last_fuel_state_) && (pump_raw > 0 || last_pump_raw_ > 0) && time_delta > 0) {
+    if (time_delta > fuel_max_gap_ms_) {
+      ESP_LOGD(TAG, "Fuel integration gap %ums clamped to %ums", (unsigned) time_delta, (unsigned) fuel_max_gap_ms_);
+      time_delta = fuel_max_gap_ms_;
+      fuel_gaps_clamped_++;
     }
-  }
-  
-  last_pump_frequency_ = pump_frequency;
+    uint64_t raw_milli_pulses = fuel_counter_.integrate(last_pump_raw_, pump_raw, time_delta);
+    pump_calibration_.count(raw_milli_pulses, level);
+    // Counters hold pulses at the calibrated dose of this level
+    uint64_t milli_pulses = pump_calibration_.scale(raw_milli_pulses, level);
+    daily_fuel_mp_ += milli_pulses;
+    total_fuel_mp_ += milli_pulses;
+    tank_.add_fuel(current_time, milli_pulses);
+
+    ESP_LOGVV(TAG, "Fuel consumption rate: %.2f ml/h, total daily: %.2f ml",
+              pump_raw * 0.1f * injected_per_pulse_ * pump_calibration_.factor(level) * 3600.0f, get_daily_consumption());
+    publish_fuel_consumption_();
+    // Journal the new pulses; flush the rest once the heater has stopped pumping
+    journal_fuel_consumption_(!fuel_state);
+  }
+
+  last_pump_raw_ = pump_raw;
+  last_fuel_state_ = fuel_state;
   last_consumption_update_ = current_time;
 }
 
+// Schedules a journal record once enough pulses have accumulated (or force); the record is
+// written by the next persistence commit
+void SunsterHeater::journal_fuel_consumption_(bool force) {
+  if (persistence_.is_dirty(PersistRecord::FUEL_BASE)) return;  // the pending base covers it
+  uint64_t delta = total_fuel_mp_ - journaled_total_mp_;
+  if (delta == 0) return;
+  uint32_t now = millis();
+  if (!force && delta < FUEL_JOURNAL_MIN_DELTA_MP && now - last_journal_ms_ < FUEL_JOURNAL_MAX_AGE_MS) return;
+  last_journal_ms_ = now;
+  persist_(PersistRecord::FUEL_JOURNAL);
+}
+
+// Appends the pulses counted since the last record as one journal slot. The base snapshot is
+// rewritten instead when the ring is full.
+void SunsterHeater::write_fuel_journal_() {
+  uint64_t delta = total_fuel_mp_ - journaled_total_mp_;
+  if (delta == 0) return;
+  if (delta > UINT32_MAX || fuel_journal_.needs_compaction()) {
+    save_fuel_consumption_data();  // base covers everything, including this delta
+    return;
+  }
+  FuelJournalRecord rec;
+  size_t slot = fuel_journal_.append(current_day_, static_cast<uint32_t>(delta), rec);
+  if (pref_fuel_journal_[slot].save(&rec)) {
+    journaled_total_mp_ = total_fuel_mp_;
+    fuel_record_writes_++;
+    if (pump_calibration_.is_active()) save_pump_calibration_();  // session progress at journal pace
+    ESP_LOGV(TAG, "Fuel journal record %u -> slot %u (%.3f pulses)", (unsigned) rec.seq, (unsigned) slot,
+             FuelCounter::to_pulses(delta));
+  } else {
+    ESP_LOGW(TAG, "Failed to append fuel journal record");
+  }
+}
+
+float SunsterHeater::flash_writes_per_hour_() const {
+  uint32_t uptime_ms = millis();
+  if (uptime_ms < 60000) return 0.0f;
+  return (fuel_base_writes_ + fuel_record_writes_) * 3600000.0f / uptime_ms;
+}
+
+void SunsterHeater::publish_fuel_consumption_() {
+  if (daily_consumption_sensor_) {
+    publish_filtered_(daily_consumption_sensor_, TelemetryChannel::DAILY_CONSUMPTION, get_daily_consumption());
+  }
+  if (total_consumption_sensor_) {
+    publish_filtered_(total_consumption_sensor_, TelemetryChannel::TOTAL_CONSUMPTION, get_total_consumption());
+  }
+}
+
 void SunsterHeater::check_daily_reset() {
   uint32_t today = get_days_since_epoch();
   if (today != current_day_) {
     ESP_LOGI(TAG, "New day detected, resetting daily consumption counter");
     current_day_ = today;
-    daily_consumption_ml_ = 0.0f;
-    save_fuel_consumption_data();
+    daily_fuel_mp_ = 0;
+    persist_(PersistRecord::FUEL_BASE);
     
     if (daily_consumption_sensor_) {
-      daily_consumption_sensor_->publish_state(daily_consumption_ml_);
+      publish_filtered_(daily_consumption_sensor_, TelemetryChannel::DAILY_CONSUMPTION, get_daily_consumption(), true);
     }
   }
 }
@@ -665,114 +1304,182 @@ uint32_t SunsterHeater::get_days_since_epoch() {
 }
 
 void SunsterHeater::save_fuel_consumption_data() {
-  FuelConsumptionData data;
-  data.daily_consumption_ml = daily_consumption_ml_;
+  FuelConsumptionDataV2 data;
   data.last_reset_day = current_day_;
-  data.total_pulses = total_fuel_pulses_;
+  data.daily_milli_pulses = daily_fuel_mp_;
+  data.total_milli_pulses = total_fuel_mp_;
+  data.journal_seq = fuel_journal_.last_seq();
   
   if (pref_fuel_consumption_.save(&data)) {
-    ESP_LOGD(TAG, "Fuel consumption data saved: %.2f ml, day %d", 
-             data.daily_consumption_ml, data.last_reset_day);
+    fuel_journal_.compacted();
+    journaled_total_mp_ = total_fuel_mp_;
+    fuel_base_writes_++;
+    ESP_LOGD(TAG, "Fuel consumption data saved: %.2f ml, day %u, journal seq %u", get_daily_consumption(),
+             (unsigned) data.last_reset_day, (unsigned) data.journal_seq);
   } else {
     ESP_LOGW(TAG, "Failed to save fuel consumption data");
   }
 }
 
 void SunsterHeater::load_fuel_consumption_data() {
-  FuelConsumptionData data;
-  if (pref_fuel_consumption_.load(&data)) {
+  FuelConsumptionDataV2 data;
+  bool loaded = pref_fuel_consumption_.load(&data) && data.version == 2;
+  bool migrated = false;
+  if (!loaded) {
+    // v1 (float counters): convert once, the daily ml back to pulses with the saved injected_per_pulse
+    FuelConsumptionData legacy;
+    if (pref_fuel_consumption_legacy_.load(&legacy)) {
+      data.last_reset_day = legacy.last_reset_day;
+      data.total_milli_pulses = FuelCounter::from_pulses(legacy.total_pulses);
+      data.daily_milli_pulses =
+          injected_per_pulse_ > 0.0f ? FuelCounter::from_pulses(legacy.daily_consumption_ml / injected_per_pulse_) : 0;
+      loaded = migrated = true;
+      ESP_LOGI(TAG, "Migrated fuel consumption data to exact pulse counters (%.0f pulses)", legacy.total_pulses);
+    }
+  }
+  // Replay the journal records newer than the base
+  FuelJournalRecord slots[FuelJournal::SLOTS];
+  for (size_t i = 0; i < FuelJournal::SLOTS; i++) {
+    if (!pref_fuel_journal_[i].load(&slots[i])) slots[i] = FuelJournalRecord{};
+  }
+  FuelTotals totals{data.last_reset_day, data.daily_milli_pulses, data.total_milli_pulses};
+  if (!loaded) totals = FuelTotals{0, 0, 0};
+  fuel_journal_.replay(loaded && !migrated ? data.journal_seq : 0, totals, slots);
+  if (fuel_journal_.replayed() > 0) {
+    ESP_LOGI(TAG, "Replayed %u fuel journal records", (unsigned) fuel_journal_.replayed());
+    data.last_reset_day = totals.day;
+    data.daily_milli_pulses = totals.daily_milli_pulses;
+    data.total_milli_pulses = totals.total_milli_pulses;
+    loaded = true;
+  }
+
+  if (loaded) {
     // Check if it's the same day
     uint32_t today = get_days_since_epoch();
     if (data.last_reset_day == today) {
-      daily_consumption_ml_ = data.daily_consumption_ml;
-      ESP_LOGI(TAG, "Loaded fuel consumption data: %.2f ml for today", daily_consumption_ml_);
+      daily_fuel_mp_ = data.daily_milli_pulses;
+      ESP_LOGI(TAG, "Loaded fuel consumption data: %.2f ml for today", get_daily_consumption());
     } else {
-      daily_consumption_ml_ = 0.0f;
+      daily_fuel_mp_ = 0;
       ESP_LOGI(TAG, "New day detected, starting with 0 ml consumption");
     }
-    total_fuel_pulses_ = data.total_pulses;
+    total_fuel_mp_ = data.total_milli_pulses;
   } else {
     ESP_LOGI(TAG, "No fuel consumption data found, starting fresh");
-    daily_consumption_ml_ = 0.0f;
-    total_fuel_pulses_ = 0;
-  }
-  
-  // Publish initial value to sensor so it's not "unknown"
-  if (daily_consumption_sensor_) {
-    daily_consumption_sensor_->publish_state(daily_consumption_ml_);
+    daily_fuel_mp_ = 0;
+    total_fuel_mp_ = 0;
   }
+  journaled_total_mp_ = total_fuel_mp_;
+  if (migrated) save_fuel_consumption_data();
   
-  // Publish total consumption
-  total_consumption_ml_ = total_fuel_pulses_ * injected_per_pulse_;
-  if (total_consumption_sensor_) {
-    total_consumption_sensor_->publish_state(total_consumption_ml_);
-  }
+  // Publish initial values to sensors so they're not "unknown"
+  publish_fuel_consumption_();
+}
+
+void SunsterHeater::bind_config_() {
+  config_store_.bind(ConfigTag::PI_KP, &pi_kp_);
+  config_store_.bind(ConfigTag::PI_KI, &pi_ki_);
+  config_store_.bind(ConfigTag::PI_KD, &pi_kd_);
+  config_store_.bind(ConfigTag::TARGET_TEMPERATURE, &target_temperature_);
+  config_store_.bind(ConfigTag::PI_OUTPUT_MIN_OFF, &pi_output_min_off_);
+  config_store_.bind(ConfigTag::PI_OUTPUT_MIN_ON, &pi_output_min_on_);
+  config_store_.bind(ConfigTag::INJECTED_PER_PULSE, &injected_per_pulse_);
+  config_store_.bind(ConfigTag::PI_OFF_DELAY, &pi_off_delay_);
+  config_store_.bind(ConfigTag::PI_MIN_ON_TIME, &pi_min_on_time_s_);
+  config_store_.bind(ConfigTag::PI_ON_DELAY, &pi_on_delay_s_);
+  config_store_.bind(ConfigTag::T_LOOKAHEAD, &t_lookahead_s_);
+  config_store_.bind(ConfigTag::SLOPE_WINDOW, &slope_window_s_);
+  config_store_.bind(ConfigTag::OUTPUT_OFF_THRESHOLD, &output_off_threshold_);
+  config_store_.bind(ConfigTag::OUTPUT_ON_THRESHOLD, &output_on_threshold_);
 }
 
 void SunsterHeater::load_config_data() {
   ESP_LOGI(TAG, "[CONFIG] Reading from flash... (YAML defaults before load: Kp=%.2f Ki=%.2f Target=%.1f)", pi_kp_, pi_ki_, target_temperature_);
-  HeaterConfigData data;
-  if (pref_config_.load(&data)) {
-    ESP_LOGI(TAG, "[CONFIG] Flash preference loaded, version=%u", data.version);
-    if (data.version >= 3 && data.version <= 6) {
-      if (std::isnan(data.pi_kp) || std::isnan(data.pi_ki) || std::isnan(data.pi_kd) || std::isnan(data.target_temperature)) {
-         ESP_LOGW(TAG, "[CONFIG] Loaded data has NAN, using defaults");
-         save_config_data();
-         return;
-      }
-      pi_kp_ = data.pi_kp;
-      pi_ki_ = data.pi_ki;
-      pi_kd_ = data.pi_kd;
-      target_temperature_ = data.target_temperature;
-      pi_output_min_off_ = data.pi_output_min_off;
-      pi_output_min_on_ = data.pi_output_min_on;
-      injected_per_pulse_ = data.injected_per_pulse;
-      pi_off_delay_ = data.pi_off_delay;
-      if (data.version >= 4) {
-        pi_min_on_time_s_ = data.pi_min_on_time_s;
-      }
-      if (data.version >= 5) {
-        pi_on_delay_s_ = data.pi_on_delay;
-      }
-      if (data.version >= 6) {
-        if (!std::isnan(data.t_lookahead)) t_lookahead_s_ = data.t_lookahead;
-        if (!std::isnan(data.slope_window)) slope_window_s_ = data.slope_window;
-        if (!std::isnan(data.output_off_threshold)) output_off_threshold_ = data.output_off_threshold;
-        if (!std::isnan(data.output_on_threshold)) output_on_threshold_ = data.output_on_threshold;
-      }
-      ESP_LOGI(TAG, "[CONFIG] After boot: Kp=%.2f Ki=%.2f target=%.1f t_look=%.0f slope_win=%.0f off_thr=%.0f on_thr=%.0f tmin=%.1fs",
-               pi_kp_, pi_ki_, target_temperature_, t_lookahead_s_, slope_window_s_, output_off_threshold_, output_on_threshold_, pi_min_on_time_s_);
-    } else {
-      ESP_LOGW(TAG, "[CONFIG] Version mismatch (got %u), using YAML defaults", data.version);
-      save_config_data();
+  bind_config_();
+  // One record per tag, keyed by the tag; unknown tags are never touched
+  size_t loaded = 0;
+  for (size_t i = 0; i < config_store_.size(); i++) {
+    pref_config_records_[i] =
+        global_preferences->make_preference<ConfigRecord>(fnv1_hash("heater_config_tlv") + config_store_.tag(i));
+    ConfigRecord rec;
+    if (pref_config_records_[i].load(&rec) && config_store_.apply(i, rec)) {
+      loaded++;
     }
+  }
+  if (loaded > 0) {
+    ESP_LOGI(TAG, "[CONFIG] %u of %u records loaded, others keep YAML values", (unsigned) loaded,
+             (unsigned) config_store_.size());
+  } else if (migrate_legacy_config_()) {
+    save_config_data();
   } else {
     ESP_LOGI(TAG, "[CONFIG] No flash data, using YAML defaults");
-    save_config_data();
   }
+  ESP_LOGI(TAG, "[CONFIG] After boot: Kp=%.2f Ki=%.2f target=%.1f t_look=%.0f slope_win=%.0f off_thr=%.0f on_thr=%.0f tmin=%.1fs",
+           pi_kp_, pi_ki_, target_temperature_, t_lookahead_s_, slope_window_s_, output_off_threshold_, output_on_threshold_, pi_min_on_time_s_);
 }
 
-void SunsterHeater::save_config_data() {
+// Imports the versioned HeaterConfigData blob (v3-v6) into the config store. The blob itself
+// is left in place, so older firmware still finds it.
+bool SunsterHeater::migrate_legacy_config_() {
   HeaterConfigData data;
-  data.version = 6;
-  data.pi_kp = pi_kp_;
-  data.pi_ki = pi_ki_;
-  data.pi_kd = pi_kd_;
-  data.target_temperature = target_temperature_;
-  data.pi_output_min_off = pi_output_min_off_;
-  data.pi_output_min_on = pi_output_min_on_;
-  data.injected_per_pulse = injected_per_pulse_;
-  data.pi_off_delay = pi_off_delay_;
-  data.pi_min_on_time_s = pi_min_on_time_s_;
-  data.pi_on_delay = pi_on_delay_s_;
-  data.t_lookahead = t_lookahead_s_;
-  data.slope_window = slope_window_s_;
-  data.output_off_threshold = output_off_threshold_;
-  data.output_on_threshold = output_on_threshold_;
-  if (pref_config_.save(&data)) {
-    ESP_LOGD(TAG, "Config preferences saved");
-  } else {
-    ESP_LOGW(TAG, "Failed to save config preferences");
+  if (!pref_config_.load(&data)) {
+    return false;
+  }
+  if (data.version < 3 || data.version > 6) {
+    ESP_LOGW(TAG, "[CONFIG] Legacy config version %u not supported, using YAML defaults", (unsigned) data.version);
+    return false;
+  }
+  if (std::isnan(data.pi_kp) || std::isnan(data.pi_ki) || std::isnan(data.pi_kd) || std::isnan(data.target_temperature)) {
+    ESP_LOGW(TAG, "[CONFIG] Legacy config has NAN, using YAML defaults");
+    return false;
+  }
+  auto import = [this](ConfigTag tag, float *member, float value) {
+    if (std::isnan(value)) return;
+    *member = value;
+    int i = config_store_.find(tag);
+    if (i >= 0) config_store_.mark_dirty(i);
+  };
+  import(ConfigTag::PI_KP, &pi_kp_, data.pi_kp);
+  import(ConfigTag::PI_KI, &pi_ki_, data.pi_ki);
+  import(ConfigTag::PI_KD, &pi_kd_, data.pi_kd);
+  import(ConfigTag::TARGET_TEMPERATURE, &target_temperature_, data.target_temperature);
+  import(ConfigTag::PI_OUTPUT_MIN_OFF, &pi_output_min_off_, data.pi_output_min_off);
+  import(ConfigTag::PI_OUTPUT_MIN_ON, &pi_output_min_on_, data.pi_output_min_on);
+  import(ConfigTag::INJECTED_PER_PULSE, &injected_per_pulse_, data.injected_per_pulse);
+  import(ConfigTag::PI_OFF_DELAY, &pi_off_delay_, data.pi_off_delay);
+  if (data.version >= 4) {
+    import(ConfigTag::PI_MIN_ON_TIME, &pi_min_on_time_s_, data.pi_min_on_time_s);
+  }
+  if (data.version >= 5) {
+    import(ConfigTag::PI_ON_DELAY, &pi_on_delay_s_, data.pi_on_delay);
+  }
+  if (data.version >= 6) {
+    import(ConfigTag::T_LOOKAHEAD, &t_lookahead_s_, data.t_lookahead);
+    import(ConfigTag::SLOPE_WINDOW, &slope_window_s_, data.slope_window);
+    import(ConfigTag::OUTPUT_OFF_THRESHOLD, &output_off_threshold_, data.output_off_threshold);
+    import(ConfigTag::OUTPUT_ON_THRESHOLD, &output_on_threshold_, data.output_on_threshold);
+  }
+  ESP_LOGI(TAG, "[CONFIG] Migrated legacy config v%u to per-parameter records", (unsigned) data.version);
+  return true;
+}
+
+// Writes only the records whose value changed
+void SunsterHeater::save_config_data() {
+  size_t written = 0;
+  for (size_t i = 0; i < config_store_.size(); i++) {
+    if (!config_store_.is_dirty(i)) continue;
+    ConfigRecord rec;
+    config_store_.encode(i, rec);
+    if (pref_config_records_[i].save(&rec)) {
+      config_store_.mark_stored(i);
+      written++;
+    } else {
+      ESP_LOGW(TAG, "Failed to save config record %u", (unsigned) config_store_.tag(i));
+    }
+  }
+  config_record_writes_ += written;
+  if (written > 0) {
+    ESP_LOGD(TAG, "Config preferences saved (%u record%s)", (unsigned) written, written == 1 ? "" : "s");
   }
 }
 
@@ -836,35 +1543,177 @@ void SunsterHeater::publish_all_config_entities_() {
       mode = "Antifreeze";
     else if (is_fan_only_mode())
       mode = "Fan Only";
+    else if (is_autotune_mode())
+      mode = "Autotune";
+    else if (is_economy_mode())
+      mode = "Economy";
     control_mode_select_->publish_state(mode);
     ESP_LOGD(TAG, "[CONFIG] push ControlMode = %s", mode);
   }
 }
 
 void SunsterHeater::save_config_preferences() {
-  config_dirty_ = true;
-  config_last_change_ = millis();
+  // Debounced: slider drags end up as one write
+  persist_(PersistRecord::CONFIG, CONFIG_SAVE_DEBOUNCE_MS, true);
 }
 
 void SunsterHeater::reset_daily_consumption() {
   ESP_LOGI(TAG, "Manual reset of daily consumption counter");
-  daily_consumption_ml_ = 0.0f;
-  save_fuel_consumption_data();
+  daily_fuel_mp_ = 0;
+  persist_(PersistRecord::FUEL_BASE);
   
   if (daily_consumption_sensor_) {
-    daily_consumption_sensor_->publish_state(daily_consumption_ml_);
+    publish_filtered_(daily_consumption_sensor_, TelemetryChannel::DAILY_CONSUMPTION, get_daily_consumption(), true);
   }
 }
 
 void SunsterHeater::reset_total_consumption() {
   ESP_LOGI(TAG, "Manual reset of total consumption counter");
-  total_fuel_pulses_ = 0.0f;
-  total_consumption_ml_ = 0.0f;
-  save_fuel_consumption_data();
+  // The tank level is relative to the counter: rebase it so the level survives the reset
+  if (tank_.is_known()) {
+    tank_.rebase(total_fuel_mp_, injected_per_pulse_);
+    persist_(PersistRecord::TANK);
+  }
+  total_fuel_mp_ = 0;
+  persist_(PersistRecord::FUEL_BASE);
   
   if (total_consumption_sensor_) {
-    total_consumption_sensor_->publish_state(total_consumption_ml_);
+    publish_filtered_(total_consumption_sensor_, TelemetryChannel::TOTAL_CONSUMPTION, get_total_consumption(), true);
+  }
+}
+
+void SunsterHeater::start_fuel_calibration() {
+  pump_calibration_.mark();
+  persist_(PersistRecord::PUMP_CALIBRATION);
+  ESP_LOGI(TAG, "[CALIB] Started: run the heater%s, then enter the fuel used in ml",
+           calibrate_per_level_ ? " (one power level calibrates that level)" : "");
+}
+
+void SunsterHeater::finish_fuel_calibration(float measured_ml) {
+  float ml_per_pulse = injected_per_pulse_;
+  uint8_t level = 0;
+  uint64_t pulses = pump_calibration_.session_milli_pulses();
+  CalibrationResult result = pump_calibration_.apply(measured_ml, calibrate_per_level_, ml_per_pulse, level);
+  switch (result) {
+    case CalibrationResult::BASE:
+      ESP_LOGI(TAG, "[CALIB] %.1f ml over %.1f pulses: injected per pulse %.4f -> %.4f ml", measured_ml,
+               FuelCounter::to_pulses(pulses), injected_per_pulse_, ml_per_pulse);
+      injected_per_pulse_ = ml_per_pulse;
+      save_config_preferences();
+      if (injected_per_pulse_number_) injected_per_pulse_number_->publish_state(injected_per_pulse_);
+      break;
+    case CalibrationResult::LEVEL:
+      ESP_LOGI(TAG, "[CALIB] %.1f ml over %.1f pulses: level %u dose %.4f ml/pulse (factor %.3f)", measured_ml,
+               FuelCounter::to_pulses(pulses), (unsigned) level, injected_per_pulse_ * pump_calibration_.factor(level),
+               pump_calibration_.factor(level));
+      break;
+    default:
+      ESP_LOGW(TAG, "[CALIB] %.1f ml over %.1f pulses: %s", measured_ml, FuelCounter::to_pulses(pulses),
+               calibration_result_to_string(result));
+      return;
+  }
+  persist_(PersistRecord::PUMP_CALIBRATION);
+}
+
+void SunsterHeater::save_pump_calibration_() {
+  PumpCalibrationData data = pump_calibration_.data();
+  pref_pump_calibration_.save(&data);
+}
+
+void SunsterHeater::refill_tank() {
+  if (!(tank_.capacity_ml() > 0.0f)) {
+    ESP_LOGW(TAG, "Tank refill ignored: no tank_capacity configured");
+    return;
+  }
+  tank_.refill(total_fuel_mp_, injected_per_pulse_, -1.0f);
+  persist_(PersistRecord::TANK);
+  ESP_LOGI(TAG, "Tank refilled to %.2f L", tank_.data().fill_ml / 1000.0f);
+  publish_tank_();
+}
+
+void SunsterHeater::add_tank_fuel(float liters) {
+  tank_.refill(total_fuel_mp_, injected_per_pulse_, liters * 1000.0f);
+  persist_(PersistRecord::TANK);
+  ESP_LOGI(TAG, "Tank: %.2f L added, level %.2f L", liters, tank_.data().fill_ml / 1000.0f);
+  publish_tank_();
+}
+
+void SunsterHeater::save_history_() {
+  for (size_t i = 0; i < HistoryStore::HOUR_CHUNKS; i++) {
+    if (history_dirty_hours_ & (1u << i)) pref_history_hours_[i].save(history_.hour_chunk(i));
+  }
+  for (size_t i = 0; i < HistoryStore::DAY_CHUNKS; i++) {
+    if (history_dirty_days_ & (1u << i)) pref_history_days_[i].save(history_.day_chunk(i));
   }
+  history_dirty_hours_ = 0;
+  history_dirty_days_ = 0;
+}
+
+// Flash commits stall the loop for tens of ms: only between a heater reply and the next TX,
+// with no command waiting, and not right before a PI step
+bool SunsterHeater::persistence_window_open_(uint32_t now) const {
+  if (rx_parser_.in_frame() || tx_pending_()) return false;
+  if (now - last_send_time_ < PERSIST_TX_GUARD_MS) return false;
+  bool is_heating_or_active = heater_enabled_ || (current_state_ != HeaterState::OFF);
+  uint32_t send_interval = is_heating_or_active ? SEND_INTERVAL_MS : polling_interval_ms_;
+  if (!passive_sniff_mode_ && static_cast<int32_t>(last_send_time_ + send_interval - now) < (int32_t) PERSIST_TX_GUARD_MS) {
+    return false;
+  }
+  if (is_pi_mode() && static_cast<int32_t>(next_control_ms_ - now) < (int32_t) PERSIST_CONTROL_GUARD_MS) return false;
+  return true;
+}
+
+void SunsterHeater::service_persistence_() {
+  uint32_t now = millis();
+  if (persistence_.any_due(now) && persistence_window_open_(now)) {
+    commit_persistence_();
+  }
+}
+
+// Writes every dirty record and commits them to flash together
+void SunsterHeater::commit_persistence_() {
+  if (!persistence_.any_dirty()) return;
+  uint32_t start_us = micros();
+  uint8_t records = 0;
+  for (uint8_t i = 0; i < PERSIST_RECORD_COUNT; i++) {
+    PersistRecord record = static_cast<PersistRecord>(i);
+    if (!persistence_.is_dirty(record)) continue;
+    persistence_.clear(record);
+    records++;
+    switch (record) {
+      case PersistRecord::FUEL_BASE: save_fuel_consumption_data(); break;
+      case PersistRecord::FUEL_JOURNAL: write_fuel_journal_(); break;
+      case PersistRecord::CONFIG: save_config_data(); break;
+      case PersistRecord::TANK: save_tank_(); break;
+      case PersistRecord::PUMP_CALIBRATION: save_pump_calibration_(); break;
+      case PersistRecord::HISTORY: save_history_(); break;
+      default: break;
+    }
+    ESP_LOGV(TAG, "Persist %s", persist_record_to_string(record));
+  }
+  global_preferences->sync();
+  uint32_t duration_us = micros() - start_us;
+  persistence_.committed(records, duration_us);
+  ESP_LOGD(TAG, "Committed %u record%s to flash in %.1f ms", (unsigned) records, records == 1 ? "" : "s",
+           duration_us / 1000.0f);
+}
+
+void SunsterHeater::save_tank_() {
+  TankData data = tank_.data();
+  pref_tank_.save(&data);
+}
+
+void SunsterHeater::publish_tank_() {
+  uint32_t now = millis();
+  tank_.advance(now);
+  float remaining = get_tank_remaining();
+  publish_filtered_(tank_remaining_sensor_, TelemetryChannel::TANK_REMAINING,
+                    std::isnan(remaining) ? NAN : remaining / 1000.0f);
+  bool fuel_state = current_state_ == HeaterState::STABLE_COMBUSTION || current_state_ == HeaterState::HEATING_UP;
+  publish_filtered_(tank_runtime_sensor_, TelemetryChannel::TANK_RUNTIME,
+                    TankGauge::runtime_h(remaining, fuel_state ? get_instantaneous_consumption_rate() : 0.0f));
+  publish_filtered_(tank_runtime_average_sensor_, TelemetryChannel::TANK_RUNTIME_AVERAGE,
+                    TankGauge::runtime_h(remaining, tank_.average_ml_h(now, injected_per_pulse_)));
 }
 
 void SunsterHeater::check_voltage_safety() {
@@ -891,21 +1740,18 @@ void SunsterHeater::check_voltage_safety() {
     }
   }
   
-  // Update error state
+  // Update error state; transitions bypass min_interval
   if (voltage_error != low_voltage_error_) {
     low_voltage_error_ = voltage_error;
-    if (low_voltage_error_sensor_) {
-      low_voltage_error_sensor_->publish_state(low_voltage_error_);
-    }
+    publish_filtered_(low_voltage_error_sensor_, TelemetryChannel::LOW_VOLTAGE_ERROR, low_voltage_error_, true);
   } else if (!voltage_error && low_voltage_error_) {
     // Clear error if voltage has recovered
     low_voltage_error_ = false;
-    if (low_voltage_error_sensor_) {
-      low_voltage_error_sensor_->publish_state(false);
-    }
-  } else if (low_voltage_error_sensor_ && input_voltage_ > 0.0f && !voltage_error) {
+    publish_filtered_(low_voltage_error_sensor_, TelemetryChannel::LOW_VOLTAGE_ERROR, false, true);
+  } else if (input_voltage_ > 0.0f && !voltage_error) {
     // Publish "no error" when voltage is valid so the entity is not stuck as "unknown"
-    low_voltage_error_sensor_->publish_state(false);
+    // (first time, then on the heartbeat)
+    publish_filtered_(low_voltage_error_sensor_, TelemetryChannel::LOW_VOLTAGE_ERROR, false);
   }
 }
 
@@ -1012,8 +1858,49 @@ void SunsterHeater::handle_antifreeze_mode() {
 }
 
 void SunsterHeater::handle_automatic_mode() {
-  // Early validation: check sensor value before PI calculation
-  bool sensor_has_state = (external_temperature_sensor_ != nullptr && external_temperature_sensor_->has_state());
+  pi_step_ = nullptr;
+  automatic_mode_step_();
+  // Complete the step record with what the decision actually requested
+  if (pi_step_ != nullptr) {
+    pi_step_->power_percent = static_cast<uint8_t>(power_level_ * 10);
+    pi_step_->enabled = heater_enabled_;
+    // Cycle bookkeeping: automatic off periods and whether an idle bridged one
+    uint32_t now = pi_step_->time_ms;
+    PiDecision decision = pi_step_->decision;
+    if (decision != PiDecision::IDLE && cycle_tracker_.is_idling()) {
+      cycle_tracker_.end_idle(now, decision != PiDecision::TURN_OFF && decision != PiDecision::INACTIVE);
+    }
+    if (decision == PiDecision::TURN_OFF) {
+      cycle_tracker_.note_auto_stop(now);
+    } else if (decision == PiDecision::TURN_ON) {
+      cycle_tracker_.note_auto_start(now);
+    } else if (decision == PiDecision::INACTIVE) {
+      cycle_tracker_.cancel_off_period();
+    }
+    pi_step_ = nullptr;
+  }
+}
+
+PiStepRecord &SunsterHeater::record_pi_step_(PiDecision decision, float dt_s) {
+  PiStepRecord &rec = pi_telemetry_.push();
+  rec.time_ms = millis();
+  rec.dt_s = dt_s;
+  rec.target = target_temperature_;
+  rec.measured = external_temperature_;
+  rec.t_pred = rec.slope = rec.error = rec.p_term = rec.i_term = NAN;
+  rec.output = last_pi_output_;
+  rec.decision = decision;
+  rec.heater_state = static_cast<uint8_t>(current_state_);
+  rec.sample_age_ms = sample_age_ms_;
+  rec.jitter_ms = control_jitter_ms_;
+  pi_step_ = &rec;
+  return rec;
+}
+
+void SunsterHeater::automatic_mode_step_() {
+  // Early validation: check sensor value before PI calculation. A sensor that still reports but
+  // whose samples stopped arriving (or are all rejected) is lost as well.
+  bool sensor_has_state = external_sensor_online_() && !external_sample_stale_();
   bool sensor_has_valid_value = !std::isnan(external_temperature_) &&
                                 external_temperature_ >= -50.0f &&
                                 external_temperature_ <= 100.0f;
@@ -1021,51 +1908,49 @@ void SunsterHeater::handle_automatic_mode() {
   if (!sensor_has_valid_value) {
     if (sensor_has_state) {
       ESP_LOGW(TAG, "[PI] Invalid sensor value (%.1f°C), skipping PI calculation", external_temperature_);
-    }
-    last_pi_output_ = 0.0f;
-    if (pi_output_sensor_) pi_output_sensor_->publish_state(0.0f);
-    time_entered_off_region_ = 0;
-    if (!sensor_has_state && time_external_temp_lost_ == 0) {
+    } else if (time_external_temp_lost_ == 0) {
       time_external_temp_lost_ = millis();
       ESP_LOGW(TAG, "[PI] Sensor lost signal, starting %ds grace period", PI_SENSOR_GRACE_PERIOD_MS / 1000);
+    } else if (heater_enabled_ && millis() - time_external_temp_lost_ >= PI_SENSOR_GRACE_PERIOD_MS) {
+      // No sensor configured, or lost without a usable last value: nothing to hold, cannot operate
+      ESP_LOGW(TAG, "[PI] Sensor grace period expired (%ds), forcing shutdown", PI_SENSOR_GRACE_PERIOD_MS / 1000);
+      turn_off();
     }
+    last_pi_output_ = 0.0f;
+    publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, 0.0f);
+    time_entered_off_region_ = 0;
+    record_pi_step_(PiDecision::INACTIVE, NAN);
     return;
   }
-  
-  // If sensor lost signal, check grace period
-  if (!sensor_has_state && sensor_has_valid_value) {
+
+  // If sensor lost signal, check grace period (a valid last value exists from here on)
+  if (!sensor_has_state) {
     // Sensor lost signal but we have a last valid value - use grace period
     uint32_t now = millis();
     if (time_external_temp_lost_ == 0) {
       time_external_temp_lost_ = now;
-      ESP_LOGW(TAG, "[PI] Sensor lost signal, starting %ds grace period (using last valid temp=%.1f°C)", 
-               PI_SENSOR_GRACE_PERIOD_MS / 1000, external_temperature_);
-    } else {
-      uint32_t elapsed = now - time_external_temp_lost_;
-      if (elapsed >= PI_SENSOR_GRACE_PERIOD_MS) {
-        // Grace period expired - force shutdown
+      ESP_LOGW(TAG, "[PI] Sensor lost signal (last sample %us old), starting %ds grace period (holding output %.0f%%)",
+               (unsigned) (sample_age_ms_ / 1000), PI_SENSOR_GRACE_PERIOD_MS / 1000, last_pi_output_);
+    }
+    uint32_t elapsed = now - time_external_temp_lost_;
+    if (elapsed >= PI_SENSOR_GRACE_PERIOD_MS) {
+      // Grace period expired - force shutdown; stays off until a sample is accepted again
+      if (heater_enabled_ || last_pi_output_ != 0.0f) {
         ESP_LOGW(TAG, "[PI] Sensor grace period expired (%ds), forcing shutdown", PI_SENSOR_GRACE_PERIOD_MS / 1000);
-        if (heater_enabled_) {
-          turn_off();
-        }
-        last_pi_output_ = 0.0f;
-        if (pi_output_sensor_) pi_output_sensor_->publish_state(0.0f);
-        time_external_temp_lost_ = 0;
-        return;
-      } else {
-        // Still in grace period - continue with last valid temperature
-        ESP_LOGD(TAG, "[PI] Sensor offline, using last valid temp=%.1f°C (grace period: %ds remaining)", 
-                 external_temperature_, (PI_SENSOR_GRACE_PERIOD_MS - elapsed) / 1000);
       }
+      if (heater_enabled_) {
+        turn_off();
+      }
+      last_pi_output_ = 0.0f;
+      publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, 0.0f);
+    } else {
+      // Still in grace period - hold the output, integrator frozen (a held sample is no error signal)
+      ESP_LOGD(TAG, "[PI] Sensor offline, holding output %.0f%% (last temp=%.1f°C, grace period: %ds remaining)",
+               last_pi_output_, external_temperature_, (PI_SENSOR_GRACE_PERIOD_MS - elapsed) / 1000);
     }
-  } else if (!sensor_has_state && !sensor_has_valid_value) {
-    // No sensor configured or never had a valid reading - cannot operate
-    if (heater_enabled_) {
-      turn_off();
-    }
-    last_pi_output_ = 0.0f;
-    if (pi_output_sensor_) pi_output_sensor_->publish_state(0.0f);
-    time_external_temp_lost_ = 0;
+    time_entered_off_region_ = 0;
+    last_pi_time_ = 0;  // no dt spanning the outage once samples are back
+    record_pi_step_(PiDecision::INACTIVE, NAN);
     return;
   }
 
@@ -1075,16 +1960,18 @@ void SunsterHeater::handle_automatic_mode() {
       turn_off();
     }
     last_pi_output_ = 0.0f;
-    if (pi_output_sensor_) pi_output_sensor_->publish_state(0.0f);
+    publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, 0.0f);
     time_entered_off_region_ = 0;
+    record_pi_step_(PiDecision::INACTIVE, NAN);
     return;
   }
 
   // Cooldown: output 0%, no integral windup (only when not actively trying to start)
   if (current_state_ == HeaterState::STOPPING_COOLING && !heater_enabled_) {
     last_pi_output_ = 0.0f;
-    if (pi_output_sensor_) pi_output_sensor_->publish_state(0.0f);
+    publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, 0.0f);
     time_entered_off_region_ = 0;
+    record_pi_step_(PiDecision::COOLDOWN, NAN);
     ESP_LOGV(TAG, "[PI] target=%.1f measured=%.1f out=0.0 (state=Cooldown) no windup", target_temperature_, external_temperature_);
     return;
   }
@@ -1092,70 +1979,55 @@ void SunsterHeater::handle_automatic_mode() {
   if (current_state_ == HeaterState::POLLING_STATE || current_state_ == HeaterState::HEATING_UP) {
     const float preheat_output = 10.0f;
     last_pi_output_ = preheat_output;
-    if (pi_output_sensor_) pi_output_sensor_->publish_state(preheat_output);
+    publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, preheat_output);
     time_entered_off_region_ = 0;
+    record_pi_step_(PiDecision::PREHEAT, NAN);
     ESP_LOGV(TAG, "[PI] target=%.1f measured=%.1f out=%.0f (state=Preheat, min) no windup", target_temperature_, external_temperature_, preheat_output);
     return;
   }
 
   uint32_t now = millis();
 
-  // STABLE_COMBUSTION: slope warmup – reset slope at transition, hold 10% for slope_window, then reset integrator
+  // STABLE_COMBUSTION: slope warmup – hold 10% for slope_window while the slope follows the new heat output,
+  // then reset integrator
   if (current_state_ == HeaterState::STABLE_COMBUSTION && time_stable_combustion_entered_ != 0) {
     uint32_t stable_elapsed_ms = now - time_stable_combustion_entered_;
     uint32_t slope_warmup_ms = static_cast<uint32_t>(slope_window_s_ * 1000.0f);
 
     if (stable_elapsed_ms < slope_warmup_ms) {
-      // Warmup: hold 10%, update slope only (no PI output)
-      float dt_s = (last_pi_time_ != 0) ? (now - last_pi_time_) / 1000.0f : 5.0f;
-      if (dt_s <= 0.0f) dt_s = 5.0f;
+      // Warmup: hold 10%, publish slope only (no PI output)
+      float dt_s = (last_pi_time_ != 0) ? (now - last_pi_time_) / 1000.0f : control_period_ms_ / 1000.0f;
+      if (dt_s <= 0.0f) dt_s = control_period_ms_ / 1000.0f;
       last_pi_time_ = now;
-      bool prev_valid = !std::isnan(temp_prev_) && time_prev_ != 0;
-      if (prev_valid && dt_s > 0.0f) {
-        float slope_raw = (external_temperature_ - temp_prev_) / dt_s;
-        float alpha = dt_s / (slope_window_s_ + dt_s);
-        slope_filtered_ = alpha * slope_raw + (1.0f - alpha) * slope_filtered_;
-      }
-      temp_prev_ = external_temperature_;
-      time_prev_ = now;
+      float slope, t_pred;
+      update_prediction_(slope, t_pred);
       if (heater_enabled_) set_power_level_percent(10.0f);
       last_pi_output_ = 10.0f;
-      if (pi_output_sensor_) pi_output_sensor_->publish_state(10.0f);
-      if (predicted_temperature_sensor_) predicted_temperature_sensor_->publish_state(external_temperature_ + slope_filtered_ * t_lookahead_s_);
-      if (slope_sensor_) slope_sensor_->publish_state(slope_filtered_);
+      publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, 10.0f);
       time_entered_off_region_ = 0;
+      PiStepRecord &warmup = record_pi_step_(PiDecision::WARMUP, dt_s);
+      warmup.slope = slope;
+      warmup.t_pred = t_pred;
       ESP_LOGD(TAG, "[PI] Slope warmup %.0fs/%.0fs measured=%.2f slope=%.4f (holding 10%%)",
-               stable_elapsed_ms / 1000.0f, slope_window_s_, external_temperature_, slope_filtered_);
+               stable_elapsed_ms / 1000.0f, slope_window_s_, external_temperature_, slope);
       return;
     }
 
     if (!slope_warmup_done_) {
       slope_warmup_done_ = true;
       pi_integral_ = 0.0f;
-      ESP_LOGD(TAG, "[PI] Slope warmup complete, integrator reset, slope=%.4f", slope_filtered_);
+      ESP_LOGD(TAG, "[PI] Slope warmup complete, integrator reset, slope=%.4f", temperature_estimator_.rate());
     }
   }
 
-  float dt_s = (last_pi_time_ != 0) ? (now - last_pi_time_) / 1000.0f : 5.0f;
-  if (dt_s <= 0.0f) dt_s = 5.0f;
+  float dt_s = (last_pi_time_ != 0) ? (now - last_pi_time_) / 1000.0f : control_period_ms_ / 1000.0f;
+  if (dt_s <= 0.0f) dt_s = control_period_ms_ / 1000.0f;
   last_pi_time_ = now;
 
-  // Slope and prediction (always active, float throughout)
-  bool prev_valid = !std::isnan(temp_prev_) && time_prev_ != 0;
-  if (prev_valid && dt_s > 0.0f) {
-    float slope_raw = (external_temperature_ - temp_prev_) / dt_s;
-    float alpha = dt_s / (slope_window_s_ + dt_s);
-    slope_filtered_ = alpha * slope_raw + (1.0f - alpha) * slope_filtered_;
-  }
-  temp_prev_ = external_temperature_;
-  time_prev_ = now;
-
-  float t_pred = external_temperature_ + slope_filtered_ * t_lookahead_s_;
+  float slope, t_pred;
+  update_prediction_(slope, t_pred);
   float error = target_temperature_ - t_pred;
 
-  if (predicted_temperature_sensor_) predicted_temperature_sensor_->publish_state(t_pred);
-  if (slope_sensor_) slope_sensor_->publish_state(slope_filtered_);
-
   // Pure PI (no D), output ±100%; anti-windup
   float output_raw = std::max(-100.0f, std::min(100.0f, pi_kp_ * error + pi_integral_));
   if (!heater_enabled_ && output_raw < output_off_threshold_) {
@@ -1170,11 +2042,18 @@ void SunsterHeater::handle_automatic_mode() {
   }
   last_error_ = error;
   last_pi_output_ = output_raw;
-  if (pi_output_sensor_) pi_output_sensor_->publish_state(output_raw);
+  publish_filtered_(pi_output_sensor_, TelemetryChannel::PI_OUTPUT, output_raw);
+
+  PiStepRecord &step = record_pi_step_(PiDecision::HOLD, dt_s);
+  step.t_pred = t_pred;
+  step.slope = slope;
+  step.error = error;
+  step.p_term = pi_kp_ * error;
+  step.i_term = pi_integral_;
 
   bool target_below_measured = (target_temperature_ < external_temperature_);
   ESP_LOGV(TAG, "[PI] target=%.2f measured=%.2f T_pred=%.2f slope=%.4f err=%.2f out_raw=%.1f off_thr=%.0f on_thr=%.0f",
-           target_temperature_, external_temperature_, t_pred, slope_filtered_, error, output_raw,
+           target_temperature_, external_temperature_, t_pred, slope, error, output_raw,
            output_off_threshold_, output_on_threshold_);
 
   // Not STABLE_COMBUSTION: only check on-threshold (no delay)
@@ -1182,6 +2061,7 @@ void SunsterHeater::handle_automatic_mode() {
     time_entered_off_region_ = 0;
     if (!heater_enabled_ && output_raw > output_on_threshold_ && !target_below_measured) {
       turn_on();
+      step.decision = PiDecision::TURN_ON;
       time_entered_on_region_ = 0;
     } else if (time_entered_on_region_ != 0) {
       time_entered_on_region_ = 0;
@@ -1196,13 +2076,21 @@ void SunsterHeater::handle_automatic_mode() {
       uint32_t min_on_time_ms = static_cast<uint32_t>(pi_min_on_time_s_ * 1000.0f);
       if (stable_elapsed < min_on_time_ms) {
         set_power_level_percent(10.0f);
+        step.decision = PiDecision::MIN_LEVEL;
         return;
       }
       if (!allow_auto_stop_) {
         set_power_level_percent(10.0f);
+        step.decision = PiDecision::MIN_LEVEL;
+        return;
+      }
+      if (idle_instead_of_stop_(now)) {
+        set_power_level_percent(10.0f);
+        step.decision = PiDecision::IDLE;
         return;
       }
       turn_off();
+      step.decision = PiDecision::TURN_OFF;
     }
     time_entered_off_region_ = 0;
     return;
@@ -1212,22 +2100,138 @@ void SunsterHeater::handle_automatic_mode() {
   time_entered_on_region_ = 0;
 
   if (output_raw > output_on_threshold_) {
-    if (!heater_enabled_ && !target_below_measured) turn_on();
+    if (!heater_enabled_ && !target_below_measured && turn_on()) step.decision = PiDecision::TURN_ON;
     if (heater_enabled_) {
+      if (step.decision == PiDecision::HOLD) step.decision = PiDecision::SET_LEVEL;
       float pct = (output_raw <= 10.0f) ? 10.0f
                   : static_cast<float>((static_cast<int>(output_raw / 10.0f + 0.5f)) * 10);
       pct = std::max(10.0f, std::min(100.0f, pct));
+      if (economy_level_(t_pred, pct)) step.decision = PiDecision::ECONOMY;
       set_power_level_percent(pct);
     }
   } else {
     // Between off_threshold and on_threshold: hold state, if on use min power
-    if (heater_enabled_) set_power_level_percent(10.0f);
+    if (heater_enabled_) {
+      float pct = 10.0f;
+      step.decision = economy_level_(t_pred, pct) ? PiDecision::ECONOMY : PiDecision::MIN_LEVEL;
+      set_power_level_percent(pct);
+    }
   }
 }
 
+void SunsterHeater::start_autotune_() {
+  AutotuneConfig config;
+  config.slope_window_s = slope_window_s_;
+  config.max_temperature_c = target_temperature_ + AUTOTUNE_CEILING_MARGIN;
+  autotuner_.start(millis(), config);
+  autotune_logged_phase_ = autotuner_.phase();
+  ESP_LOGI(TAG, "[AUTOTUNE] Started: %.0f%% for %.0fs baseline, then %.0f%% step (ends at %.1f°C), measured=%.1f°C",
+           config.low_percent, config.baseline_s, config.high_percent, config.max_temperature_c, external_temperature_);
+  if (external_temperature_ > config.max_temperature_c - 2.0f * AUTOTUNE_CEILING_MARGIN) {
+    ESP_LOGW(TAG, "[AUTOTUNE] Cabin is close to the target; the step may end before the response is measurable");
+  }
+  if (!heater_enabled_ && !turn_on()) {
+    autotuner_.abort("start refused");
+    finish_autotune_();
+    return;
+  }
+  set_power_level_percent(autotuner_.requested_percent());
+}
+
+// Runs on each new external temperature sample while in AUTOTUNE
+void SunsterHeater::handle_autotune_() {
+  if (!autotuner_.is_running())
+    return;
+  uint32_t now = millis();
+  AutotunePhase phase = autotuner_.update(now, external_temperature_, current_state_ == HeaterState::STABLE_COMBUSTION);
+  if (autotuner_.is_running()) {
+    if (phase != autotune_logged_phase_) {
+      ESP_LOGI(TAG, "[AUTOTUNE] %s -> %s at %.1f°C, holding %.0f%%", autotune_phase_to_string(autotune_logged_phase_),
+               autotune_phase_to_string(phase), external_temperature_, autotuner_.requested_percent());
+      autotune_logged_phase_ = phase;
+    }
+    if (heater_enabled_)
+      set_power_level_percent(autotuner_.requested_percent());
+    ESP_LOGV(TAG, "[AUTOTUNE] %s %.0fs measured=%.2f", autotune_phase_to_string(phase), autotuner_.phase_elapsed_s(now),
+             external_temperature_);
+    return;
+  }
+  finish_autotune_();
+}
+
+// Called from update(): abort on sensor loss, low voltage or when the heater was switched off, and
+// enforce the experiment's time limits, which the sample-driven update() cannot while samples are missing
+void SunsterHeater::check_autotune_safety_() {
+  if (!autotuner_.is_running())
+    return;
+  const char *reason = nullptr;
+  bool sensor_ok = external_temperature_sensor_ != nullptr && external_temperature_sensor_->has_state() &&
+                   has_external_sensor() && time_external_temp_lost_ == 0;
+  if (!sensor_ok) {
+    reason = "external temperature sensor lost";
+  } else if (low_voltage_error_ || (input_voltage_ > 0.0f && input_voltage_ < min_voltage_operate_)) {
+    reason = "low voltage";
+  } else if (!heater_enabled_) {
+    reason = "heater switched off";
+  }
+  if (reason != nullptr) {
+    autotuner_.abort(reason);
+    finish_autotune_();
+    return;
+  }
+  autotuner_.check_timeouts(millis());
+  if (!autotuner_.is_running()) {
+    finish_autotune_();
+  }
+}
+
+void SunsterHeater::finish_autotune_() {
+  if (autotuner_.phase() == AutotunePhase::DONE) {
+    const AutotuneResult &r = autotuner_.result();
+    ESP_LOGI(TAG, "[AUTOTUNE] Plant gain %.3g °C/s per %%, dead time %.0fs (slope %.4f -> %.4f °C/s)", r.plant_gain,
+             r.dead_time_s, r.baseline_slope, r.max_slope);
+    // Clamp to the ranges accepted from YAML
+    pi_kp_ = std::max(0.1f, std::min(50.0f, r.kp));
+    pi_ki_ = std::max(0.0f, std::min(5.0f, r.ki));
+    t_lookahead_s_ = std::max(30.0f, std::min(300.0f, r.t_lookahead_s));
+    ESP_LOGI(TAG, "[AUTOTUNE] Applied Kp=%.2f Ki=%.4f t_lookahead=%.0fs (computed Kp=%.2f Ki=%.4f)", pi_kp_, pi_ki_,
+             t_lookahead_s_, r.kp, r.ki);
+    persist_(PersistRecord::CONFIG);
+    autotuner_.reset();
+    // Heater is running: the new PI takes over
+    set_control_mode(ControlMode::AUTOMATIC);
+  } else {
+    ESP_LOGW(TAG, "[AUTOTUNE] Aborted during %s: %s - PI parameters unchanged, heater off",
+             autotune_phase_to_string(autotune_logged_phase_), autotuner_.failure_reason());
+    turn_off();
+    automatic_master_enabled_ = false;  // stay off until the user starts the heater again
+    autotuner_.reset();
+    set_control_mode(autotune_return_mode_);
+  }
+  publish_all_config_entities_();
+}
+
+// Slope and T_pred from the Kalman estimate (filtered temperature, not the last raw sample)
+void SunsterHeater::update_prediction_(float &slope, float &t_pred) {
+  if (temperature_estimator_.is_initialized()) {
+    slope = temperature_estimator_.rate();
+    t_pred = temperature_estimator_.predict(t_lookahead_s_);
+  } else {
+    slope = 0.0f;
+    t_pred = external_temperature_;
+  }
+  publish_filtered_(predicted_temperature_sensor_, TelemetryChannel::PREDICTED_TEMPERATURE, t_pred);
+  publish_filtered_(slope_sensor_, TelemetryChannel::SLOPE, slope);
+}
+
 void SunsterHeater::handle_communication_timeout() {
   static uint32_t last_timeout_log = 0;
   uint32_t now = millis();
+
+  if (!comm_timeout_active_) {
+    comm_timeout_active_ = true;
+    link_stats_.comm_timeouts++;
+  }
   
   if (now - last_timeout_log > 10000) {  // Log every 10 seconds
     ESP_LOGW(TAG, "Communication timeout - heater not responding");
@@ -1236,10 +2240,10 @@ void SunsterHeater::handle_communication_timeout() {
   
   // Reset sensors to unknown state
   if (state_sensor_) {
-    state_sensor_->publish_state("Disconnected");
+    publish_filtered_(state_sensor_, TelemetryChannel::STATE, "Disconnected");
   }
   if (glow_plug_status_sensor_) {
-    glow_plug_status_sensor_->publish_state("Unknown");
+    publish_filtered_(glow_plug_status_sensor_, TelemetryChannel::GLOW_PLUG_STATUS, "Unknown");
   }
 }
 
@@ -1255,29 +2259,23 @@ const char* SunsterHeater::state_to_string(HeaterState state) {
   }
 }
 
-uint16_t SunsterHeater::read_uint16_be(const std::vector<uint8_t> &data, size_t offset) {
-  if (offset + 1 >= data.size()) {
-    return 0;
-  }
-  return (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1];
-}
-
-float SunsterHeater::parse_temperature(const std::vector<uint8_t> &data, size_t offset) {
-  uint16_t raw = read_uint16_be(data, offset);
-  return raw / 100.0f;
-}
-
-float SunsterHeater::parse_voltage(const std::vector<uint8_t> &data, size_t offset) {
-  if (offset >= data.size()) {
-    return 0.0f;
-  }
-  return data[offset] / 10.0f;
-}
-
 // Public control methods
 void SunsterHeater::set_control_mode(ControlMode mode) {
+  if (mode == ControlMode::AUTOTUNE && control_mode_ != ControlMode::AUTOTUNE) {
+    if (!has_external_sensor()) {
+      ESP_LOGE(TAG, "Cannot start autotune: no valid external temperature reading");
+      return;
+    }
+    autotune_return_mode_ = control_mode_;
+  }
   ControlMode old_mode = control_mode_;
   control_mode_ = mode;
+
+  // Leaving autotune before it finished: drop the experiment, the new mode takes over the heater
+  if (old_mode == ControlMode::AUTOTUNE && mode != ControlMode::AUTOTUNE && autotuner_.is_running()) {
+    ESP_LOGW(TAG, "[AUTOTUNE] Cancelled by mode change, PI parameters unchanged");
+    autotuner_.reset();
+  }
   
   // When leaving antifreeze mode, turn off heater if it was active in antifreeze
   if (old_mode == ControlMode::ANTIFREEZE && antifreeze_active_) {
@@ -1285,24 +2283,32 @@ void SunsterHeater::set_control_mode(ControlMode mode) {
     turn_off();
     antifreeze_active_ = false;
   }
-  // When entering automatic mode, reset PI and prediction state for fresh start
-  if (mode == ControlMode::AUTOMATIC) {
+  // When entering a PI mode, reset PI state for fresh start (the estimator keeps tracking);
+  // switching between AUTOMATIC and ECONOMY keeps the integrator
+  bool old_pi_mode = old_mode == ControlMode::AUTOMATIC || old_mode == ControlMode::ECONOMY;
+  if (is_pi_mode() && !(old_pi_mode && mode != old_mode)) {
     pi_integral_ = 0.0f;
     last_pi_time_ = 0;
-    temp_prev_ = NAN;
-    time_prev_ = 0;
-    slope_filtered_ = 0.0f;
   }
   if (mode == ControlMode::FAN_ONLY) {
     ESP_LOGI(TAG, "FAN_ONLY mode selected - sending ventilation command (0x14)");
   }
+  if (mode == ControlMode::AUTOTUNE && old_mode != ControlMode::AUTOTUNE) {
+    start_autotune_();
+  }
+  if (mode != old_mode) {
+    // Automatic off periods and idles do not carry over into another mode
+    cycle_tracker_.cancel_off_period();
+    cycle_tracker_.end_idle(millis(), false);
+    request_tx_();
+  }
 
   ESP_LOGI(TAG, "Control mode changed from %d to %d", (int)old_mode, (int)mode);
 }
 
 bool SunsterHeater::turn_on() {
   // Check if automatic mode requires external sensor
-  if (control_mode_ == ControlMode::AUTOMATIC) {
+  if (is_pi_mode()) {
     if (!has_external_sensor()) {
       ESP_LOGE(TAG, "Cannot turn on heater: automatic mode requires external temperature sensor!");
       return false;
@@ -1322,13 +2328,12 @@ bool SunsterHeater::turn_on() {
     ESP_LOGW(TAG, "Cannot start heater: voltage too low (%.1fV < %.1fV)",
              input_voltage_, min_voltage_start_);
     low_voltage_error_ = true;
-    if (low_voltage_error_sensor_) {
-      low_voltage_error_sensor_->publish_state(true);
-    }
+    publish_filtered_(low_voltage_error_sensor_, TelemetryChannel::LOW_VOLTAGE_ERROR, true, true);
     return false;
   }
   
   heater_enabled_ = true;
+  request_tx_();
   automatic_master_enabled_ = true;   // User requested start – allow PI to keep running (no power_switch needed)
   last_start_request_time_ = millis();  // Grace period starts now – avoids sync-to-OFF before start frame is sent
   // Set to default power level on turn on
@@ -1338,6 +2343,7 @@ bool SunsterHeater::turn_on() {
 }
 
 void SunsterHeater::turn_off() {
+  if (heater_enabled_) request_tx_();
   heater_enabled_ = false;
   // Do not set power_level_ to 0 so restart in automatic mode works (set on turn_on())
   ESP_LOGI(TAG, "Heater turned OFF (power_level remains %d = %.0f%%)", power_level_, power_level_ * 10.0f);
@@ -1347,6 +2353,7 @@ void SunsterHeater::set_power_level_percent(float percent) {
   uint8_t level = static_cast<uint8_t>(std::max(1.0f, std::min(10.0f, percent / 10.0f)));
   if (level != power_level_) {
     power_level_ = level;
+    request_tx_();
     ESP_LOGI(TAG, "Heater power level set to %d (%.0f%%)", level, percent);
   }
 }
@@ -1357,17 +2364,131 @@ void SunsterHeater::dump_config() {
   ESP_LOGCONFIG(TAG, "  Control Mode: %s",
                 control_mode_ == ControlMode::AUTOMATIC ? "Automatic (PI)" :
                 control_mode_ == ControlMode::ANTIFREEZE ? "Antifreeze" :
-                control_mode_ == ControlMode::FAN_ONLY ? "Fan Only (stub)" : "Manual");
-  if (control_mode_ == ControlMode::AUTOMATIC) {
+                control_mode_ == ControlMode::FAN_ONLY ? "Fan Only (stub)" :
+                control_mode_ == ControlMode::AUTOTUNE ? "Autotune" :
+                control_mode_ == ControlMode::ECONOMY ? "Economy (PI)" : "Manual");
+  if (control_mode_ == ControlMode::AUTOTUNE) {
+    ESP_LOGCONFIG(TAG, "  Autotune Phase: %s", autotune_phase_to_string(autotuner_.phase()));
+  }
+  if (is_pi_mode()) {
     ESP_LOGCONFIG(TAG, "  PI: Kp=%.2f Ki=%.2f, thresholds off<%.0f%% on>%.0f%%, lookahead=%.0fs",
                   pi_kp_, pi_ki_, output_off_threshold_, output_on_threshold_, t_lookahead_s_);
   }
+  ESP_LOGCONFIG(TAG, "  Control: period=%u ms, %u steps, jitter avg=%.1f ms max=%u ms, %u overruns, sample age max=%.1f s",
+                (unsigned) control_period_ms_, (unsigned) control_steps_,
+                control_steps_ > 0 ? control_jitter_sum_ms_ / static_cast<float>(control_steps_) : 0.0f,
+                (unsigned) control_jitter_max_ms_, (unsigned) control_overruns_, sample_age_max_ms_ / 1000.0f);
+  ESP_LOGCONFIG(TAG, "  PI Telemetry: %u steps (%.1f min at the control period), %u recorded",
+                (unsigned) pi_telemetry_.capacity(), pi_telemetry_.capacity() * control_period_ms_ / 60000.0f,
+                (unsigned) pi_telemetry_.next_seq());
+  ESP_LOGCONFIG(TAG, "  Economy: band=±%.1f°C, held %.0f min, saved %.1f ml vs. PI", economy_band_,
+                economy_hold_s_ / 60.0f, economy_savings_ml_);
+  for (uint8_t level = 0; level <= EconomyModel::LEVELS; level++) {
+    if (economy_model_.weight_s(level) <= 0.0f) continue;
+    ESP_LOGCONFIG(TAG, "    Level %2u: slope=%+.2f°C/h fuel=%.0f ml/h heat/ml=%.3f°C (%.0f min%s)", level,
+                  economy_model_.slope(level) * 3600.0f, economy_model_.fuel_ml_s(level) * 3600.0f,
+                  economy_model_.heat_per_ml(level), economy_model_.weight_s(level) / 60.0f,
+                  economy_model_.is_learned(level) ? "" : ", learning");
+  }
+  const CycleCost &cycle_avg = cycle_tracker_.average();
+  ESP_LOGCONFIG(TAG, "  Cycle-aware stop: %s, penalty %.1f ml; %u starts (%u failed), %u stops", YESNO(cycle_aware_stop_),
+                cycle_penalty_ml_, (unsigned) cycle_tracker_.starts(), (unsigned) cycle_tracker_.failed_starts(),
+                (unsigned) cycle_tracker_.stops());
+  if (cycle_tracker_.has_cost()) {
+    ESP_LOGCONFIG(TAG, "    Start avg: %.1f ml, %.0fs, glow plug %.2f Wh, voltage sag %.2f V; stop avg: %.1f ml, %.0fs",
+                  cycle_avg.start_fuel_ml, cycle_avg.start_s, cycle_avg.glow_wh, cycle_avg.voltage_sag_v,
+                  cycle_avg.stop_fuel_ml, cycle_avg.stop_s);
+    ESP_LOGCONFIG(TAG, "    Cycle %.1f ml, idle %.0f ml/h, break-even %.0fs, off period avg %.0fs (%u)",
+                  cycle_tracker_.cycle_cost_ml(cycle_penalty_ml_), idle_fuel_rate_() * 3600.0f,
+                  cycle_tracker_.break_even_s(idle_fuel_rate_(), cycle_penalty_ml_), cycle_tracker_.average_off_s(),
+                  (unsigned) cycle_tracker_.off_periods());
+  }
+  ESP_LOGCONFIG(TAG, "    Decisions: %u stop, %u idle (%u bridged, %.0f min at 10%%)",
+                (unsigned) cycle_tracker_.stop_decisions(), (unsigned) cycle_tracker_.idle_decisions(),
+                (unsigned) cycle_tracker_.idle_bridged(), cycle_tracker_.idle_s() / 60.0f);
+  ESP_LOGCONFIG(TAG, "  Temperature Estimator: noise=%.3f°C response=%.0fs sample interval=%.1fs",
+                temperature_noise_, slope_window_s_, temperature_estimator_.sample_interval_s());
   ESP_LOGCONFIG(TAG, "  Default Power Level: %.0f%%", default_power_percent_);
   ESP_LOGCONFIG(TAG, "  Power Level: %d/10", power_level_);
   ESP_LOGCONFIG(TAG, "  Target Temperature: %.1f°C", target_temperature_);
   ESP_LOGCONFIG(TAG, "  Injected per Pulse: %.2f ml", injected_per_pulse_);
-  ESP_LOGCONFIG(TAG, "  Daily Consumption: %.2f ml", daily_consumption_ml_);
-  ESP_LOGCONFIG(TAG, "  Total Fuel Pulses: %.1f", total_fuel_pulses_);
+  ESP_LOGCONFIG(TAG, "  Pump Calibration: per level %s", YESNO(calibrate_per_level_));
+  for (uint8_t level = 1; level <= PumpCalibration::LEVELS; level++) {
+    if (pump_calibration_.factor(level) != 1.0f) {
+      ESP_LOGCONFIG(TAG, "    Level %u: %.4f ml/pulse (factor %.3f)", (unsigned) level,
+                    injected_per_pulse_ * pump_calibration_.factor(level), pump_calibration_.factor(level));
+    }
+  }
+  if (pump_calibration_.is_active()) {
+    ESP_LOGCONFIG(TAG, "    Session running: %.1f pulses since the mark",
+                  FuelCounter::to_pulses(pump_calibration_.session_milli_pulses()));
+  }
+  ESP_LOGCONFIG(TAG, "  Config store: %u parameters, %u record writes since boot", (unsigned) config_store_.size(),
+                (unsigned) config_record_writes_);
+  ESP_LOGCONFIG(TAG, "  Persistence: %u commits, %u records, last %.1f ms, max %.1f ms, %u brownout flushes",
+                (unsigned) persistence_.commits(), (unsigned) persistence_.records(),
+                persistence_.last_commit_us() / 1000.0f, persistence_.max_commit_us() / 1000.0f,
+                (unsigned) persistence_.brownout_flushes());
+  ESP_LOGCONFIG(TAG, "  Daily Consumption: %.2f ml", get_daily_consumption());
+  ESP_LOGCONFIG(TAG, "  Total Fuel Pulses: %.3f (max gap %ums, %u gaps clamped)", FuelCounter::to_pulses(total_fuel_mp_),
+                (unsigned) fuel_max_gap_ms_, (unsigned) fuel_gaps_clamped_);
+  ESP_LOGCONFIG(TAG, "  Fuel Journal: %u slots, seq %u (base %u), %u records + %u base writes (%.1f/h), %u replayed",
+                (unsigned) FuelJournal::SLOTS, (unsigned) fuel_journal_.last_seq(), (unsigned) fuel_journal_.base_seq(),
+                (unsigned) fuel_record_writes_, (unsigned) fuel_base_writes_, flash_writes_per_hour_(),
+                (unsigned) fuel_journal_.replayed());
+  if (simulator_ != nullptr) {
+    const SimConfig &c = simulator_->config();
+    ESP_LOGCONFIG(TAG, "  SIMULATION: ambient=%.1f°C heater=%.0fW loss=%.0fW/K mass=%.0fkJ/K sensor_lag=%.0fs",
+                  c.ambient_c, c.heater_power_w, c.heat_loss_w_per_k, c.thermal_mass_j_per_k / 1000.0f, c.sensor_lag_s);
+  }
+  ESP_LOGCONFIG(TAG, "  Strict Checksum: %s", YESNO(strict_checksum_));
+  ESP_LOGCONFIG(TAG, "  Frame Trace: %s (%u/%u records, %u overwritten)", YESNO(frame_trace_ || passive_sniff_mode_),
+                (unsigned) trace_.size(), (unsigned) trace_.capacity(), (unsigned) trace_.overwritten());
+#ifdef SUNSTER_HEATER_FRAME_LAYOUT_PINNED
+  ESP_LOGCONFIG(TAG, "  Frame Layouts (pinned):");
+#else
+  ESP_LOGCONFIG(TAG, "  Frame Layouts:");
+#endif
+  for (const auto &layout : FRAME_LAYOUTS) {
+    ESP_LOGCONFIG(TAG, "    %s (id=0x%02X len=0x%02X, %u bytes)", layout.name, layout.device_id, layout.length_byte,
+                  (unsigned) layout.size);
+  }
+  if (unknown_layout_frames_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Unknown Layout Frames: %u (%u distinct, %u of further layouts suppressed)",
+                  (unsigned) unknown_layout_frames_, (unsigned) unknown_layouts_seen_count_,
+                  (unsigned) unknown_layout_suppressed_frames_);
+  }
+  ESP_LOGCONFIG(TAG, "  Min TX Gap: %u ms", (unsigned) min_tx_gap_ms_);
+  if (capture_.capacity() > 0) {
+    ESP_LOGCONFIG(TAG, "  Capture: %u/%u bytes, %u records (%u evicted)", (unsigned) capture_.used(),
+                  (unsigned) capture_.capacity(), (unsigned) capture_.records(), (unsigned) capture_.evicted());
+  }
+  ESP_LOGCONFIG(TAG, "  Telemetry Publishes: %u emitted, %u suppressed", (unsigned) publishes_emitted_,
+                (unsigned) publishes_suppressed_);
+  if (command_latency_count_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Command Latency: last=%u ms avg=%.0f ms max=%u ms (%u commands)",
+                  (unsigned) last_command_latency_ms_, command_latency_sum_ms_ / static_cast<float>(command_latency_count_),
+                  (unsigned) max_command_latency_ms_, (unsigned) command_latency_count_);
+  }
+  if (rx_latency_count_ > 0) {
+    ESP_LOGCONFIG(TAG, "  RX Latency (last byte -> decoded): last=%.1f ms avg=%.1f ms max=%.1f ms (%u frames)",
+                  rx_latency_last_us_ / 1000.0f, rx_latency_sum_us_ / rx_latency_count_ / 1000.0f,
+                  rx_latency_max_us_ / 1000.0f, (unsigned) rx_latency_count_);
+  }
+  ESP_LOGCONFIG(TAG, "  Link: TX=%u RX=%u checksum_fail=%u echo=%u resync=%u oversize=%u partial_timeout=%u comm_timeout=%u",
+                (unsigned) link_stats_.tx_frames, (unsigned) link_stats_.rx_frames,
+                (unsigned) link_stats_.checksum_failures, (unsigned) link_stats_.echo_frames,
+                (unsigned) link_stats_.resyncs, (unsigned) link_stats_.oversize_resets,
+                (unsigned) link_stats_.partial_timeouts, (unsigned) link_stats_.comm_timeouts);
+  if (link_stats_.rtt.count() > 0) {
+    ESP_LOGCONFIG(TAG, "  Link RTT (TX -> heater frame): min=%u ms avg=%.0f ms p95=%u ms max=%u ms (%u samples)",
+                  (unsigned) link_stats_.rtt.min(), link_stats_.rtt.avg(), (unsigned) link_stats_.rtt.percentile(95),
+                  (unsigned) link_stats_.rtt.max(), (unsigned) link_stats_.rtt.count());
+  }
+  if (rx_drain_us_ > 0) {
+    ESP_LOGCONFIG(TAG, "  RX Drain: %u bytes in %u us (%.2f bytes/us, parse and frame handling)",
+                  (unsigned) rx_drain_bytes_, (unsigned) rx_drain_us_, rx_drain_bytes_ / static_cast<float>(rx_drain_us_));
+  }
   
   if (external_temperature_sensor_ != nullptr) {
     ESP_LOGCONFIG(TAG, "  External Temperature Sensor: Configured");
@@ -1378,7 +2499,7 @@ void SunsterHeater::dump_config() {
     }
   } else {
     ESP_LOGCONFIG(TAG, "  External Temperature Sensor: Not configured");
-    if (control_mode_ == ControlMode::AUTOMATIC) {
+    if (is_pi_mode()) {
       ESP_LOGW(TAG, "  WARNING: Automatic mode requires external temperature sensor!");
     }
   }
@@ -1397,6 +2518,33 @@ void SunsterHeater::dump_config() {
   LOG_SENSOR("  ", "Daily Consumption", daily_consumption_sensor_);
   LOG_SENSOR("  ", "Total Consumption", total_consumption_sensor_);
   LOG_BINARY_SENSOR("  ", "Low Voltage Error", low_voltage_error_sensor_);
+  LOG_SENSOR("  ", "Command Latency", command_latency_sensor_);
+  LOG_SENSOR("  ", "Publishes Emitted", publishes_emitted_sensor_);
+  LOG_SENSOR("  ", "Publishes Suppressed", publishes_suppressed_sensor_);
+  LOG_SENSOR("  ", "Control Jitter", control_jitter_sensor_);
+  LOG_SENSOR("  ", "Sample Age", sample_age_sensor_);
+  LOG_SENSOR("  ", "Economy Savings", economy_savings_sensor_);
+  LOG_SENSOR("  ", "Flash Write Rate", flash_write_rate_sensor_);
+  LOG_SENSOR("  ", "Cycle Cost", cycle_cost_sensor_);
+  LOG_SENSOR("  ", "Cycle Voltage Sag", cycle_voltage_sag_sensor_);
+  LOG_SENSOR("  ", "Start-Stop Cycles", start_stop_cycles_sensor_);
+  LOG_SENSOR("  ", "Idle Decisions", idle_decisions_sensor_);
+  LOG_TEXT_SENSOR("  ", "History", history_sensor_);
+  if (tank_.capacity_ml() > 0.0f) {
+    ESP_LOGCONFIG(TAG, "  Tank: capacity %.1f L, remaining %.2f L, 24 h average %.1f ml/h",
+                  tank_.capacity_ml() / 1000.0f, get_tank_remaining() / 1000.0f,
+                  tank_.average_ml_h(millis(), injected_per_pulse_));
+  }
+  LOG_SENSOR("  ", "Tank Remaining", tank_remaining_sensor_);
+  LOG_SENSOR("  ", "Tank Runtime", tank_runtime_sensor_);
+  LOG_SENSOR("  ", "Tank Runtime Average", tank_runtime_average_sensor_);
+  if (history_.open_hour() != 0) {
+    ESP_LOGCONFIG(TAG, "  History: %u hourly / %u daily buckets, open hour %u", (unsigned) HistoryStore::HOURS,
+                  (unsigned) HistoryStore::DAYS, (unsigned) history_.open_hour());
+  }
+  for (uint8_t i = 0; i < LINK_STAT_COUNT; i++) {
+    LOG_SENSOR("  ", LINK_STAT_NAMES[i], link_stat_sensors_[i]);
+  }
 }
 
 }  // namespace sunster_heater
@@ -13,8 +13,26 @@
 #include "esphome/components/select/select.h"
 #include "esphome/components/switch/switch.h"
 #include "esphome/core/preferences.h"
+#include "autotune.h"
+#include "capture.h"
+#include "cycle_cost.h"
+#include "economy_model.h"
+#include "frame_trace.h"
+#include "fuel_counter.h"
+#include "fuel_journal.h"
+#include "heater_frame.h"
+#include "heater_sim.h"
+#include "history_store.h"
+#include "config_store.h"
+#include "pump_calibration.h"
+#include "tank_gauge.h"
+#include "link_stats.h"
+#include "persistence.h"
+#include "pi_telemetry.h"
+#include "publish_filter.h"
+#include "temperature_estimator.h"
 #include <cmath>
-#include <vector>
+#include <memory>
 
 namespace esphome {
 
@@ -33,7 +51,9 @@ enum class ControlMode : uint8_t {
   MANUAL = 0,
   AUTOMATIC = 1,
   ANTIFREEZE = 2,
-  FAN_ONLY = 3
+  FAN_ONLY = 3,
+  AUTOTUNE = 4,  // PI step-response identification, returns to AUTOMATIC when done
+  ECONOMY = 5    // AUTOMATIC, holding the target with the cheapest learned power levels
 };
 
 // Heater states from protocol analysis
@@ -54,24 +74,47 @@ enum class ControllerState : uint8_t {
   CMD_RUNNING = 0x08
 };
 
-// Communication constants
-static const uint8_t FRAME_START = 0xAA;
-static const uint8_t CONTROLLER_ID = 0x66;
-static const uint8_t HEATER_ID = 0x77;
-static const uint8_t CONTROLLER_FRAME_LENGTH = 0x0B;
-static const uint8_t HEATER_FRAME_LENGTH = 0x34;  // 0x34 for newer firmware (57 bytes)
+// Timing constants (frame layout constants live in heater_frame.h)
 static const uint32_t COMMUNICATION_TIMEOUT_MS = 5000;
 static const uint32_t SEND_INTERVAL_MS = 1000;
+static const uint32_t RX_BYTES_PER_LOOP = 128;    // Max UART bytes drained per loop() iteration
+static const uint32_t RX_TIME_BUDGET_US = 2000;   // Max time spent draining per loop() iteration
+static const uint32_t DEFAULT_MIN_TX_GAP_MS = 200;  // 16-byte TX + 57-byte reply at 4800 baud ~ 150 ms
+static const uint32_t DIAGNOSTICS_INTERVAL_MS = 60000;  // Publish cadence of diagnostic counters
+static const uint8_t MAX_UNKNOWN_LAYOUTS = 8;  // Distinct unknown frame signatures remembered for log-once
+static const size_t CAPTURE_DUMP_CHUNK = 48;          // Raw bytes per base64 log line (64 chars)
+static const uint8_t CAPTURE_DUMP_LINES_PER_LOOP = 2;  // Spread the dump over loop() calls
+static const size_t TRACE_RING_SIZE = 16;              // Frame trace records kept in RAM (~72 bytes each)
+static const size_t DEFAULT_PI_TELEMETRY_SIZE = 64;    // PI step records kept in RAM (~52 bytes each)
+static const uint8_t PI_EXPORT_LINES_PER_LOOP = 4;     // CSV lines logged per loop() during export
+static const uint8_t HISTORY_DUMP_LINES_PER_LOOP = 4;  // history buckets logged per loop() during a dump
+static const uint32_t PERSIST_TX_GUARD_MS = 150;       // no flash commit this close to a TX (reply on the bus)
+static const uint32_t PERSIST_CONTROL_GUARD_MS = 200;  // nor this close before a PI step
+static const uint32_t DEFAULT_CONTROL_PERIOD_MS = 5000;   // Fixed PI step period
 static const uint32_t DEFAULT_POLLING_INTERVAL_MS = 300000; // 1 minute when not heating
 
-// Fuel consumption tracking structure for persistence
+static const uint32_t DEFAULT_FUEL_MAX_GAP_MS = 5000;  // longer frame gaps are integrated as this
+static const uint32_t FUEL_JOURNAL_MIN_DELTA_MP = 50000;    // append a record after 50 pulses (~1 ml)...
+static const uint32_t FUEL_JOURNAL_MAX_AGE_MS = 300000;     // ...or 5 min, whichever comes first
+
+// Fuel consumption tracking structure for persistence (v1, float counters; migrated on load)
 struct FuelConsumptionData {
   float daily_consumption_ml;
   uint32_t last_reset_day;
-  float total_pulses;  // Keep as float to avoid precision loss
+  float total_pulses;
 };
 
-// Config structure for persistence (PI, target temp, hysteresis, injected_per_pulse, prediction, thresholds)
+// v2: exact pulse counters in milli-pulses (see FuelCounter); base snapshot of the fuel journal
+struct FuelConsumptionDataV2 {
+  uint32_t version{2};
+  uint32_t last_reset_day;
+  uint64_t daily_milli_pulses;
+  uint64_t total_milli_pulses;
+  uint32_t journal_seq{0};  // last journal record included in the counters above
+  uint32_t reserved{0};
+};
+
+// Legacy config blob (versions 3-6); only read once to migrate into the config store
 struct HeaterConfigData {
   uint32_t version{6};
   float pi_kp;
@@ -103,6 +146,9 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   float get_injected_per_pulse() const { return injected_per_pulse_; }
   void set_polling_interval(uint32_t interval_ms) { polling_interval_ms_ = interval_ms; }
   void set_passive_sniff_mode(bool enable) { passive_sniff_mode_ = enable; }
+  void set_min_tx_gap(uint32_t gap_ms) { min_tx_gap_ms_ = gap_ms; }
+  void set_control_period(uint32_t period_ms) { control_period_ms_ = period_ms; }
+  void set_strict_checksum(bool strict) { strict_checksum_ = strict; }
   bool is_passive_sniff_mode() const { return passive_sniff_mode_; }
   void set_min_voltage_start(float voltage) { min_voltage_start_ = voltage; }
   void set_min_voltage_operate(float voltage) { min_voltage_operate_ = voltage; }
@@ -115,7 +161,14 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   void set_pi_kd(float kd) { pi_kd_ = kd; }
   void set_pi_min_on_time(float time_s) { pi_min_on_time_s_ = time_s; }
   void set_t_lookahead(float s) { t_lookahead_s_ = s; }
-  void set_slope_window(float s) { slope_window_s_ = s; }
+  void set_slope_window(float s) {
+    slope_window_s_ = s;
+    temperature_estimator_.set_response_time(s);
+  }
+  void set_temperature_noise(float sigma) { temperature_noise_ = sigma; }
+  void set_economy_band(float band) { economy_band_ = band; }
+  void set_cycle_aware_stop(bool enabled) { cycle_aware_stop_ = enabled; }
+  void set_cycle_penalty(float ml) { cycle_penalty_ml_ = ml; }
   void set_output_off_threshold(float v) { output_off_threshold_ = v; }
   void set_output_on_threshold(float v) { output_on_threshold_ = v; }
 
@@ -168,6 +221,60 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   void set_pi_output_sensor(sensor::Sensor *sensor) { pi_output_sensor_ = sensor; }
   void set_predicted_temperature_sensor(sensor::Sensor *sensor) { predicted_temperature_sensor_ = sensor; }
   void set_slope_sensor(sensor::Sensor *sensor) { slope_sensor_ = sensor; }
+  void set_command_latency_sensor(sensor::Sensor *sensor) { command_latency_sensor_ = sensor; }
+  void set_publishes_emitted_sensor(sensor::Sensor *sensor) { publishes_emitted_sensor_ = sensor; }
+  void set_control_jitter_sensor(sensor::Sensor *sensor) { control_jitter_sensor_ = sensor; }
+  void set_sample_age_sensor(sensor::Sensor *sensor) { sample_age_sensor_ = sensor; }
+  void set_economy_savings_sensor(sensor::Sensor *sensor) { economy_savings_sensor_ = sensor; }
+  void set_cycle_cost_sensor(sensor::Sensor *sensor) { cycle_cost_sensor_ = sensor; }
+  void set_cycle_voltage_sag_sensor(sensor::Sensor *sensor) { cycle_voltage_sag_sensor_ = sensor; }
+  void set_start_stop_cycles_sensor(sensor::Sensor *sensor) { start_stop_cycles_sensor_ = sensor; }
+  void set_idle_decisions_sensor(sensor::Sensor *sensor) { idle_decisions_sensor_ = sensor; }
+  void set_publishes_suppressed_sensor(sensor::Sensor *sensor) { publishes_suppressed_sensor_ = sensor; }
+
+  // Per-entity publish-on-change filter (deadband, min interval, heartbeat)
+  void set_publish_filter(TelemetryChannel channel, float deadband, float deadband_percent,
+                          uint32_t min_interval_ms, uint32_t heartbeat_ms);
+  uint32_t get_publishes_emitted() const { return publishes_emitted_; }
+  uint32_t get_publishes_suppressed() const { return publishes_suppressed_; }
+
+  // Link-layer counters and TX->RX round-trip statistics
+  void set_link_stat_sensor(LinkStat stat, sensor::Sensor *sensor) {
+    link_stat_sensors_[static_cast<uint8_t>(stat)] = sensor;
+  }
+  const LinkStats &get_link_stats() const { return link_stats_; }
+
+  // Binary capture of RX/TX frames and temperature samples (0 = disabled)
+  void set_capture_buffer_size(size_t size) { capture_buffer_size_ = size; }
+  void dump_capture();
+
+  // Frame trace ring (always on in passive sniff mode); dump_trace() logs the buffered records
+  void set_frame_trace(bool enable) { frame_trace_ = enable; }
+  void dump_trace();
+
+  // Usage history: hourly buckets (48 h) and daily buckets (96 days), persisted per chunk.
+  // The history text sensor shows the day selected with set_history_day() (0 = today).
+  void set_history_sensor(text_sensor::TextSensor *sensor) { history_sensor_ = sensor; }
+  void set_history_day(uint8_t days_ago);
+  uint8_t get_history_day() const { return history_day_; }
+  const HistoryStore &get_history() const { return history_; }
+  void dump_history();
+
+  // Closed-loop simulation: controller frames go to a simulated heater instead of the UART.
+  // get_simulated_temperature() is meant for a template sensor used as external_temperature_sensor.
+  void set_simulation(const SimConfig &config) {
+    simulator_.reset(new HeaterSimulator());
+    simulator_->configure(config);
+  }
+  bool is_simulating() const { return simulator_ != nullptr; }
+  float get_simulated_temperature() const { return simulator_ != nullptr ? simulator_->sensor_temperature() : NAN; }
+  const HeaterSimulator *get_simulator() const { return simulator_.get(); }
+
+  // Per-step PI records (automatic mode); export_pi_telemetry() logs them as CSV
+  void export_pi_telemetry();
+  const PiTelemetryRing &get_pi_telemetry() const { return pi_telemetry_; }
+  // Steps kept for the export; covers size x control_period (64 x 5 s = 5 min by default)
+  void set_pi_telemetry_size(size_t size) { pi_telemetry_size_ = size; }
 
   // Control methods (turn_on returns false if start rejected, e.g. target < measured in automatic mode)
   bool turn_on();
@@ -182,6 +289,13 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   bool is_manual_mode() const { return control_mode_ == ControlMode::MANUAL; }
   bool is_antifreeze_mode() const { return control_mode_ == ControlMode::ANTIFREEZE; }
   bool is_fan_only_mode() const { return control_mode_ == ControlMode::FAN_ONLY; }
+  bool is_autotune_mode() const { return control_mode_ == ControlMode::AUTOTUNE; }
+  bool is_economy_mode() const { return control_mode_ == ControlMode::ECONOMY; }
+  // Modes driven by the PI controller (AUTOMATIC and ECONOMY)
+  bool is_pi_mode() const { return control_mode_ == ControlMode::AUTOMATIC || control_mode_ == ControlMode::ECONOMY; }
+  const EconomyModel &get_economy_model() const { return economy_model_; }
+  const CycleCostTracker &get_cycle_cost_tracker() const { return cycle_tracker_; }
+  const PiAutotuner &get_autotuner() const { return autotuner_; }
 
   // Auto start/stop: when false, PI never calls turn_off(), holds at 10% instead
   void set_allow_auto_stop(bool allow) { allow_auto_stop_ = allow; }
@@ -208,11 +322,30 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   bool is_automatic_master_enabled() const { return automatic_master_enabled_; }
 
   // Fuel consumption getters
-  float get_daily_consumption() const { return daily_consumption_ml_; }
-  float get_instantaneous_consumption_rate() const { return pump_frequency_ * injected_per_pulse_ * 3600.0f; }
+  float get_daily_consumption() const { return FuelCounter::to_ml(daily_fuel_mp_, injected_per_pulse_); }
+  float get_total_consumption() const { return FuelCounter::to_ml(total_fuel_mp_, injected_per_pulse_); }
+  void set_fuel_max_gap(uint32_t ms) { fuel_max_gap_ms_ = ms; }
+  void set_flash_write_rate_sensor(sensor::Sensor *sensor) { flash_write_rate_sensor_ = sensor; }
+  float get_instantaneous_consumption_rate() const { return pump_frequency_ * dose_ml_per_pulse_() * 3600.0f; }
+
+  // Pump calibration: mark, run the heater, then enter the fuel actually used (ml)
+  void start_fuel_calibration();
+  void finish_fuel_calibration(float measured_ml);
+  void set_calibrate_per_level(bool per_level) { calibrate_per_level_ = per_level; }
+  const PumpCalibration &get_pump_calibration() const { return pump_calibration_; }
+
+  // Tank level from the fuel counter; capacity 0 = no tank tracking
+  void set_tank_capacity(float liters) { tank_.set_capacity_ml(liters * 1000.0f); }
+  void refill_tank();                  // filled to capacity
+  void add_tank_fuel(float liters);    // partial refill
+  float get_tank_remaining() const { return tank_.remaining_ml(total_fuel_mp_, injected_per_pulse_); }
+  void set_tank_remaining_sensor(sensor::Sensor *sensor) { tank_remaining_sensor_ = sensor; }
+  void set_tank_runtime_sensor(sensor::Sensor *sensor) { tank_runtime_sensor_ = sensor; }
+  void set_tank_runtime_average_sensor(sensor::Sensor *sensor) { tank_runtime_average_sensor_ = sensor; }
 
   // Component lifecycle
   void setup() override;
+  void loop() override;
   void update() override;
   void dump_config() override;
   float get_setup_priority() const override { return setup_priority::DATA; }
@@ -220,42 +353,199 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
  protected:
   // Communication handling
   void send_controller_frame();
-  void process_heater_frame(const std::vector<uint8_t> &frame);
+  void controller_command_bytes_(uint8_t &cmd, uint8_t &state) const;
+  uint32_t controller_signature_() const;  // cmd | power << 8 | state << 16
+  void service_tx_();
+  void request_tx_();
+  bool tx_pending_() const;  // a changed controller frame is waiting to be sent
+  void record_command_latency_(uint32_t latency_ms);
+  void process_heater_frame(const FrameView &frame);
   void check_uart_data();
-  bool validate_frame(const std::vector<uint8_t> &frame, uint8_t expected_length);
-  void log_frame_raw(const char* direction, const std::vector<uint8_t> &frame);
-  void log_decode_attempt(const std::vector<uint8_t> &frame, uint8_t expected_length);
-
-  // Data parsing helpers
-  uint16_t read_uint16_be(const std::vector<uint8_t> &data, size_t offset);
-  float parse_temperature(const std::vector<uint8_t> &data, size_t offset);
-  float parse_voltage(const std::vector<uint8_t> &data, size_t offset);
+  bool validate_frame(const FrameView &frame);
+  void record_rx_latency_(uint32_t latency_us);
+  void log_frame_raw(const char *direction, const TraceRecord &rec);
+  void log_decode_attempt(const FrameView &frame);
   const char* state_to_string(HeaterState state);
 
   // State management
-  void update_sensors(const std::vector<uint8_t> &frame);
+  void update_sensors(const HeaterTelemetry &t);
+  // force: publish regardless of the filter (counter resets), the filter restarts from the value
+  void publish_filtered_(sensor::Sensor *sens, TelemetryChannel channel, float value, bool force = false);
+  void publish_filtered_(text_sensor::TextSensor *sens, TelemetryChannel channel, const char *value);
+  void publish_filtered_(binary_sensor::BinarySensor *sens, TelemetryChannel channel, bool value, bool force = false);
+  void publish_diagnostics_();
+  void log_unknown_layout_(const FrameView &frame);
+  void service_capture_dump_();
+  void trace_frame_(TraceDirection direction, const FrameView &frame, uint8_t flags = 0, uint8_t state = 0);
+  void drain_trace_();
+  void automatic_mode_step_();
+  // The sensor currently reports a value (NaN = sensor unavailable)
+  bool external_sensor_online_() const {
+    return external_temperature_sensor_ != nullptr && external_temperature_sensor_->has_state() &&
+           !std::isnan(external_temperature_sensor_->state);
+  }
+  bool external_sample_stale_() const;
+  PiStepRecord &record_pi_step_(PiDecision decision, float dt_s);
+  void service_pi_export_();
+  uint32_t wall_clock_s_();
+  void record_history_(const HeaterTelemetry &t, bool start);
+  void roll_history_();
+  void publish_history_();
+  void service_history_dump_();
+  void save_tank_();
+  void save_pump_calibration_();
+  void save_history_();
+  // Persistence: records are marked dirty and written together in one commit from loop()
+  void persist_(PersistRecord record, uint32_t hold_ms = 0, bool restart = false) {
+    persistence_.mark(record, millis(), hold_ms, restart);
+  }
+  bool persistence_window_open_(uint32_t now) const;
+  void service_persistence_();
+  void commit_persistence_();
+  // ml per pulse at the reported power level
+  float dose_ml_per_pulse_() const { return injected_per_pulse_ * pump_calibration_.factor(pump_level_); }
+  void publish_tank_();
+  bool read_rx_byte_(uint8_t *byte);
+  size_t rx_buffered_();
+  void service_simulation_();
   void handle_communication_timeout();
   void check_voltage_safety();
   void handle_antifreeze_mode();
   void handle_automatic_mode();
+  void service_control_();
+  bool economy_level_(float t_pred, float &pct);
+  void learn_economy_(uint32_t now, float dt_s);
+  CyclePhase cycle_phase_() const;
+  float idle_fuel_rate_() const;
+  float predicted_off_s_() const;
+  bool idle_instead_of_stop_(uint32_t now);
+  void update_prediction_(float &slope, float &t_pred);
+  void start_autotune_();
+  void handle_autotune_();
+  void check_autotune_safety_();
+  void finish_autotune_();
 
   // Fuel consumption tracking
-  void update_fuel_consumption(float pump_frequency);
+  void update_fuel_consumption(uint8_t pump_raw, uint8_t level);
+  void publish_fuel_consumption_();
+  void journal_fuel_consumption_(bool force);
+  void write_fuel_journal_();
+  float flash_writes_per_hour_() const;
   void save_fuel_consumption_data();
   void load_fuel_consumption_data();
   void load_config_data();
   void save_config_data();
+  void bind_config_();
+  bool migrate_legacy_config_();
   void publish_all_config_entities_();
   void check_daily_reset();
   uint32_t get_days_since_epoch();
 
   // Communication state
-  std::vector<uint8_t> rx_buffer_;
+  FrameParser rx_parser_;
   uint32_t last_received_time_{0};
   uint32_t last_send_time_{0};
-  bool frame_sync_{false};
+  uint32_t rx_drain_bytes_{0};  // RX drain throughput (dump_config)
+  uint32_t rx_drain_us_{0};
+  uint32_t rx_byte_us_{2083};          // one byte on the wire (4800 8N1 until setup())
+  uint32_t rx_byte_arrival_us_{0};     // estimated arrival of the newest UART byte read
+  uint32_t rx_drain_end_us_{0};        // micros() at the end of the previous drain
+  bool rx_stream_open_{false};         // a frame was still arriving at the previous drain
+  uint32_t rx_latency_last_us_{0};
+  uint32_t rx_latency_max_us_{0};
+  uint64_t rx_latency_sum_us_{0};
+  uint32_t rx_latency_count_{0};
+  uint32_t unknown_layouts_seen_[MAX_UNKNOWN_LAYOUTS]{};  // id << 16 | length byte << 8 | size
+  uint8_t unknown_layouts_seen_count_{0};
+  uint32_t unknown_layout_frames_{0};
+  uint32_t unknown_layout_suppressed_frames_{0};  // frames of layouts beyond the table
+
+  // Capture ring (see capture.h); recording pauses while a dump is in progress
+  size_t capture_buffer_size_{0};
+  CaptureBuffer capture_;
+  bool capture_dumping_{false};
+  size_t capture_dump_offset_{0};
+
+  // Frame trace ring: records are copied on the frame path and formatted lazily from loop()
+  bool frame_trace_{false};
+  TraceRing<TRACE_RING_SIZE> trace_;
+  size_t trace_dump_remaining_{0};
+
+  // PI step records: filled on the control path, formatted only on export
+  size_t pi_telemetry_size_{DEFAULT_PI_TELEMETRY_SIZE};
+  PiTelemetryRing pi_telemetry_;
+  PiStepRecord *pi_step_{nullptr};  // record of the step in progress
+  HistoryStore history_;
+  ESPPreferenceObject pref_history_hours_[HistoryStore::HOUR_CHUNKS];
+  ESPPreferenceObject pref_history_days_[HistoryStore::DAY_CHUNKS];
+  uint16_t history_dirty_hours_{0};    // chunk bitmasks waiting for the next commit
+  uint16_t history_dirty_days_{0};
+  uint64_t history_total_mp_{0};       // fuel counter value last added to the history
+  uint32_t history_frame_ms_{0};
+  uint8_t history_day_{0};
+  bool history_dumping_{false};
+  uint32_t history_dump_index_{0};     // next hour (hourly part) or day index to log
+  uint32_t history_dump_end_{0};
+  bool history_dump_days_{false};
+  text_sensor::TextSensor *history_sensor_{nullptr};
+  bool pi_exporting_{false};
+  uint32_t pi_export_seq_{0};
+  uint32_t pi_export_end_seq_{0};
+
+  // Control scheduler: fixed-rate PI steps on the held (latest timestamped) sensor sample
+  uint32_t control_period_ms_{DEFAULT_CONTROL_PERIOD_MS};
+  uint32_t next_control_ms_{0};
+  uint32_t external_sample_ms_{0};     // millis() of the latest accepted sensor sample, 0 = none
+  uint32_t control_steps_{0};
+  uint32_t control_overruns_{0};       // periods skipped because loop() was late by a full period
+  uint32_t control_jitter_ms_{0};      // lateness of the current step
+  uint32_t control_jitter_max_ms_{0};
+  uint32_t control_jitter_window_max_ms_{0};  // since the last diagnostics publish
+  uint64_t control_jitter_sum_ms_{0};
+  uint32_t sample_age_ms_{0};          // age of the held sample at the current step
+  uint32_t sample_age_max_ms_{0};
+
+  // ECONOMY mode: per-level slope/fuel model learned at every control step near the target
+  EconomyModel economy_model_;
+  float economy_band_{0.5f};            // tolerance around the target [°C]
+  bool economy_high_{false};            // bang-bang state between the learned low/high levels
+  bool economy_active_{false};          // this step's level came from the model
+  uint32_t economy_signature_{0};       // (state, level, enabled) the current hold is for
+  uint32_t economy_hold_since_{0};
+  float economy_savings_ml_{0.0f};      // vs. the PI's adjacent-level mix over the same time
+  float economy_hold_s_{0.0f};
+
+  // Cycle cost: measured start/stop cost decides between idling at 10 % and stopping
+  CycleCostTracker cycle_tracker_;
+  bool cycle_aware_stop_{true};
+  float cycle_penalty_ml_{0.0f};        // extra cost per start (battery, glow plug wear) [ml]
+
+  // AUTOTUNE mode: step experiment driven by external temperature samples
+  PiAutotuner autotuner_;
+  AutotunePhase autotune_logged_phase_{AutotunePhase::IDLE};
+  ControlMode autotune_return_mode_{ControlMode::AUTOMATIC};
+  static constexpr float AUTOTUNE_CEILING_MARGIN = 3.0f;  // step ends at target + margin
+
+  // Simulation (simulate: in YAML); replies are served through the normal RX parser
+  std::unique_ptr<HeaterSimulator> simulator_;
+  uint8_t sim_rx_[HEATER_FRAME_SIZE]{};
+  size_t sim_rx_len_{0};
+  size_t sim_rx_pos_{0};
+  uint32_t sim_last_step_{0};
+
+  // TX scheduler: command changes go out from loop(), keep-alive from update()
+  bool tx_scheduler_started_{false};
+  uint32_t min_tx_gap_ms_{DEFAULT_MIN_TX_GAP_MS};
+  uint32_t last_tx_signature_{0};
+  ControllerFrame tx_frame_;
+  uint32_t command_pending_since_{0};  // millis() of the first unsent request_tx_(), 0 = none
+  uint32_t last_command_latency_ms_{0};
+  uint32_t max_command_latency_ms_{0};
+  uint32_t command_latency_sum_ms_{0};
+  uint32_t command_latency_count_{0};
   uint32_t polling_interval_ms_{DEFAULT_POLLING_INTERVAL_MS};
   bool passive_sniff_mode_{false};  // Only log RX/decode, never send
+  bool strict_checksum_{false};     // Reject frames with checksum mismatch (and resync)
   bool heater_state_synced_once_{false};  // After first heater frame, sync heater_enabled_ from state so switch can init
   uint32_t last_start_request_time_{0};   // Don't sync heater_enabled_ to false when OFF during start grace (heater needs ~60s)
   bool hardware_stopping_cooling_stale_{false};  // Hardware stuck in STOPPING_COOLING, need STOP before START
@@ -303,13 +593,15 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   static constexpr float PI_INTEGRAL_MAX = 100.0f;
   float pi_min_on_time_s_{30.0f};
   static constexpr uint32_t PI_SENSOR_GRACE_PERIOD_MS = 600000;
+  // A held sample older than this many sensor intervals (at least the minimum) counts as sensor loss
+  static constexpr uint32_t PI_SAMPLE_STALE_INTERVALS = 3;
+  static constexpr uint32_t PI_SAMPLE_STALE_MIN_MS = 30000;
 
-  // Temperature prediction (always active)
+  // Temperature prediction (always active); the estimator is fed by the sensor callback
   float t_lookahead_s_{90.0f};
   float slope_window_s_{45.0f};
-  float slope_filtered_{0.0f};
-  float temp_prev_{NAN};
-  uint32_t time_prev_{0};
+  float temperature_noise_{0.05f};  // sensor noise sigma [°C]
+  TemperatureEstimator temperature_estimator_;
 
   // Parsed sensor values
   float current_temperature_{0.0};
@@ -322,24 +614,44 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   bool cooling_down_{false};
   bool low_voltage_error_{false};
 
-  // Fuel consumption tracking
-  float last_pump_frequency_{0.0};
+  // Fuel consumption tracking: exact milli-pulse counters, converted to ml when published
+  FuelCounter fuel_counter_;
+  uint8_t last_pump_raw_{0};
+  bool last_fuel_state_{false};         // previous frame was HEATING_UP / STABLE_COMBUSTION
   uint32_t last_consumption_update_{0};
-  float daily_consumption_ml_{0.0};
+  uint64_t daily_fuel_mp_{0};
+  uint64_t total_fuel_mp_{0};
   uint32_t current_day_{0};
-  float total_fuel_pulses_{0.0};
-  float total_consumption_ml_{0.0};
+  uint32_t fuel_max_gap_ms_{DEFAULT_FUEL_MAX_GAP_MS};
+  uint32_t fuel_gaps_clamped_{0};
   ESPPreferenceObject pref_fuel_consumption_;
-  ESPPreferenceObject pref_config_;
-  bool config_dirty_{false};
-  uint32_t config_last_change_{0};
+  ESPPreferenceObject pref_fuel_consumption_legacy_;
+  FuelJournal fuel_journal_;
+  ESPPreferenceObject pref_fuel_journal_[FuelJournal::SLOTS];
+  uint64_t journaled_total_mp_{0};     // total covered by the base + appended records
+  uint32_t last_journal_ms_{0};
+  uint32_t fuel_base_writes_{0};
+  uint32_t fuel_record_writes_{0};
+  PumpCalibration pump_calibration_;
+  ESPPreferenceObject pref_pump_calibration_;
+  bool calibrate_per_level_{false};
+  uint8_t pump_level_{0};               // reported power level of the last frame
+  TankGauge tank_;
+  ESPPreferenceObject pref_tank_;
+  sensor::Sensor *tank_remaining_sensor_{nullptr};
+  sensor::Sensor *tank_runtime_sensor_{nullptr};
+  sensor::Sensor *tank_runtime_average_sensor_{nullptr};
+  ConfigStore config_store_;
+  ESPPreferenceObject pref_config_records_[ConfigStore::MAX_ENTRIES];
+  ESPPreferenceObject pref_config_;    // legacy HeaterConfigData
+  uint32_t config_record_writes_{0};
   static constexpr uint32_t CONFIG_SAVE_DEBOUNCE_MS = 2000u;
+  PersistenceService persistence_;
 
   time::RealTimeClock *time_component_{nullptr};
   bool time_sync_warning_shown_{false};
 
   sensor::Sensor *external_temperature_sensor_{nullptr};
-  float last_external_temperature_{NAN};
   sensor::Sensor *input_voltage_sensor_{nullptr};
   text_sensor::TextSensor *state_sensor_{nullptr};
   sensor::Sensor *power_level_sensor_{nullptr};
@@ -356,6 +668,25 @@ class SunsterHeater : public PollingComponent, public uart::UARTDevice {
   sensor::Sensor *pi_output_sensor_{nullptr};
   sensor::Sensor *predicted_temperature_sensor_{nullptr};
   sensor::Sensor *slope_sensor_{nullptr};
+  sensor::Sensor *command_latency_sensor_{nullptr};
+  sensor::Sensor *publishes_emitted_sensor_{nullptr};
+  sensor::Sensor *publishes_suppressed_sensor_{nullptr};
+  sensor::Sensor *control_jitter_sensor_{nullptr};
+  sensor::Sensor *sample_age_sensor_{nullptr};
+  sensor::Sensor *economy_savings_sensor_{nullptr};
+  sensor::Sensor *flash_write_rate_sensor_{nullptr};
+  sensor::Sensor *cycle_cost_sensor_{nullptr};
+  sensor::Sensor *cycle_voltage_sag_sensor_{nullptr};
+  sensor::Sensor *start_stop_cycles_sensor_{nullptr};
+  sensor::Sensor *idle_decisions_sensor_{nullptr};
+  PublishFilter publish_filters_[TELEMETRY_CHANNEL_COUNT];
+  uint32_t publishes_emitted_{0};
+  uint32_t publishes_suppressed_{0};
+  uint32_t last_diagnostics_publish_{0};
+  sensor::Sensor *link_stat_sensors_[LINK_STAT_COUNT]{};
+  LinkStats link_stats_;
+  uint32_t rtt_tx_time_{0};       // millis() of the TX awaiting a heater reply, 0 = none
+  bool comm_timeout_active_{false};
   number::Number *injected_per_pulse_number_{nullptr};
   number::Number *power_level_number_{nullptr};
   number::Number *pi_kp_number_{nullptr};
@@ -432,6 +763,150 @@ class SunsterResetTotalConsumptionButton : public button::Button, public Compone
   SunsterHeater *heater_{nullptr};
 };
 
+// Button component starting a pump calibration session
+class SunsterCalibrationStartButton : public button::Button, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_BUTTON("", "Sunster Heater Fuel Calibration Start", this);
+  }
+
+ protected:
+  void press_action() override {
+    if (heater_) {
+      heater_->start_fuel_calibration();
+    }
+  }
+
+  SunsterHeater *heater_{nullptr};
+};
+
+// Number component ending the calibration session with the measured fuel (ml)
+class SunsterCalibrationFuelNumber : public number::Number, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_NUMBER("", "Sunster Heater Fuel Calibration Measured", this);
+  }
+
+ protected:
+  void control(float value) override {
+    if (heater_ && value > 0.0f) {
+      heater_->finish_fuel_calibration(value);
+    }
+    this->publish_state(value);
+  }
+  SunsterHeater *heater_{nullptr};
+};
+
+// Button component for marking the fuel tank as full
+class SunsterTankRefillButton : public button::Button, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_BUTTON("", "Sunster Heater Tank Refilled", this);
+  }
+
+ protected:
+  void press_action() override {
+    if (heater_) {
+      heater_->refill_tank();
+    }
+  }
+
+  SunsterHeater *heater_{nullptr};
+};
+
+// Number component for a partial refill: the entered liters are added to the tank level
+class SunsterTankAddFuelNumber : public number::Number, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_NUMBER("", "Sunster Heater Tank Add Fuel", this);
+  }
+
+ protected:
+  void control(float value) override {
+    if (heater_ && value > 0.0f) {
+      heater_->add_tank_fuel(value);
+    }
+    this->publish_state(value);
+  }
+  SunsterHeater *heater_{nullptr};
+};
+
+// Button component for dumping the frame trace ring to the log
+class SunsterDumpTraceButton : public button::Button, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_BUTTON("", "Sunster Heater Dump Trace", this);
+  }
+
+ protected:
+  void press_action() override {
+    if (heater_) {
+      heater_->dump_trace();
+    }
+  }
+
+  SunsterHeater *heater_{nullptr};
+};
+
+// Button component for dumping the usage history to the log
+class SunsterDumpHistoryButton : public button::Button, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_BUTTON("", "Sunster Heater Dump History", this);
+  }
+
+ protected:
+  void press_action() override {
+    if (heater_) {
+      heater_->dump_history();
+    }
+  }
+
+  SunsterHeater *heater_{nullptr};
+};
+
+// Button component for exporting the PI step records as CSV to the log
+class SunsterExportPiTelemetryButton : public button::Button, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_BUTTON("", "Sunster Heater Export PI Telemetry", this);
+  }
+
+ protected:
+  void press_action() override {
+    if (heater_) {
+      heater_->export_pi_telemetry();
+    }
+  }
+
+  SunsterHeater *heater_{nullptr};
+};
+
+// Button component for dumping the capture ring to the log
+class SunsterDumpCaptureButton : public button::Button, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void dump_config() override {
+    LOG_BUTTON("", "Sunster Heater Dump Capture", this);
+  }
+
+ protected:
+  void press_action() override {
+    if (heater_) {
+      heater_->dump_capture();
+    }
+  }
+
+  SunsterHeater *heater_{nullptr};
+};
+
 // Switch component for heater power on/off (works in all modes; in Automatic, PI sets power level)
 class SunsterHeaterPowerSwitch : public switch_::Switch, public Component {
  public:
@@ -733,6 +1208,29 @@ class SunsterPiMinOnTimeNumber : public number::Number, public Component {
   uint32_t last_publish_{0};
 };
 
+// Number component selecting the day shown by the history text sensor (0 = today)
+class SunsterHistoryDayNumber : public number::Number, public Component {
+ public:
+  void set_sunster_heater(SunsterHeater *heater) { heater_ = heater; }
+  void setup() override {
+    if (heater_) {
+      this->publish_state(heater_->get_history_day());
+    }
+  }
+  void dump_config() override {
+    LOG_NUMBER("", "Sunster Heater History Day", this);
+  }
+
+ protected:
+  void control(float value) override {
+    if (heater_) {
+      heater_->set_history_day(static_cast<uint8_t>(value));
+      this->publish_state(heater_->get_history_day());
+    }
+  }
+  SunsterHeater *heater_{nullptr};
+};
+
 // Number component for t_lookahead (prediction lookahead)
 class SunsterTLookaheadNumber : public number::Number, public Component {
  public:
@@ -883,6 +1381,8 @@ class SunsterControlModeSelect : public select::Select, public Component {
       if (heater_->is_automatic_mode()) mode = "Automatic";
       else if (heater_->is_antifreeze_mode()) mode = "Antifreeze";
       else if (heater_->is_fan_only_mode()) mode = "Fan Only";
+      else if (heater_->is_autotune_mode()) mode = "Autotune";
+      else if (heater_->is_economy_mode()) mode = "Economy";
       ESP_LOGI(TAG, "[SEND_HA] ControlMode = %s (setup)", mode);
       this->publish_state(mode);
     }
@@ -902,6 +1402,10 @@ class SunsterControlModeSelect : public select::Select, public Component {
       this->publish_state("Antifreeze");
     } else if (heater_->is_fan_only_mode()) {
       this->publish_state("Fan Only");
+    } else if (heater_->is_autotune_mode()) {
+      this->publish_state("Autotune");
+    } else if (heater_->is_economy_mode()) {
+      this->publish_state("Economy");
     } else {
       this->publish_state("Manual");
     }
@@ -917,6 +1421,8 @@ class SunsterControlModeSelect : public select::Select, public Component {
         if (heater_->is_automatic_mode()) mode = "Automatic";
         else if (heater_->is_antifreeze_mode()) mode = "Antifreeze";
         else if (heater_->is_fan_only_mode()) mode = "Fan Only";
+        else if (heater_->is_autotune_mode()) mode = "Autotune";
+        else if (heater_->is_economy_mode()) mode = "Economy";
         ESP_LOGI(TAG, "[SEND_HA] ControlMode = %s (first loop)", mode);
       }
       last_mode_publish_ = now;
@@ -933,8 +1439,13 @@ class SunsterControlModeSelect : public select::Select, public Component {
         heater_->set_control_mode(ControlMode::ANTIFREEZE);
       } else if (value == "Fan Only") {
         heater_->set_control_mode(ControlMode::FAN_ONLY);
+      } else if (value == "Autotune") {
+        heater_->set_control_mode(ControlMode::AUTOTUNE);
+      } else if (value == "Economy") {
+        heater_->set_control_mode(ControlMode::ECONOMY);
       }
-      this->publish_state(value);
+      // Publish the resulting mode: AUTOTUNE is refused without a usable external sensor
+      publish_mode_state_();
     }
   }
 
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+#include "fuel_counter.h"
+
+namespace esphome {
+namespace sunster_heater {
+
+// Persisted tank state: fill level at the last refill and the fuel counter at that moment
+struct TankData {
+  float fill_ml;              // NAN = never refilled
+  uint32_t reserved{0};       // explicit padding so the saved blob has no indeterminate bytes
+  uint64_t refill_total_mp;   // total fuel counter (milli-pulses) at the refill
+};
+
+// Tank level and remaining runtime from the exact fuel counter.
+//
+// The level is fill - pulses since the refill, so it follows the pulse integration without
+// any state of its own and stays exact when the ml/pulse calibration changes. The 24 h
+// average rate comes from a ring of hourly pulse sums (uptime hours) with a running total;
+// until 24 h have passed the window is the time since boot.
+class TankGauge {
+ public:
+  static constexpr size_t SLOTS = 24;
+  static constexpr uint32_t SLOT_MS = 3600000;
+  static constexpr uint32_t MIN_WINDOW_MS = 600000;  // no average before 10 min of data
+
+  void set_capacity_ml(float capacity_ml) { capacity_ml_ = capacity_ml; }
+  float capacity_ml() const { return capacity_ml_; }
+
+  void load(const TankData &data) {
+    data_ = data;
+    data_.reserved = 0;  // blobs saved before the field existed carry whatever the padding held
+  }
+  const TankData &data() const { return data_; }
+  bool is_known() const { return !std::isnan(data_.fill_ml); }
+
+  float remaining_ml(uint64_t total_mp, float ml_per_pulse) const {
+    if (!this->is_known())
+      return NAN;
+    uint64_t used = total_mp >= data_.refill_total_mp ? total_mp - data_.refill_total_mp : 0;
+    return std::fmax(0.0f, data_.fill_ml - FuelCounter::to_ml(used, ml_per_pulse));
+  }
+
+  // Refill: added_ml < 0 fills to capacity, otherwise adds to the current level (capped)
+  void refill(uint64_t total_mp, float ml_per_pulse, float added_ml) {
+    float level = added_ml < 0.0f ? capacity_ml_ : this->remaining_or_zero_(total_mp, ml_per_pulse) + added_ml;
+    data_.fill_ml = capacity_ml_ > 0.0f ? std::fmin(level, capacity_ml_) : level;
+    data_.refill_total_mp = total_mp;
+  }
+
+  // The total counter is about to be reset to 0: keep the current level
+  void rebase(uint64_t total_mp, float ml_per_pulse) {
+    if (!this->is_known())
+      return;
+    data_.fill_ml = this->remaining_ml(total_mp, ml_per_pulse);
+    data_.refill_total_mp = 0;
+  }
+
+  // Pulses from the fuel integration, for the 24 h average
+  void add_fuel(uint32_t now_ms, uint64_t milli_pulses) {
+    this->advance(now_ms);
+    slots_[slot_] += milli_pulses;
+    window_mp_ += milli_pulses;
+  }
+
+  // Drops hours that left the window; cheap, call periodically
+  void advance(uint32_t now_ms) {
+    if (!started_) {
+      started_ = true;
+      slot_start_ms_ = now_ms;
+      return;
+    }
+    for (size_t i = 0; i < SLOTS && now_ms - slot_start_ms_ >= SLOT_MS; i++) {
+      slot_ = (slot_ + 1) % SLOTS;
+      window_mp_ -= slots_[slot_];
+      slots_[slot_] = 0;
+      slot_start_ms_ += SLOT_MS;
+      if (full_slots_ < SLOTS - 1)
+        full_slots_++;
+    }
+    if (now_ms - slot_start_ms_ >= SLOT_MS)
+      slot_start_ms_ = now_ms;  // idle longer than the whole window
+  }
+
+  // Average fuel rate over the last 24 h (ml/h), NAN until MIN_WINDOW_MS of data
+  float average_ml_h(uint32_t now_ms, float ml_per_pulse) const {
+    if (!started_)
+      return NAN;
+    float window_ms = full_slots_ * static_cast<float>(SLOT_MS) + (now_ms - slot_start_ms_);
+    if (window_ms < MIN_WINDOW_MS)
+      return NAN;
+    return FuelCounter::to_ml(window_mp_, ml_per_pulse) * 3600000.0f / window_ms;
+  }
+
+  // Hours until empty at rate_ml_h; NAN when unknown or not consuming
+  static float runtime_h(float remaining_ml, float rate_ml_h) {
+    if (std::isnan(remaining_ml) || !(rate_ml_h > 0.0f))
+      return NAN;
+    return remaining_ml / rate_ml_h;
+  }
+
+ protected:
+  float remaining_or_zero_(uint64_t total_mp, float ml_per_pulse) const {
+    float remaining = this->remaining_ml(total_mp, ml_per_pulse);
+    return std::isnan(remaining) ? 0.0f : remaining;
+  }
+
+  float capacity_ml_{0.0f};
+  TankData data_{NAN, 0, 0};
+
+  uint64_t slots_[SLOTS]{};
+  uint64_t window_mp_{0};
+  size_t slot_{0};
+  size_t full_slots_{0};
+  uint32_t slot_start_ms_{0};
+  bool started_{false};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace esphome {
+namespace sunster_heater {
+
+// Two-state Kalman filter (temperature, rate) for the external temperature sensor.
+//
+// Constant-rate model with white-noise acceleration, propagated over the actual time between
+// samples, so irregular callbacks and dropped samples only widen the covariance instead of
+// biasing the slope. The process noise is derived from the measurement noise and a response
+// time (slope_window) over the nominal sample interval, so the slope settles within roughly one
+// window regardless of how often the sensor reports:
+//   q = sigma^2 * Ts * (1.5 / window)^4       (steady-state bandwidth ~ 1.5 / window)
+// Samples whose innovation exceeds GATE_SIGMA are dropped (e.g. DS18B20 85 °C power-on reads);
+// REINIT_AFTER consecutive rejections restart the filter on the new level.
+class TemperatureEstimator {
+ public:
+  static constexpr float MAX_GAP_S = 600.0f;     // restart after this long without samples
+  static constexpr float GATE_SIGMA = 8.0f;
+  static constexpr uint8_t REINIT_AFTER = 3;
+  static constexpr float INITIAL_RATE_STDDEV = 0.01f;  // °C/s (36 °C/h)
+  static constexpr float BANDWIDTH = 1.5f;             // x 1/response_time; tuned against the old EMA
+
+  void configure(float measurement_noise_c, float response_time_s) {
+    noise_c_ = measurement_noise_c;
+    response_s_ = response_time_s;
+  }
+  void set_response_time(float response_time_s) { response_s_ = response_time_s; }
+
+  void reset() { initialized_ = false; }
+
+  // Forget the rate (e.g. at a combustion state change); temperature is kept
+  void reset_rate() {
+    if (!initialized_)
+      return;
+    rate_ = 0.0f;
+    p01_ = 0.0f;
+    p11_ = INITIAL_RATE_STDDEV * INITIAL_RATE_STDDEV;
+  }
+
+  // Returns false if the sample was rejected by the innovation gate
+  bool update(uint32_t now_ms, float measured) {
+    float r = noise_c_ * noise_c_;
+    if (!initialized_ || (now_ms - last_ms_) / 1000.0f > MAX_GAP_S) {
+      this->init_(now_ms, measured);
+      return true;
+    }
+    float dt = (now_ms - last_ms_) / 1000.0f;
+    if (dt > 0.0f) {
+      // Nominal sample interval; gaps from dropped samples are not averaged in
+      if (std::isnan(interval_s_)) {
+        interval_s_ = dt;
+      } else if (dt < 2.5f * interval_s_) {
+        interval_s_ += 0.1f * (dt - interval_s_);
+      }
+    }
+
+    // Predict to the sample time (temporarily, in case the sample is rejected)
+    float q = this->process_noise_();
+    float temp = temperature_ + rate_ * dt;
+    float p00 = p00_ + 2.0f * dt * p01_ + dt * dt * p11_ + q * dt * dt * dt / 3.0f;
+    float p01 = p01_ + dt * p11_ + q * dt * dt / 2.0f;
+    float p11 = p11_ + q * dt;
+
+    float innovation = measured - temp;
+    float s = p00 + r;
+    if (innovation * innovation > GATE_SIGMA * GATE_SIGMA * s) {
+      if (++rejected_ >= REINIT_AFTER) {
+        this->init_(now_ms, measured);
+        return true;
+      }
+      return false;
+    }
+    rejected_ = 0;
+
+    float k0 = p00 / s;
+    float k1 = p01 / s;
+    temperature_ = temp + k0 * innovation;
+    rate_ += k1 * innovation;
+    p11_ = p11 - k1 * p01;
+    p01_ = (1.0f - k0) * p01;
+    p00_ = (1.0f - k0) * p00;
+    last_ms_ = now_ms;
+    return true;
+  }
+
+  bool is_initialized() const { return initialized_; }
+  float temperature() const { return temperature_; }
+  float rate() const { return rate_; }                // °C/s
+  float rate_stddev() const { return std::sqrt(p11_); }
+  float predict(float horizon_s) const { return temperature_ + rate_ * horizon_s; }
+  float sample_interval_s() const { return interval_s_; }
+
+ protected:
+  void init_(uint32_t now_ms, float measured) {
+    temperature_ = measured;
+    rate_ = 0.0f;
+    p00_ = noise_c_ * noise_c_;
+    p01_ = 0.0f;
+    p11_ = INITIAL_RATE_STDDEV * INITIAL_RATE_STDDEV;
+    last_ms_ = now_ms;
+    rejected_ = 0;
+    initialized_ = true;
+  }
+
+  float process_noise_() const {
+    float ts = std::isnan(interval_s_) ? 5.0f : interval_s_;
+    float w = BANDWIDTH / response_s_;
+    return noise_c_ * noise_c_ * ts * w * w * w * w;
+  }
+
+  float noise_c_{0.05f};
+  float response_s_{45.0f};
+  float temperature_{NAN};
+  float rate_{0.0f};
+  float p00_{0.0f};
+  float p01_{0.0f};
+  float p11_{0.0f};
+  float interval_s_{NAN};
+  uint32_t last_ms_{0};
+  uint8_t rejected_{0};
+  bool initialized_{false};
+};
+
+}  // namespace sunster_heater
+}  // namespace esphome
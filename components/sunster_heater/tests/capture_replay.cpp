@@ -0,0 +1,449 @@
+// Host replay of a capture recorded on the device (capture_buffer_size + dump_capture_button).
+//
+//   capture_replay <capture.bin>              replay through the component, print the decode
+//   capture_replay --bench <capture.bin> [n]  decode throughput (frames/s), stream repeated n times,
+//                                             the old vs new RX parser on the same bytes and the
+//                                             old byte-offset vs FIELDS table status decode and
+//                                             the old per-send vector vs template TX frame build
+//   capture_replay --record-sim <out.bin> [s] record a cold start of the simulated heater
+//
+// The capture is fed through the UART at wire speed on a virtual clock, so parsing, decoding,
+// fuel integration and the control logic run exactly as on the device.
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "host_harness.h"
+#include "legacy_frames.h"
+
+using namespace esphome;
+using namespace esphome::sunster_heater;
+using namespace esphome::sunster_heater::testing;
+
+namespace {
+
+const char *state_name(HeaterState state) {
+  switch (state) {
+    case HeaterState::OFF: return "OFF";
+    case HeaterState::POLLING_STATE: return "POLLING_STATE";
+    case HeaterState::HEATING_UP: return "HEATING_UP";
+    case HeaterState::STABLE_COMBUSTION: return "STABLE_COMBUSTION";
+    case HeaterState::STOPPING_COOLING: return "STOPPING_COOLING";
+    case HeaterState::VENTILATION: return "VENTILATION";
+    default: return "UNKNOWN";
+  }
+}
+
+int replay(const std::string &path) {
+  std::vector<uint8_t> stream;
+  if (!read_file(path, stream)) {
+    std::fprintf(stderr, "cannot read %s\n", path.c_str());
+    return 1;
+  }
+  HostHeater host_heater;
+  sensor::Sensor exchanger, pump, fan, voltage;
+  host_heater.heater.set_heat_exchanger_temperature_sensor(&exchanger);
+  host_heater.heater.set_pump_frequency_sensor(&pump);
+  host_heater.heater.set_fan_speed_sensor(&fan);
+  host_heater.heater.set_input_voltage_sensor(&voltage);
+
+  ReplayCounts counts;
+  if (!replay_capture(host_heater, stream, counts)) {
+    std::fprintf(stderr, "%s is not a capture stream\n", path.c_str());
+    return 1;
+  }
+  const SunsterHeater &heater = host_heater.heater;
+  const LinkStats &link = heater.get_link_stats();
+  std::printf("records: %u RX, %u TX, %u temperature\n", (unsigned) counts.rx_records, (unsigned) counts.tx_records,
+              (unsigned) counts.temperature_records);
+  std::printf("decoded: %u heater frames, %u echo, %u checksum failures, %u resyncs\n", (unsigned) link.rx_frames,
+              (unsigned) link.echo_frames, (unsigned) link.checksum_failures, (unsigned) link.resyncs);
+  std::printf("final:   state %s, exchanger %.1f C, pump %.1f Hz, fan %.0f rpm, %.1f V\n",
+              state_name(heater.get_heater_state()), exchanger.state, pump.state, fan.state, voltage.state);
+  std::printf("fuel:    %.2f ml, %u starts\n", heater.get_total_consumption(),
+              (unsigned) heater.get_cycle_cost_tracker().starts());
+  host::set_log_hook(host::LOG_CONFIG, [](const char *tag, const char *line) {
+    if (std::strstr(line, "RX Latency") != nullptr)
+      std::printf("latency: %s\n", line + std::strspn(line, " "));
+  });
+  host_heater.heater.dump_config();
+  host::set_log_hook(host::LOG_NONE, nullptr);
+  // Reference for the component's estimate: each frame's last byte waits in the UART until
+  // the next loop() (the harness starts the loop at the first scheduled byte)
+  CaptureReader reader(stream.data(), stream.size());
+  CaptureRecord rec;
+  uint64_t loop_start_us = UINT64_MAX;
+  while (reader.next(rec)) {
+    uint64_t wire_us = static_cast<uint64_t>(rec.len) * HostHeater::BYTE_US;
+    uint64_t first_us = record_us(rec) > wire_us ? record_us(rec) - wire_us : 0;
+    if (first_us < loop_start_us)
+      loop_start_us = first_us;
+  }
+  const uint64_t loop_us = HostHeater::LOOP_MS * 1000ULL;
+  uint64_t wait_sum_us = 0, wait_max_us = 0;
+  uint32_t frames = 0;
+  CaptureReader rx(stream.data(), stream.size());
+  while (rx.next(rec)) {
+    if (rec.type != CaptureRecordType::RX)
+      continue;
+    uint64_t last_byte_us = record_us(rec) - HostHeater::BYTE_US;
+    uint64_t wait_us = (loop_us - (last_byte_us - loop_start_us) % loop_us) % loop_us;
+    wait_sum_us += wait_us;
+    wait_max_us = wait_us > wait_max_us ? wait_us : wait_max_us;
+    frames++;
+  }
+  if (frames > 0)
+    std::printf("wire:    last byte -> loop(): avg=%.1f ms max=%.1f ms (%u frames)\n", wait_sum_us / 1000.0 / frames,
+                wait_max_us / 1000.0, (unsigned) frames);
+  return 0;
+}
+
+// Micro-benchmarks take the fastest of BENCH_RUNS runs: single runs of a few ms vary by
+// tens of percent with frequency scaling and scheduling
+const int BENCH_RUNS = 5;
+
+// Wall time of fn() in seconds, best of BENCH_RUNS after one untimed warm-up run
+template<typename Fn> double time_s(Fn &&fn) {
+  fn();
+  double best = 0.0;
+  for (int run = 0; run < BENCH_RUNS; run++) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (run == 0 || s < best)
+      best = s;
+  }
+  return best;
+}
+
+// Parser only: the RX bytes through the old std::vector parser and through FrameParser, both
+// with the echo filter and checksum check of their check_uart_data()
+bool bench_parser(const std::vector<uint8_t> &rx, int passes) {
+  uint32_t old_frames = 0, new_frames = 0;
+  uint32_t old_sink = 0, new_sink = 0;
+  legacy::VectorParser old_parser;
+  double old_s = time_s([&] {
+    for (int pass = 0; pass < passes; pass++) {
+      for (uint8_t byte : rx) {
+        old_parser.feed(byte, [&](const std::vector<uint8_t> &frame) {
+          old_frames++;
+          old_sink += frame[frame.size() - 1];
+        });
+      }
+    }
+  });
+  FrameParser parser;
+  double new_s = time_s([&] {
+    for (int pass = 0; pass < passes; pass++) {
+      for (size_t i = 0; i < rx.size() || parser.has_replay();) {
+        uint8_t byte = parser.has_replay() ? parser.take_replay() : rx[i++];
+        if (parser.feed(byte) != FrameParser::Result::FRAME)
+          continue;
+        FrameView frame = parser.frame();
+        if (frame[1] == CONTROLLER_ID)
+          continue;
+        if (calculate_checksum(frame) != frame[frame.size - 1]) {
+          parser.resync();
+          continue;
+        }
+        new_frames++;
+        new_sink += frame[frame.size - 1];
+      }
+    }
+  });
+  double bytes = static_cast<double>(rx.size()) * passes;
+  std::printf("parser, %u frames per run: vector %.2f ns/byte (%.0f bytes/us), FrameParser %.2f ns/byte (%.0f bytes/us), "
+              "%.1fx\n",
+              (unsigned) (new_frames / (BENCH_RUNS + 1)), old_s * 1e9 / bytes, bytes / (old_s * 1e6), new_s * 1e9 / bytes,
+              bytes / (new_s * 1e6), old_s / new_s);
+  if (old_frames != new_frames || old_sink != new_sink) {
+    std::printf("parser mismatch: vector %u frames, FrameParser %u frames\n", (unsigned) old_frames,
+                (unsigned) new_frames);
+    return false;
+  }
+  return true;
+}
+
+// Scaled fields within float rounding: the old code divided, the FIELDS table multiplies
+bool same_telemetry(const HeaterTelemetry &a, const HeaterTelemetry &b) {
+  auto near = [](float x, float y) { return std::fabs(x - y) <= 1e-3f; };
+  return a.state_raw == b.state_raw && a.power_level == b.power_level && a.voltage_raw == b.voltage_raw &&
+         near(a.input_voltage, b.input_voltage) && near(a.glow_current, b.glow_current) && a.cooling == b.cooling &&
+         a.sub_state == b.sub_state && near(a.heat_exchanger_temperature, b.heat_exchanger_temperature) &&
+         a.state_duration == b.state_duration && a.pump_raw == b.pump_raw &&
+         near(a.pump_frequency, b.pump_frequency) && a.fan_speed == b.fan_speed;
+}
+
+// Status decode only, per heater frame of the capture: the old byte-offset reads on the
+// std::vector frame vs the registry lookup and FIELDS table decode on a FrameView
+bool bench_decode(const std::vector<std::vector<uint8_t>> &frames, int passes) {
+  bool same = true;
+  for (const auto &frame : frames) {
+    HeaterTelemetry old_t{};
+    const FrameLayout *layout = find_frame_layout(FrameView{frame.data(), frame.size()});
+    same &= legacy::decode_status_frame(frame, old_t) && layout != nullptr && layout->decode != nullptr &&
+            same_telemetry(old_t, layout->decode(FrameView{frame.data(), frame.size()}));
+  }
+  if (!same) {
+    std::printf("decode mismatch between the byte-offset and FIELDS decoders\n");
+    return false;
+  }
+  // The per-pass sums go to a volatile so the decodes are not folded away
+  volatile float sink = 0.0f;
+  double old_s = time_s([&] {
+    for (int pass = 0; pass < passes; pass++) {
+      float acc = 0.0f;
+      for (const auto &frame : frames) {
+        HeaterTelemetry t;
+        if (legacy::decode_status_frame(frame, t))
+          acc += t.heat_exchanger_temperature + t.pump_frequency + t.fan_speed + t.state_duration;
+      }
+      sink = sink + acc;
+    }
+  });
+  double table_s = time_s([&] {
+    for (int pass = 0; pass < passes; pass++) {
+      float acc = 0.0f;
+      for (const auto &frame : frames) {
+        FrameView view{frame.data(), frame.size()};
+        if (!HeaterStatusFrame<HeaterLayout0x34>::matches(view))
+          continue;
+        HeaterTelemetry t = HeaterStatusFrame<HeaterLayout0x34>(view).decode();
+        acc += t.heat_exchanger_temperature + t.pump_frequency + t.fan_speed + t.state_duration;
+      }
+      sink = sink + acc;
+    }
+  });
+  // What process_heater_frame() runs: registry lookup, then the layout's decoder through a pointer
+  double registry_s = time_s([&] {
+    for (int pass = 0; pass < passes; pass++) {
+      float acc = 0.0f;
+      for (const auto &frame : frames) {
+        FrameView view{frame.data(), frame.size()};
+        const FrameLayout *layout = find_frame_layout(view);
+        if (layout == nullptr || layout->decode == nullptr)
+          continue;
+        HeaterTelemetry t = layout->decode(view);
+        acc += t.heat_exchanger_temperature + t.pump_frequency + t.fan_speed + t.state_duration;
+      }
+      sink = sink + acc;
+    }
+  });
+  double n = static_cast<double>(frames.size()) * passes;
+  std::printf("decode, %zu frames: byte offsets %.1f ns/frame, FIELDS table %.1f ns/frame, "
+              "registry + FIELDS %.1f ns/frame\n",
+              frames.size(), old_s * 1e9 / n, table_s * 1e9 / n, registry_s * 1e9 / n);
+  return true;
+}
+
+struct TxRequest {
+  uint8_t command;
+  uint8_t power_level;
+  uint8_t state;
+};
+
+// TX frame build, for the capture's TX requests in order: the old per-send std::vector with
+// a full checksum vs ControllerFrame::set() on the static template. Every command/power/state
+// combination is checked against the old frame first, reached from the previous one.
+bool bench_tx(const std::vector<TxRequest> &requests, int passes) {
+  const uint8_t COMMANDS[] = {0x02, 0x06};
+  const uint8_t STATES[] = {0x02, 0x05, 0x06, 0x08, 0x14};
+  ControllerFrame check;
+  uint32_t combinations = 0;
+  bool same = true;
+  for (uint8_t command : COMMANDS) {
+    for (uint8_t power = 0; power <= 10; power++) {
+      for (uint8_t state : STATES) {
+        check.set(command, power, state);
+        std::vector<uint8_t> expected = legacy::build_controller_frame(command, power, state);
+        same &= expected.size() == ControllerFrame::SIZE &&
+                std::memcmp(expected.data(), check.data(), ControllerFrame::SIZE) == 0;
+        combinations++;
+      }
+    }
+  }
+  if (!same) {
+    std::printf("TX mismatch between the vector build and ControllerFrame\n");
+    return false;
+  }
+  if (requests.empty())
+    return true;
+
+  volatile uint8_t sink = 0;
+  double old_s = time_s([&] {
+    for (int pass = 0; pass < passes; pass++) {
+      for (const TxRequest &req : requests) {
+        std::vector<uint8_t> frame = legacy::build_controller_frame(req.command, req.power_level, req.state);
+        sink = frame[frame.size() - 1];
+      }
+    }
+  });
+  ControllerFrame tx;
+  double new_s = time_s([&] {
+    for (int pass = 0; pass < passes; pass++) {
+      for (const TxRequest &req : requests) {
+        tx.set(req.command, req.power_level, req.state);
+        sink = tx.data()[ControllerFrame::SIZE - 1];
+      }
+    }
+  });
+  double n = static_cast<double>(requests.size()) * passes;
+  std::printf("TX build, %zu requests (%u combinations checked): vector %.1f ns/frame, template %.1f ns/frame\n",
+              requests.size(), (unsigned) combinations, old_s * 1e9 / n, new_s * 1e9 / n);
+  return true;
+}
+
+int bench(const std::string &path, int repeat) {
+  std::vector<uint8_t> stream;
+  if (!read_file(path, stream)) {
+    std::fprintf(stderr, "cannot read %s\n", path.c_str());
+    return 1;
+  }
+  // Heater frames only, back to back and all available at once
+  std::vector<uint8_t> rx;
+  std::vector<std::vector<uint8_t>> rx_frames;
+  std::vector<TxRequest> tx_requests;
+  CaptureReader reader(stream.data(), stream.size());
+  CaptureRecord rec;
+  while (reader.next(rec)) {
+    if (rec.type == CaptureRecordType::RX) {
+      rx.insert(rx.end(), rec.payload, rec.payload + rec.len);
+      rx_frames.emplace_back(rec.payload, rec.payload + rec.len);
+    } else if (rec.type == CaptureRecordType::TX && rec.len == ControllerFrame::SIZE) {
+      tx_requests.push_back(TxRequest{rec.payload[ControllerFrame::COMMAND_OFFSET],
+                                      rec.payload[ControllerFrame::POWER_OFFSET],
+                                      rec.payload[ControllerFrame::STATE_OFFSET]});
+    }
+  }
+  HostHeater host_heater;
+  host::set_time_us(1000000);
+  host_heater.setup();
+  for (int i = 0; i < repeat; i++)
+    host::uart_schedule(rx.data(), rx.size(), 0, 0);
+
+  uint32_t frames_before = host_heater.heater.get_link_stats().rx_frames;
+  uint64_t loops = 0;
+  host::use_wall_clock(true);
+  auto start = std::chrono::steady_clock::now();
+  while (host::uart_pending() > 0) {
+    host_heater.heater.loop();
+    loops++;
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  host::use_wall_clock(false);
+  uint32_t frames = host_heater.heater.get_link_stats().rx_frames - frames_before;
+  std::printf("%u frames (%zu bytes) in %.3f s over %llu loop() calls: %.0f frames/s, %.2f us/frame\n",
+              (unsigned) frames, rx.size() * repeat, seconds, (unsigned long long) loops, frames / seconds,
+              seconds * 1e6 / frames);
+  // The component's own drain figure (timed on the same wall clock)
+  host::set_log_hook(host::LOG_CONFIG, [](const char *tag, const char *line) {
+    if (std::strstr(line, "RX Drain:") != nullptr)
+      std::printf("%s\n", line + std::strspn(line, " "));
+  });
+  host_heater.heater.dump_config();
+  host::set_log_hook(host::LOG_NONE, nullptr);
+
+  bool ok = bench_parser(rx, repeat * 20);
+  ok &= bench_decode(rx_frames, repeat * 200);
+  ok &= bench_tx(tx_requests, repeat * 200);
+  return frames > 0 && ok ? 0 : 1;
+}
+
+bool base64_decode(const std::string &in, std::vector<uint8_t> &out) {
+  uint32_t acc = 0;
+  int bits = 0;
+  for (char c : in) {
+    int v;
+    if (c >= 'A' && c <= 'Z') {
+      v = c - 'A';
+    } else if (c >= 'a' && c <= 'z') {
+      v = c - 'a' + 26;
+    } else if (c >= '0' && c <= '9') {
+      v = c - '0' + 52;
+    } else if (c == '+') {
+      v = 62;
+    } else if (c == '/') {
+      v = 63;
+    } else if (c == '=') {
+      break;
+    } else {
+      return false;
+    }
+    acc = (acc << 6) | v;
+    bits += 6;
+    if (bits >= 8) {
+      bits -= 8;
+      out.push_back(static_cast<uint8_t>(acc >> bits));
+    }
+  }
+  return true;
+}
+
+// Cold start of the simulated heater in automatic mode, recorded and dumped through the
+// component's own capture path (the base64 log lines a device would print)
+int record_sim(const std::string &path, uint32_t seconds) {
+  HostHeater host_heater;
+  SunsterHeater &heater = host_heater.heater;
+  SimConfig config;
+  heater.set_simulation(config);
+  heater.set_capture_buffer_size(65536);
+  heater.set_control_mode(ControlMode::AUTOMATIC);
+  heater.set_target_temperature(20.0f);
+
+  host::set_time_us(1000000);
+  host_heater.setup();
+  host_heater.external_temperature.publish_state(heater.get_simulated_temperature());
+  host_heater.run_for_ms(2000);  // first status frame (boot sync) before the start request
+  heater.turn_on();
+  // Template sensor on the simulated cabin with a 10 s update interval
+  for (uint32_t t = 0; t < seconds; t += 10) {
+    host_heater.run_for_ms(10000);
+    host_heater.external_temperature.publish_state(heater.get_simulated_temperature());
+  }
+
+  std::vector<uint8_t> stream;
+  bool done = false;
+  host::set_log_hook(host::LOG_INFO, [&](const char *tag, const char *line) {
+    if (std::strncmp(line, "[capture] ", 10) != 0)
+      return;
+    std::string payload(line + 10);
+    if (payload == "end") {
+      done = true;
+    } else if (payload.compare(0, 5, "begin") != 0) {
+      base64_decode(payload, stream);
+    }
+  });
+  heater.dump_capture();
+  while (!done)
+    host_heater.run_for_ms(HostHeater::LOOP_MS);
+  host::set_log_hook(host::LOG_NONE, nullptr);
+
+  if (!write_file(path, stream)) {
+    std::fprintf(stderr, "cannot write %s\n", path.c_str());
+    return 1;
+  }
+  std::printf("recorded %zu bytes (%u s simulated)\n", stream.size(), (unsigned) seconds);
+  return 0;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  if (argc >= 3 && std::strcmp(argv[1], "--bench") == 0)
+    return bench(argv[2], argc >= 4 ? std::atoi(argv[3]) : 20);
+  if (argc >= 3 && std::strcmp(argv[1], "--record-sim") == 0)
+    return record_sim(argv[2], argc >= 4 ? static_cast<uint32_t>(std::atoi(argv[3])) : 360);
+  if (argc == 2 && argv[1][0] != '-')
+    return replay(argv[1]);
+  std::fprintf(stderr,
+               "usage: %s <capture.bin>\n"
+               "       %s --bench <capture.bin> [repeat]\n"
+               "       %s --record-sim <out.bin> [seconds]\n",
+               argv[0], argv[0], argv[0]);
+  return 2;
+}
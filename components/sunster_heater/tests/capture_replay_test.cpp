@@ -0,0 +1,128 @@
+// Replays the committed capture fixture and checks the decoded output.
+//
+// fixtures/sim_cold_start.bin is a 6 min cold start in automatic mode (target 20 C from 5 C),
+// recorded with `capture_replay --record-sim` through the component's capture ring and
+// base64 dump. Regenerating it changes the expected values below.
+
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "host_harness.h"
+
+using namespace esphome;
+using namespace esphome::sunster_heater;
+using namespace esphome::sunster_heater::testing;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+#define CHECK_NEAR(a, b, tol) \
+  do { \
+    if (!(std::fabs((a) - (b)) <= (tol))) { \
+      std::printf("%s:%d: CHECK_NEAR failed: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, #a, (double) (a), \
+                  (double) (b), (double) (tol)); \
+      failures++; \
+    } \
+  } while (0)
+
+// Frame by frame: every RX record is a valid heater_0x34 frame and the heater walks
+// OFF -> POLLING_STATE -> HEATING_UP -> STABLE_COMBUSTION exactly once
+static void check_frames(const std::vector<uint8_t> &stream, double &expected_fuel_ml) {
+  CaptureReader reader(stream.data(), stream.size());
+  CHECK(reader.is_valid());
+  CaptureRecord rec;
+  uint32_t frames = 0;
+  std::vector<uint8_t> states;
+  std::vector<uint32_t> transitions;
+  HeaterTelemetry last{};
+  uint32_t last_ms = 0;
+  expected_fuel_ml = 0.0;
+  while (reader.next(rec)) {
+    if (rec.type != CaptureRecordType::RX)
+      continue;
+    FrameView frame{rec.payload, rec.len};
+    const FrameLayout *layout = find_frame_layout(frame);
+    CHECK(layout != nullptr && layout->decode != nullptr);
+    if (layout == nullptr || layout->decode == nullptr)
+      return;
+    CHECK(calculate_checksum(frame) == frame[frame.size - 1]);
+    HeaterTelemetry t = layout->decode(frame);
+    frames++;
+    if (states.empty() || t.state_raw != states.back()) {
+      states.push_back(t.state_raw);
+      transitions.push_back(frames);
+    }
+    // Independent trapezoid of the reported pump frequency at the default 0.022 ml/pulse
+    if (frames > 1)
+      expected_fuel_ml += (last.pump_frequency + t.pump_frequency) / 2.0 * (rec.time_ms - last_ms) / 1000.0 * 0.022;
+    last = t;
+    last_ms = rec.time_ms;
+  }
+  CHECK(!reader.is_truncated());
+  CHECK(frames == 362);
+  CHECK((states == std::vector<uint8_t>{0x00, 0x01, 0x02, 0x03}));
+  CHECK((transitions == std::vector<uint32_t>{1, 2, 43, 123}));
+  CHECK(last.state_raw == 0x03);
+  CHECK(last.power_level == 10);
+  CHECK_NEAR(last.input_voltage, 12.8f, 0.01f);
+  CHECK_NEAR(last.heat_exchanger_temperature, 188.4f, 0.01f);
+  CHECK_NEAR(last.pump_frequency, 5.5f, 0.01f);
+  CHECK(last.fan_speed == 4800);
+  CHECK(last.state_duration == 239);
+}
+
+// Through the component: UART at wire speed, parser, decode, sensors and fuel integration
+static void check_replay(const std::vector<uint8_t> &stream, double expected_fuel_ml) {
+  HostHeater host_heater;
+  sensor::Sensor exchanger, pump, fan, voltage;
+  host_heater.heater.set_heat_exchanger_temperature_sensor(&exchanger);
+  host_heater.heater.set_pump_frequency_sensor(&pump);
+  host_heater.heater.set_fan_speed_sensor(&fan);
+  host_heater.heater.set_input_voltage_sensor(&voltage);
+
+  ReplayCounts counts;
+  CHECK(replay_capture(host_heater, stream, counts));
+  CHECK(counts.rx_records == 362);
+  CHECK(counts.tx_records == 362);
+  CHECK(counts.temperature_records == 37);
+
+  const SunsterHeater &heater = host_heater.heater;
+  const LinkStats &link = heater.get_link_stats();
+  CHECK(link.rx_frames == counts.rx_records);
+  CHECK(link.checksum_failures == 0);
+  CHECK(link.resyncs == 0);
+  CHECK(link.partial_timeouts == 0);
+  CHECK(heater.get_heater_state() == HeaterState::STABLE_COMBUSTION);
+  CHECK_NEAR(exchanger.state, 188.4f, 0.05f);
+  CHECK_NEAR(pump.state, 5.5f, 0.01f);
+  CHECK_NEAR(fan.state, 4800.0f, 0.5f);
+  CHECK_NEAR(voltage.state, 12.8f, 0.01f);
+  CHECK(heater.get_cycle_cost_tracker().starts() == 1);
+  CHECK_NEAR(heater.get_total_consumption(), expected_fuel_ml, expected_fuel_ml * 0.005);
+  std::printf("replayed %u frames, %.2f ml (frames: %.2f ml)\n", (unsigned) link.rx_frames,
+              heater.get_total_consumption(), expected_fuel_ml);
+}
+
+int main(int argc, char **argv) {
+  if (argc != 2) {
+    std::fprintf(stderr, "usage: %s <fixtures/sim_cold_start.bin>\n", argv[0]);
+    return 2;
+  }
+  std::vector<uint8_t> stream;
+  if (!read_file(argv[1], stream)) {
+    std::fprintf(stderr, "cannot read %s\n", argv[1]);
+    return 2;
+  }
+  double expected_fuel_ml;
+  check_frames(stream, expected_fuel_ml);
+  check_replay(stream, expected_fuel_ml);
+  std::printf("%s\n", failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,108 @@
+// Fuel counting: FuelCounter stays exact over 200 days of pumping, and the v1 float record is
+// migrated with the saved injected_per_pulse rather than the YAML one.
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "esphome/components/time/real_time_clock.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/preferences.h"
+#include "host_harness.h"
+
+using namespace esphome;
+using namespace esphome::sunster_heater;
+using namespace esphome::sunster_heater::testing;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+#define CHECK_NEAR(a, b, tol) \
+  do { \
+    if (!(std::fabs((a) - (b)) <= (tol))) { \
+      std::printf("%s:%d: CHECK_NEAR failed: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, #a, (double) (a), \
+                  (double) (b), (double) (tol)); \
+      failures++; \
+    } \
+  } while (0)
+
+namespace {
+
+// 200 days at 3.3 Hz with frames 900..1100 ms apart. The reference is the same trapezoid in
+// plain integer arithmetic over the whole run; the float accumulator is the old total.
+void check_200_days() {
+  const uint8_t PUMP_RAW = 33;
+  const uint64_t DURATION_MS = 200ULL * 86400ULL * 1000ULL;
+  std::mt19937 rng(200);
+  FuelCounter counter;
+  uint64_t milli_pulses = 0;
+  uint64_t scaled = 0;  // sum of (f0 + f1) * dt, in 1/20 milli-pulse
+  float float_pulses = 0.0f;
+  uint64_t frames = 0;
+  for (uint64_t t = 0; t < DURATION_MS; frames++) {
+    uint32_t dt = 900 + rng() % 201;
+    milli_pulses += counter.integrate(PUMP_RAW, PUMP_RAW, dt);
+    scaled += static_cast<uint64_t>(PUMP_RAW + PUMP_RAW) * dt;
+    float_pulses += PUMP_RAW * 0.1f * (dt / 1000.0f);
+    t += dt;
+  }
+  uint64_t expected = scaled / 20;
+  double exact_pulses = FuelCounter::to_pulses(expected);
+  double drift = (float_pulses - exact_pulses) / exact_pulses;
+  std::printf("200 days: %llu frames, %.3f pulses exact, counter %.3f, float %.0f (%+.2f %%)\n",
+              (unsigned long long) frames, exact_pulses, FuelCounter::to_pulses(milli_pulses), float_pulses,
+              drift * 100.0);
+  CHECK(milli_pulses == expected);
+  CHECK(std::fabs(drift) > 0.01);  // the float total is visibly off
+}
+
+// A v1 record converted on the first boot of the new firmware: the daily ml goes back to
+// pulses with the injected_per_pulse saved from the number entity, not the YAML default
+void check_legacy_migration() {
+  const uint32_t EPOCH_S = 19800u * 86400u + 12u * 3600u;
+  time::RealTimeClock clock;
+  host::preferences_clear();
+  host::uart_clear();
+  host::set_epoch(EPOCH_S);
+  host::set_time_us(1000000);
+
+  {
+    HostHeater host_heater;
+    host_heater.heater.set_time_component(&clock);
+    host_heater.setup();
+    host_heater.external_temperature.publish_state(20.0f);
+    host_heater.heater.set_injected_per_pulse(0.030f);
+    host_heater.heater.save_config_preferences();
+    host_heater.run_for_ms(60000);
+  }
+  FuelConsumptionDataV2 v2;
+  CHECK(!global_preferences->make_preference<FuelConsumptionDataV2>(fnv1_hash("fuel_consumption_v2")).load(&v2));
+  FuelConsumptionData legacy{3.0f, EPOCH_S / 86400u, 1000.0f};
+  CHECK(global_preferences->make_preference<FuelConsumptionData>(fnv1_hash("fuel_consumption")).save(&legacy));
+
+  HostHeater host_heater;  // YAML injected_per_pulse stays at the 0.022 default
+  host_heater.heater.set_time_component(&clock);
+  host_heater.setup();
+  CHECK_NEAR(host_heater.heater.get_injected_per_pulse(), 0.030f, 1e-6f);
+  CHECK_NEAR(host_heater.heater.get_daily_consumption(), 3.0f, 0.001f);
+  CHECK_NEAR(host_heater.heater.get_total_consumption(), 1000.0f * 0.030f, 0.001f);
+  std::printf("migration: daily %.3f ml, total %.3f ml at %.3f ml/pulse\n",
+              host_heater.heater.get_daily_consumption(), host_heater.heater.get_total_consumption(),
+              host_heater.heater.get_injected_per_pulse());
+  host::set_epoch(0);
+}
+
+}  // namespace
+
+int main() {
+  check_200_days();
+  check_legacy_migration();
+  std::printf("%s\n", failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
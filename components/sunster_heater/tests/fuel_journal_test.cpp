@@ -0,0 +1,238 @@
+// Fuel journal: the counters survive reboots at random points and day changes.
+//
+// The journal part replays the ring (fuel_journal.h) against a reference model after every
+// simulated power cut and requires the exact totals of the records written so far. The
+// component part burns the simulated heater across midnight and reboots the component on
+// the same preferences: after a clean stop the counters come back exactly, after a power cut
+// mid-burn at most the unjournaled pulses are lost.
+
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "esphome/components/time/real_time_clock.h"
+#include "host_harness.h"
+
+using namespace esphome;
+using namespace esphome::sunster_heater;
+using namespace esphome::sunster_heater::testing;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+#define CHECK_NEAR(a, b, tol) \
+  do { \
+    if (!(std::fabs((a) - (b)) <= (tol))) { \
+      std::printf("%s:%d: CHECK_NEAR failed: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, #a, (double) (a), \
+                  (double) (b), (double) (tol)); \
+      failures++; \
+    } \
+  } while (0)
+
+namespace {
+
+// Storage as the component uses it: one base snapshot plus the ring of slots. A write either
+// lands completely or not at all (a preference save).
+struct Flash {
+  FuelTotals base{0, 0, 0};
+  uint32_t base_seq{0};
+  bool has_base{false};
+  FuelJournalRecord slots[FuelJournal::SLOTS]{};
+};
+
+// Journal writer with the component's policy: append deltas, rewrite the base when the ring
+// is full and at day changes
+struct Writer {
+  FuelJournal journal;
+  FuelTotals live{0, 0, 0};      // in RAM, lost on a power cut
+  FuelTotals written{0, 0, 0};   // what the flash holds
+  uint64_t journaled_total{0};
+
+  void boot(Flash &flash, uint32_t today) {
+    FuelTotals totals = flash.has_base ? flash.base : FuelTotals{0, 0, 0};
+    journal.replay(flash.has_base ? flash.base_seq : 0, totals, flash.slots);
+    if (totals.day != today) {
+      totals.day = today;
+      totals.daily_milli_pulses = 0;
+    }
+    live = totals;
+    journaled_total = live.total_milli_pulses;
+  }
+  void count(uint32_t milli_pulses) {
+    live.daily_milli_pulses += milli_pulses;
+    live.total_milli_pulses += milli_pulses;
+  }
+  void new_day(Flash &flash, uint32_t today) {
+    live.day = today;
+    live.daily_milli_pulses = 0;
+    this->save_base(flash);
+  }
+  void save_base(Flash &flash) {
+    flash.base = live;
+    flash.base_seq = journal.last_seq();
+    flash.has_base = true;
+    journal.compacted();
+    journaled_total = live.total_milli_pulses;
+    written = live;
+  }
+  void flush(Flash &flash) {
+    uint64_t delta = live.total_milli_pulses - journaled_total;
+    if (delta == 0)
+      return;
+    if (journal.needs_compaction()) {
+      this->save_base(flash);
+      return;
+    }
+    FuelJournalRecord rec;
+    size_t slot = journal.append(live.day, static_cast<uint32_t>(delta), rec);
+    flash.slots[slot] = rec;
+    journaled_total = live.total_milli_pulses;
+    written = live;
+  }
+};
+
+void check_journal_replay() {
+  std::mt19937 rng(20240611);
+  Flash flash;
+  Writer writer;
+  uint32_t day = 19800;
+  writer.boot(flash, day);
+  uint32_t reboots = 0, day_changes = 0, records = 0;
+
+  for (uint32_t step = 0; step < 200000; step++) {
+    uint32_t r = rng() % 1000;
+    if (r < 2) {
+      // Power cut: everything not on flash is gone; the next boot must see exactly the rest.
+      // Sometimes it stays off across midnight.
+      FuelTotals expected = writer.written;
+      day += rng() % 4 == 0 ? 1 + rng() % 3 : 0;
+      Writer rebooted;
+      rebooted.boot(flash, day);
+      if (expected.day != day)
+        expected.daily_milli_pulses = 0;
+      CHECK(rebooted.live.total_milli_pulses == expected.total_milli_pulses);
+      CHECK(rebooted.live.daily_milli_pulses == expected.daily_milli_pulses);
+      writer = rebooted;
+      reboots++;
+    } else if (r < 4) {
+      writer.new_day(flash, ++day);
+      day_changes++;
+    } else if (r < 300) {
+      writer.flush(flash);
+      records++;
+    } else {
+      writer.count(rng() % 60000);  // up to 60 pulses between records
+    }
+  }
+  std::printf("journal: %u reboots, %u day changes, %u flushes, seq %u, total %llu milli-pulses\n",
+              (unsigned) reboots, (unsigned) day_changes, (unsigned) records, (unsigned) writer.journal.last_seq(),
+              (unsigned long long) writer.live.total_milli_pulses);
+  CHECK(reboots > 100);
+  CHECK(day_changes > 50);
+}
+
+// Component, same preferences across instances. Virtual time 0 is 23:40 UTC, so the first
+// burn crosses midnight.
+const uint32_t EPOCH_S = 19800u * 86400u + 23u * 3600u + 2400u;
+// Unjournaled pulses a power cut may lose: one record threshold plus the frames until the
+// next commit, at 0.022 ml/pulse
+const float MAX_LOSS_ML = (FUEL_JOURNAL_MIN_DELTA_MP / 1000.0f + 20.0f) * 0.022f;
+
+struct Counters {
+  float daily_ml;
+  float total_ml;
+  uint32_t day;
+};
+
+uint32_t virtual_day() { return static_cast<uint32_t>((EPOCH_S + host::time_us() / 1000000) / 86400); }
+
+void check_component_reboots() {
+  std::mt19937 rng(4711);
+  time::RealTimeClock clock;
+  host::preferences_clear();
+  host::uart_clear();
+  host::set_epoch(EPOCH_S);
+  host::set_time_us(1000000);
+
+  Counters before{0.0f, 0.0f, virtual_day()};
+  bool clean = true;
+  uint32_t clean_reboots = 0, cut_reboots = 0, days = 0;
+  float burnt_ml = 0.0f;
+
+  for (int boot = 0; boot < 24; boot++) {
+    HostHeater host_heater;
+    SunsterHeater &heater = host_heater.heater;
+    heater.set_time_component(&clock);
+    SimConfig config;
+    heater.set_simulation(config);
+    heater.set_control_mode(ControlMode::MANUAL);
+    host_heater.setup();
+    host_heater.external_temperature.publish_state(5.0f);
+
+    Counters after{heater.get_daily_consumption(), heater.get_total_consumption(), virtual_day()};
+    float expected_daily = after.day == before.day ? before.daily_ml : 0.0f;
+    if (clean) {
+      CHECK(after.total_ml == before.total_ml);
+      CHECK(after.daily_ml == expected_daily);
+      clean_reboots++;
+    } else {
+      CHECK(after.total_ml <= before.total_ml);
+      CHECK_NEAR(after.total_ml, before.total_ml, MAX_LOSS_ML);
+      CHECK_NEAR(after.daily_ml, expected_daily, MAX_LOSS_ML);
+      cut_reboots++;
+    }
+
+    // Burn 20..60 min, then either stop cleanly and let it cool down, or cut the power
+    host_heater.run_for_ms(2000);
+    heater.turn_on();
+    uint32_t burn_s = 1200 + rng() % 2400;
+    uint32_t day = virtual_day();
+    float daily_peak = 0.0f;
+    for (uint32_t t = 0; t < burn_s; t += 10) {
+      host_heater.run_for_ms(10000);
+      host_heater.external_temperature.publish_state(5.0f);
+      if (virtual_day() != day) {
+        // The daily counter restarts with the day; the total keeps counting
+        host_heater.run_for_ms(2000);
+        CHECK(heater.get_daily_consumption() < daily_peak);
+        day = virtual_day();
+        days++;
+      }
+      daily_peak = heater.get_daily_consumption();
+    }
+    clean = rng() % 3 != 0;
+    if (clean) {
+      heater.turn_off();
+      host_heater.run_for_ms(300000);
+      CHECK(heater.get_heater_state() == HeaterState::OFF);
+    } else {
+      host_heater.run_for_ms(rng() % 10000);  // cut anywhere between two frames
+    }
+    burnt_ml += heater.get_total_consumption() - after.total_ml;
+    before = Counters{heater.get_daily_consumption(), heater.get_total_consumption(), virtual_day()};
+
+    // Switched off for up to a day: some boots land on a later day than their last record
+    host::advance_ms((rng() % 86400) * 1000u);
+  }
+  std::printf("component: %u clean reboots, %u power cuts, %u midnights while burning, %.1f ml burnt\n",
+              (unsigned) clean_reboots, (unsigned) cut_reboots, (unsigned) days, burnt_ml);
+  CHECK(clean_reboots > 5);
+  CHECK(cut_reboots > 3);
+  CHECK(days >= 1);
+  host::set_epoch(0);
+}
+
+}  // namespace
+
+int main() {
+  check_journal_replay();
+  check_component_reboots();
+  std::printf("%s\n", failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}
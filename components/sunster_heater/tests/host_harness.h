@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "host.h"
+#include "sunster_heater.h"
+
+namespace esphome {
+namespace sunster_heater {
+namespace testing {
+
+// A SunsterHeater on the host. loop() runs every LOOP_MS and update() every update interval
+// on the virtual clock, like the ESPHome main loop with a 16 ms loop interval.
+class HostHeater {
+ public:
+  static constexpr uint32_t LOOP_MS = 16;
+  static constexpr uint32_t BAUD_RATE = 4800;
+  static constexpr uint32_t BYTE_US = 10 * 1000000 / BAUD_RATE;  // 8N1 = 10 bits per byte
+
+  HostHeater() {
+    uart_.set_baud_rate(BAUD_RATE);
+    heater.set_uart_parent(&uart_);
+    heater.set_update_interval(1000);
+    heater.set_external_temperature_sensor(&external_temperature);
+  }
+
+  void setup() {
+    heater.setup();
+    next_loop_us_ = host::time_us();
+    next_update_us_ = host::time_us() + heater.get_update_interval() * 1000ULL;
+  }
+
+  // Runs loop()/update() until the virtual clock reaches until_us
+  void run_until(uint64_t until_us) {
+    while (true) {
+      uint64_t next = next_loop_us_ < next_update_us_ ? next_loop_us_ : next_update_us_;
+      if (next > until_us)
+        break;
+      host::set_time_us(next);
+      if (next == next_update_us_) {
+        heater.update();
+        next_update_us_ += heater.get_update_interval() * 1000ULL;
+      } else {
+        heater.loop();
+        next_loop_us_ += LOOP_MS * 1000ULL;
+      }
+    }
+    host::set_time_us(until_us);
+  }
+  void run_for_ms(uint32_t ms) { this->run_until(host::time_us() + ms * 1000ULL); }
+
+  SunsterHeater heater;
+  sensor::Sensor external_temperature;
+
+ protected:
+  uart::UARTComponent uart_;
+  uint64_t next_loop_us_{0};
+  uint64_t next_update_us_{0};
+};
+
+// Virtual time of a capture record (the device's millis() at recording)
+inline uint64_t record_us(const CaptureRecord &rec) { return static_cast<uint64_t>(rec.time_ms) * 1000; }
+
+inline bool read_file(const std::string &path, std::vector<uint8_t> &out) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in)
+    return false;
+  out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+  return true;
+}
+
+inline bool write_file(const std::string &path, const std::vector<uint8_t> &data) {
+  std::ofstream out(path, std::ios::binary);
+  out.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+  return static_cast<bool>(out);
+}
+
+// Replays a capture through the component: RX frames arrive on the UART at wire speed so
+// their last byte lands at the recorded time, temperature samples are published on the
+// external sensor at theirs. TX records are the device's own frames and are not replayed.
+struct ReplayCounts {
+  uint32_t rx_records{0};
+  uint32_t tx_records{0};
+  uint32_t temperature_records{0};
+};
+
+inline bool replay_capture(HostHeater &host_heater, const std::vector<uint8_t> &stream, ReplayCounts &counts,
+                           uint32_t tail_ms = 1000) {
+  CaptureReader reader(stream.data(), stream.size());
+  if (!reader.is_valid())
+    return false;
+  // Schedule every RX byte up front; the UART stand-in releases each at its arrival time
+  CaptureRecord rec;
+  uint64_t start_us = UINT64_MAX;
+  while (reader.next(rec)) {
+    uint64_t wire_us = static_cast<uint64_t>(rec.len) * HostHeater::BYTE_US;
+    uint64_t first_us = record_us(rec) > wire_us ? record_us(rec) - wire_us : 0;
+    if (first_us < start_us)
+      start_us = first_us;
+    if (rec.type == CaptureRecordType::RX) {
+      host::uart_schedule(rec.payload, rec.len, first_us, HostHeater::BYTE_US);
+      counts.rx_records++;
+    } else if (rec.type == CaptureRecordType::TX) {
+      counts.tx_records++;
+    }
+  }
+  if (reader.is_truncated())
+    std::fprintf(stderr, "capture is truncated, replaying the complete records\n");
+  if (start_us == UINT64_MAX)
+    return true;
+
+  host::set_time_us(start_us);
+  host_heater.setup();
+  CaptureReader samples(stream.data(), stream.size());
+  uint64_t end_us = start_us;
+  while (samples.next(rec)) {
+    end_us = record_us(rec);
+    if (rec.type != CaptureRecordType::TEMPERATURE)
+      continue;
+    host_heater.run_until(record_us(rec));
+    host_heater.external_temperature.publish_state(CaptureReader::temperature(rec));
+    counts.temperature_records++;
+  }
+  host_heater.run_until(end_us + tail_ms * 1000ULL);
+  return true;
+}
+
+}  // namespace testing
+}  // namespace sunster_heater
+}  // namespace esphome
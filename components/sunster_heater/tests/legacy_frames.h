@@ -0,0 +1,128 @@
+#pragma once
+
+// The frame handling this component had before the fixed-buffer rework, kept only as the
+// reference side of `capture_replay --bench`. Copied from the original sources with the
+// ESPHome calls removed; not used by the component.
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "heater_frame.h"
+
+namespace esphome {
+namespace sunster_heater {
+namespace legacy {
+
+static const uint8_t FRAME_START = 0xAA;
+static const uint8_t CONTROLLER_ID = 0x66;
+static const uint8_t CONTROLLER_FRAME_LENGTH = 0x0B;
+static const uint8_t HEATER_FRAME_LENGTH = 0x34;
+
+inline uint8_t calculate_checksum(const std::vector<uint8_t> &frame) {
+  if (frame.size() < 4) {
+    return 0;
+  }
+  uint32_t sum = 0;
+  for (size_t i = 2; i < frame.size() - 1; ++i) {
+    sum += frame[i];
+  }
+  return static_cast<uint8_t>(sum % 256);
+}
+
+// check_uart_data() with the std::vector RX buffer: sync on 0xAA, size from the length byte,
+// echo filter and checksum check. on_frame(const std::vector<uint8_t> &) gets each valid
+// heater frame.
+class VectorParser {
+ public:
+  template<typename OnFrame> void feed(uint8_t byte, OnFrame &&on_frame) {
+    if (!frame_sync_ && byte == FRAME_START) {
+      rx_buffer_.clear();
+      rx_buffer_.push_back(byte);
+      frame_sync_ = true;
+      return;
+    }
+    if (!frame_sync_)
+      return;
+    rx_buffer_.push_back(byte);
+    if (rx_buffer_.size() < 4)
+      return;
+    uint8_t expected_length = (rx_buffer_[3] == HEATER_FRAME_LENGTH) ? 57 : 16;
+    if (rx_buffer_.size() >= expected_length) {
+      if (rx_buffer_[1] != CONTROLLER_ID && this->validate_frame_(expected_length))
+        on_frame(rx_buffer_);
+      rx_buffer_.clear();
+      frame_sync_ = false;
+    } else if (rx_buffer_.size() > expected_length + 10u) {
+      rx_buffer_.clear();
+      frame_sync_ = false;
+    }
+  }
+
+ protected:
+  bool validate_frame_(uint8_t expected_length) const {
+    if (rx_buffer_.size() != expected_length || rx_buffer_[0] != FRAME_START)
+      return false;
+    return calculate_checksum(rx_buffer_) == rx_buffer_[rx_buffer_.size() - 1];
+  }
+
+  std::vector<uint8_t> rx_buffer_;
+  bool frame_sync_{false};
+};
+
+inline uint16_t read_uint16_be(const std::vector<uint8_t> &data, size_t offset) {
+  if (offset + 1 >= data.size()) {
+    return 0;
+  }
+  return (static_cast<uint16_t>(data[offset]) << 8) | data[offset + 1];
+}
+
+// The byte-offset reads of process_heater_frame() and update_sensors(), with their size
+// checks, collected into the telemetry struct the FIELDS decoder fills. glow_current and
+// sub_state were only read by the passive sniff decode log.
+inline bool decode_status_frame(const std::vector<uint8_t> &frame, HeaterTelemetry &t) {
+  if (frame[3] != HEATER_FRAME_LENGTH || frame.size() < 57)
+    return false;
+  t.state_raw = frame[5];
+  t.power_level = frame[6];
+  t.voltage_raw = frame.size() > 11 ? read_uint16_be(frame, 10) : 0;
+  t.input_voltage = t.voltage_raw / 10.0f;
+  t.glow_current = frame[13] / 100.0f;
+  t.cooling = frame[14] != 0;
+  t.sub_state = frame.size() > 15 ? frame[15] : 0;
+  t.heat_exchanger_temperature =
+      frame.size() > 17 ? static_cast<int16_t>(read_uint16_be(frame, 16)) / 10.0f : 0.0f;
+  t.state_duration = frame.size() > 21 ? read_uint16_be(frame, 20) : 0;
+  t.pump_raw = frame.size() > 23 ? frame[23] : 0;
+  t.pump_frequency = t.pump_raw / 10.0f;
+  t.fan_speed = frame.size() > 29 ? read_uint16_be(frame, 28) : 0;
+  return true;
+}
+
+// send_controller_frame(): a fresh std::vector per send, filled byte by byte, then the
+// checksum over the whole frame. The command/state selection is the caller's.
+inline std::vector<uint8_t> build_controller_frame(uint8_t command, uint8_t power_level, uint8_t state) {
+  std::vector<uint8_t> frame;
+  frame.push_back(FRAME_START);
+  frame.push_back(CONTROLLER_ID);
+  frame.push_back(command);
+  frame.push_back(CONTROLLER_FRAME_LENGTH);
+  frame.push_back(0x00);
+  frame.push_back(0x00);
+  frame.push_back(0x00);
+  frame.push_back(0x00);
+  frame.push_back(power_level);
+  frame.push_back(state);
+  frame.push_back(0x00);
+  frame.push_back(0x00);
+  frame.push_back(0x00);
+  frame.push_back(0x00);
+  frame.push_back(0x00);
+  uint8_t checksum = calculate_checksum(frame);
+  frame.push_back(checksum);
+  return frame;
+}
+
+}  // namespace legacy
+}  // namespace sunster_heater
+}  // namespace esphome
@@ -0,0 +1,147 @@
+// Closed-loop scenarios: the component in automatic mode (PI, scheduler, start/stop logic)
+// drives the simulated heater and cabin on a virtual clock. The external sensor is a
+// template sensor on the simulated cabin sensor with a 10 s update interval.
+//
+//   sim_scenarios            run all scenarios, print the metrics, exit 1 if a limit is missed
+//   sim_scenarios <name>     run one scenario
+
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "host_harness.h"
+
+using namespace esphome;
+using namespace esphome::sunster_heater;
+using namespace esphome::sunster_heater::testing;
+
+namespace {
+
+struct Scenario {
+  const char *name;
+  const char *description;
+  float ambient_c;
+  float initial_c;
+  float target_c;
+  uint32_t duration_s;
+  uint32_t step_at_s;      // 0 = no setpoint step
+  float step_target_c;
+  uint32_t dropout_at_s;   // 0 = no sensor dropout; the sensor stops publishing
+  uint32_t dropout_s;
+  // Limits (NAN = not checked)
+  float max_overshoot_c;
+  float max_settle_s;
+  float max_dropout_rise_c;  // cabin above the target while the sensor is silent
+  bool stop_in_dropout;      // a dropout longer than the grace period shuts the heater down
+};
+
+const Scenario SCENARIOS[] = {
+    // name, description, ambient, initial, target, duration, step at, step to, dropout at, dropout for,
+    // max overshoot, max settle time, max rise in dropout, stop in dropout
+    {"cold_start", "-10 C outside and in the cabin, target 20 C", -10.0f, -10.0f, 20.0f, 7200, 0, NAN, 0, 0, 1.0f,
+     3600.0f, NAN, false},
+    {"setpoint_step", "-10 C outside, 20 C, step to 23 C after 2 h", -10.0f, -10.0f, 20.0f, 10800, 7200, 23.0f, 0, 0,
+     1.0f, 1800.0f, NAN, false},
+    {"sensor_dropout", "-10 C outside, 20 C, sensor silent 20 min after 2 h", -10.0f, -10.0f, 20.0f, 10800, 0, NAN,
+     7200, 1200, 1.0f, NAN, 0.5f, true},
+};
+
+struct Result {
+  SimMetrics metrics;
+  float max_cabin_c{-100.0f};
+  float dropout_max_cabin_c{NAN};
+  bool stopped_in_dropout{false};
+};
+
+Result run(const Scenario &scenario) {
+  HostHeater host_heater;
+  SunsterHeater &heater = host_heater.heater;
+  SimConfig config;
+  config.ambient_c = scenario.ambient_c;
+  config.initial_c = scenario.initial_c;
+  heater.set_simulation(config);
+  heater.set_control_mode(ControlMode::AUTOMATIC);
+  heater.set_target_temperature(scenario.target_c);
+
+  host::set_time_us(1000000);
+  host_heater.setup();
+  host_heater.external_temperature.publish_state(heater.get_simulated_temperature());
+  host_heater.run_for_ms(2000);  // first status frame (boot sync) before the start request
+  heater.turn_on();
+
+  Result result;
+  for (uint32_t t = 10; t <= scenario.duration_s; t += 10) {
+    host_heater.run_for_ms(10000);
+    const HeaterSimulator &sim = *heater.get_simulator();
+    if (sim.cabin_temperature() > result.max_cabin_c)
+      result.max_cabin_c = sim.cabin_temperature();
+
+    bool dropout =
+        scenario.dropout_s > 0 && t > scenario.dropout_at_s && t <= scenario.dropout_at_s + scenario.dropout_s;
+    if (dropout) {
+      if (std::isnan(result.dropout_max_cabin_c) || sim.cabin_temperature() > result.dropout_max_cabin_c)
+        result.dropout_max_cabin_c = sim.cabin_temperature();
+      if (sim.state() == HeaterSimulator::COOLING || sim.state() == HeaterSimulator::OFF)
+        result.stopped_in_dropout = true;
+    } else {
+      host_heater.external_temperature.publish_state(heater.get_simulated_temperature());
+    }
+    if (scenario.step_at_s != 0 && t == scenario.step_at_s)
+      heater.set_target_temperature(scenario.step_target_c);
+  }
+  result.metrics = heater.get_simulator()->metrics();
+  return result;
+}
+
+bool report(const Scenario &scenario, const Result &result) {
+  const SimMetrics &m = result.metrics;
+  std::printf("%-15s %-52s overshoot %5.2f C  settled %s", scenario.name, scenario.description, m.overshoot_c,
+              std::isnan(m.settled_at_s) ? "   never" : "");
+  if (!std::isnan(m.settled_at_s))
+    std::printf("%6.0f s", m.settled_at_s);
+  std::printf("  fuel %6.1f ml  starts %u", m.fuel_ml, (unsigned) m.starts);
+  if (scenario.dropout_s > 0)
+    std::printf("  dropout: max cabin %.2f C, stopped %s", result.dropout_max_cabin_c,
+                result.stopped_in_dropout ? "yes" : "no");
+  std::printf("\n");
+
+  bool ok = true;
+  if (!std::isnan(scenario.max_overshoot_c) && !(m.overshoot_c <= scenario.max_overshoot_c)) {
+    std::printf("  FAIL: overshoot above %.2f C\n", scenario.max_overshoot_c);
+    ok = false;
+  }
+  if (!std::isnan(scenario.max_settle_s) && !(m.settled_at_s <= scenario.max_settle_s)) {
+    std::printf("  FAIL: not settled within %.0f s\n", scenario.max_settle_s);
+    ok = false;
+  }
+  if (!std::isnan(scenario.max_dropout_rise_c) &&
+      !(result.dropout_max_cabin_c <= scenario.target_c + scenario.max_dropout_rise_c)) {
+    std::printf("  FAIL: cabin more than %.2f C above the target during the dropout\n", scenario.max_dropout_rise_c);
+    ok = false;
+  }
+  if (scenario.stop_in_dropout && !result.stopped_in_dropout) {
+    std::printf("  FAIL: heater still running at the end of the dropout\n");
+    ok = false;
+  }
+  return ok;
+}
+
+}  // namespace
+
+int main(int argc, char **argv) {
+  bool ok = true;
+  bool found = false;
+  for (const Scenario &scenario : SCENARIOS) {
+    if (argc >= 2 && std::strcmp(argv[1], scenario.name) != 0)
+      continue;
+    found = true;
+    host::preferences_clear();
+    host::uart_clear();
+    ok &= report(scenario, run(scenario));
+  }
+  if (!found) {
+    std::fprintf(stderr, "unknown scenario %s\n", argv[1]);
+    return 2;
+  }
+  return ok ? 0 : 1;
+}
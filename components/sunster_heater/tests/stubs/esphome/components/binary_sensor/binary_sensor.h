@@ -0,0 +1,18 @@
+#pragma once
+#include "esphome/core/entity_base.h"
+namespace esphome {
+namespace binary_sensor {
+class BinarySensor : public EntityBase {
+ public:
+  void publish_state(bool state) {
+    this->state = state;
+    has_state_ = true;
+  }
+  bool has_state() const { return has_state_; }
+  bool state{false};
+
+ protected:
+  bool has_state_{false};
+};
+}  // namespace binary_sensor
+}  // namespace esphome
@@ -0,0 +1,19 @@
+#pragma once
+#include "esphome/core/entity_base.h"
+namespace esphome {
+namespace number {
+class Number : public EntityBase {
+ public:
+  void publish_state(float state) {
+    this->state = state;
+    has_state_ = true;
+  }
+  bool has_state() const { return has_state_; }
+  float state{0.0f};
+
+ protected:
+  virtual void control(float value) = 0;
+  bool has_state_{false};
+};
+}  // namespace number
+}  // namespace esphome
@@ -0,0 +1,15 @@
+#pragma once
+#include <string>
+#include "esphome/core/entity_base.h"
+namespace esphome {
+namespace select {
+class Select : public EntityBase {
+ public:
+  void publish_state(const std::string &state) { this->state = state; }
+  std::string state;
+
+ protected:
+  virtual void control(const std::string &value) = 0;
+};
+}  // namespace select
+}  // namespace esphome
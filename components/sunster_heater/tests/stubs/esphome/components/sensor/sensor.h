@@ -0,0 +1,24 @@
+#pragma once
+#include <functional>
+#include <vector>
+#include "esphome/core/component.h"
+#include "esphome/core/entity_base.h"
+namespace esphome {
+namespace sensor {
+class Sensor : public EntityBase {
+ public:
+  void publish_state(float state);
+  bool has_state() const { return has_state_; }
+  float get_state() const { return state; }
+  void add_on_state_callback(std::function<void(float)> &&callback) { callbacks_.push_back(std::move(callback)); }
+  uint32_t publishes() const { return publishes_; }
+
+  float state{0.0f};
+
+ protected:
+  std::vector<std::function<void(float)>> callbacks_;
+  bool has_state_{false};
+  uint32_t publishes_{0};
+};
+}  // namespace sensor
+}  // namespace esphome
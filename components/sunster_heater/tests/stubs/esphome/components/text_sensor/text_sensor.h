@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include "esphome/core/entity_base.h"
+namespace esphome {
+namespace text_sensor {
+class TextSensor : public EntityBase {
+ public:
+  void publish_state(const std::string &state) {
+    this->state = state;
+    has_state_ = true;
+  }
+  bool has_state() const { return has_state_; }
+  std::string state;
+
+ protected:
+  bool has_state_{false};
+};
+}  // namespace text_sensor
+}  // namespace esphome
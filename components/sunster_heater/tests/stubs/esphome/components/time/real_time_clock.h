@@ -0,0 +1,16 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/time.h"
+
+namespace esphome {
+namespace time {
+
+// Follows the virtual clock from the epoch set with host::set_epoch()
+class RealTimeClock : public Component {
+ public:
+  ESPTime now();
+};
+
+}  // namespace time
+}  // namespace esphome
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+namespace esphome {
+namespace uart {
+// Host stand-in: RX bytes become available at their scheduled virtual time (see host.h)
+class UARTComponent {
+ public:
+  void set_baud_rate(uint32_t baud_rate) { baud_rate_ = baud_rate; }
+  uint32_t get_baud_rate() const { return baud_rate_; }
+
+ protected:
+  uint32_t baud_rate_{4800};
+};
+class UARTDevice {
+ public:
+  void set_uart_parent(UARTComponent *parent) { parent_ = parent; }
+  int available();
+  bool read_byte(uint8_t *data);
+  bool read_array(uint8_t *data, size_t len);
+  void write_array(const uint8_t *data, size_t len);
+  void flush() {}
+
+ protected:
+  UARTComponent *parent_{nullptr};
+};
+}  // namespace uart
+}  // namespace esphome
@@ -0,0 +1,44 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <string>
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+namespace esphome {
+namespace setup_priority {
+extern const float DATA;
+extern const float AFTER_CONNECTION;
+}  // namespace setup_priority
+// Host stand-in: scheduler calls are accepted and ignored; the harness drives loop()/update()
+class Component {
+ public:
+  virtual ~Component() = default;
+  virtual void setup() {}
+  virtual void loop() {}
+  virtual void dump_config() {}
+  virtual float get_setup_priority() const { return 0.0f; }
+  virtual void on_shutdown() {}
+  virtual void on_safe_shutdown() {}
+  void mark_failed() { failed_ = true; }
+  bool is_failed() const { return failed_; }
+
+ protected:
+  void set_interval(const std::string &name, uint32_t interval, std::function<void()> &&f) {}
+  void set_interval(uint32_t interval, std::function<void()> &&f) {}
+  void set_timeout(const std::string &name, uint32_t timeout, std::function<void()> &&f) {}
+  bool cancel_interval(const std::string &name) { return false; }
+  void defer(std::function<void()> &&f) { f(); }
+  void status_set_warning() {}
+  void status_clear_warning() {}
+  bool failed_{false};
+};
+class PollingComponent : public Component {
+ public:
+  virtual void update() = 0;
+  void set_update_interval(uint32_t interval) { update_interval_ = interval; }
+  uint32_t get_update_interval() const { return update_interval_; }
+
+ protected:
+  uint32_t update_interval_{1000};
+};
+}  // namespace esphome
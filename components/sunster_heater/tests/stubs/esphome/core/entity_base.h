@@ -0,0 +1,16 @@
+#pragma once
+#include <string>
+#include "esphome/core/log.h"
+namespace esphome {
+enum EntityCategory { ENTITY_CATEGORY_NONE = 0, ENTITY_CATEGORY_CONFIG = 1, ENTITY_CATEGORY_DIAGNOSTIC = 2 };
+class EntityBase {
+ public:
+  void set_name(const char *name) { name_ = name; }
+  const char *get_name() const { return name_; }
+  void set_entity_category(EntityCategory category) { category_ = category; }
+
+ protected:
+  const char *name_{""};
+  EntityCategory category_{ENTITY_CATEGORY_NONE};
+};
+}  // namespace esphome
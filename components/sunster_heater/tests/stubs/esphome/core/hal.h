@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+// Host stand-in: time comes from the virtual clock in host.h
+uint32_t millis();
+uint32_t micros();
+namespace esphome {
+using ::micros;
+using ::millis;
+void yield();
+}  // namespace esphome
@@ -0,0 +1,24 @@
+#pragma once
+#include <cstdio>
+namespace esphome {
+namespace host {
+enum LogLevel { LOG_NONE = 0, LOG_ERROR, LOG_WARN, LOG_INFO, LOG_CONFIG, LOG_DEBUG, LOG_VERBOSE, LOG_VERY_VERBOSE };
+void log_printf(int level, const char *tag, const char *format, ...) __attribute__((format(printf, 3, 4)));
+}  // namespace host
+}  // namespace esphome
+#define ESP_LOGE(tag, ...) ::esphome::host::log_printf(::esphome::host::LOG_ERROR, tag, __VA_ARGS__)
+#define ESP_LOGW(tag, ...) ::esphome::host::log_printf(::esphome::host::LOG_WARN, tag, __VA_ARGS__)
+#define ESP_LOGI(tag, ...) ::esphome::host::log_printf(::esphome::host::LOG_INFO, tag, __VA_ARGS__)
+#define ESP_LOGCONFIG(tag, ...) ::esphome::host::log_printf(::esphome::host::LOG_CONFIG, tag, __VA_ARGS__)
+#define ESP_LOGD(tag, ...) ::esphome::host::log_printf(::esphome::host::LOG_DEBUG, tag, __VA_ARGS__)
+#define ESP_LOGV(tag, ...) ::esphome::host::log_printf(::esphome::host::LOG_VERBOSE, tag, __VA_ARGS__)
+#define ESP_LOGVV(tag, ...) ::esphome::host::log_printf(::esphome::host::LOG_VERY_VERBOSE, tag, __VA_ARGS__)
+#define YESNO(b) ((b) ? "YES" : "NO")
+#define ONOFF(b) ((b) ? "ON" : "OFF")
+#define LOG_SENSOR(p, t, s) (void) (s)
+#define LOG_TEXT_SENSOR(p, t, s) (void) (s)
+#define LOG_BINARY_SENSOR(p, t, s) (void) (s)
+#define LOG_NUMBER(p, t, s) (void) (s)
+#define LOG_BUTTON(p, t, s) (void) (s)
+#define LOG_SELECT(p, t, s) (void) (s)
+#define LOG_SWITCH(p, t, s) (void) (s)
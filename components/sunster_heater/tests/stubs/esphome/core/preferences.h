@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+namespace esphome {
+// Host stand-in: preferences live in an in-memory map keyed by type (see host.h)
+class ESPPreferenceObject {
+ public:
+  ESPPreferenceObject() = default;
+  explicit ESPPreferenceObject(uint32_t type) : type_(type), valid_(true) {}
+  template<typename T> bool save(const T *src) { return save_(reinterpret_cast<const uint8_t *>(src), sizeof(T)); }
+  template<typename T> bool load(T *dest) { return load_(reinterpret_cast<uint8_t *>(dest), sizeof(T)); }
+
+ protected:
+  bool save_(const uint8_t *data, size_t len);
+  bool load_(uint8_t *data, size_t len);
+  uint32_t type_{0};
+  bool valid_{false};
+};
+class ESPPreferences {
+ public:
+  template<typename T> ESPPreferenceObject make_preference(uint32_t type, bool in_flash = true) {
+    (void) in_flash;
+    return ESPPreferenceObject(type);
+  }
+  bool sync();
+};
+extern ESPPreferences *global_preferences;
+}  // namespace esphome
@@ -0,0 +1,11 @@
+#pragma once
+#include <cstdint>
+#include <ctime>
+namespace esphome {
+struct ESPTime {
+  time_t timestamp;
+  uint8_t hour;
+  uint16_t day_of_year;
+  bool is_valid() const { return timestamp != 0; }
+};
+}  // namespace esphome
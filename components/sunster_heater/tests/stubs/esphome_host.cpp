@@ -0,0 +1,219 @@
+#include "host.h"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <deque>
+#include <map>
+#include <string>
+
+#include "esphome/components/sensor/sensor.h"
+#include "esphome/components/time/real_time_clock.h"
+#include "esphome/components/uart/uart.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+#include "esphome/core/preferences.h"
+
+namespace {
+
+struct RxByte {
+  uint64_t at_us;
+  uint8_t value;
+};
+
+uint64_t now_us = 0;
+bool wall_clock = false;
+uint32_t epoch_s = 0;
+std::deque<RxByte> rx;
+std::vector<uint8_t> tx;
+std::map<uint32_t, std::string> preferences;
+uint32_t saves = 0;
+uint32_t syncs = 0;
+// HOST_LOG_LEVEL=0..7 (none .. very verbose) overrides the default
+int log_level = std::getenv("HOST_LOG_LEVEL") ? std::atoi(std::getenv("HOST_LOG_LEVEL")) : esphome::host::LOG_WARN;
+int hook_level = esphome::host::LOG_NONE;
+std::function<void(const char *, const char *)> log_hook;
+
+uint64_t wall_us() {
+  return std::chrono::duration_cast<std::chrono::microseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+}  // namespace
+
+uint32_t millis() { return static_cast<uint32_t>(esphome::host::time_us() / 1000); }
+uint32_t micros() { return static_cast<uint32_t>(esphome::host::time_us()); }
+
+namespace esphome {
+
+void yield() {}
+
+namespace setup_priority {
+const float DATA = 600.0f;
+const float AFTER_CONNECTION = 100.0f;
+}  // namespace setup_priority
+
+static ESPPreferences preferences_instance;
+ESPPreferences *global_preferences = &preferences_instance;
+
+bool ESPPreferenceObject::save_(const uint8_t *data, size_t len) {
+  if (!valid_)
+    return false;
+  preferences[type_].assign(reinterpret_cast<const char *>(data), len);
+  saves++;
+  return true;
+}
+
+bool ESPPreferenceObject::load_(uint8_t *data, size_t len) {
+  auto it = preferences.find(type_);
+  if (!valid_ || it == preferences.end() || it->second.size() != len)
+    return false;
+  std::memcpy(data, it->second.data(), len);
+  return true;
+}
+
+bool ESPPreferences::sync() {
+  syncs++;
+  return true;
+}
+
+uint32_t fnv1_hash(const std::string &str) {
+  uint32_t hash = 2166136261UL;
+  for (char c : str) {
+    hash *= 16777619UL;
+    hash ^= static_cast<uint8_t>(c);
+  }
+  return hash;
+}
+
+std::string format_hex_pretty(const uint8_t *data, size_t length) {
+  std::string out;
+  char buf[4];
+  for (size_t i = 0; i < length; i++) {
+    std::snprintf(buf, sizeof(buf), i == 0 ? "%02X" : ".%02X", data[i]);
+    out += buf;
+  }
+  return out;
+}
+
+std::string base64_encode(const uint8_t *buf, size_t buf_len) {
+  static const char CHARS[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  std::string out;
+  for (size_t i = 0; i < buf_len; i += 3) {
+    uint32_t n = static_cast<uint32_t>(buf[i]) << 16;
+    if (i + 1 < buf_len)
+      n |= static_cast<uint32_t>(buf[i + 1]) << 8;
+    if (i + 2 < buf_len)
+      n |= buf[i + 2];
+    out += CHARS[(n >> 18) & 63];
+    out += CHARS[(n >> 12) & 63];
+    out += i + 1 < buf_len ? CHARS[(n >> 6) & 63] : '=';
+    out += i + 2 < buf_len ? CHARS[n & 63] : '=';
+  }
+  return out;
+}
+
+namespace sensor {
+void Sensor::publish_state(float state) {
+  this->state = state;
+  has_state_ = true;
+  publishes_++;
+  for (auto &callback : callbacks_)
+    callback(state);
+}
+}  // namespace sensor
+
+namespace time {
+ESPTime RealTimeClock::now() {
+  ESPTime now{};
+  if (epoch_s == 0)
+    return now;
+  now.timestamp = static_cast<time_t>(epoch_s + host::time_us() / 1000000);
+  std::tm tm{};
+  gmtime_r(&now.timestamp, &tm);
+  now.hour = static_cast<uint8_t>(tm.tm_hour);
+  now.day_of_year = static_cast<uint16_t>(tm.tm_yday + 1);
+  return now;
+}
+}  // namespace time
+
+namespace uart {
+// Counts at most the default ESPHome RX buffer size, which keeps it cheap for long queues
+int UARTDevice::available() {
+  static const int RX_BUFFER_SIZE = 256;
+  uint64_t now = host::time_us();
+  int n = 0;
+  for (auto it = rx.begin(); it != rx.end() && it->at_us <= now && n < RX_BUFFER_SIZE; ++it)
+    n++;
+  return n;
+}
+
+bool UARTDevice::read_byte(uint8_t *data) {
+  if (rx.empty() || rx.front().at_us > host::time_us())
+    return false;
+  *data = rx.front().value;
+  rx.pop_front();
+  return true;
+}
+
+bool UARTDevice::read_array(uint8_t *data, size_t len) {
+  if (static_cast<size_t>(this->available()) < len)
+    return false;
+  for (size_t i = 0; i < len; i++)
+    this->read_byte(&data[i]);
+  return true;
+}
+
+void UARTDevice::write_array(const uint8_t *data, size_t len) { tx.insert(tx.end(), data, data + len); }
+}  // namespace uart
+
+namespace host {
+
+void set_time_us(uint64_t value) { now_us = value; }
+void advance_us(uint64_t delta_us) { now_us += delta_us; }
+uint64_t time_us() { return wall_clock ? wall_us() : now_us; }
+void use_wall_clock(bool enabled) { wall_clock = enabled; }
+void set_epoch(uint32_t value) { epoch_s = value; }
+
+void uart_schedule(const uint8_t *data, size_t len, uint64_t first_us, uint32_t byte_us) {
+  for (size_t i = 0; i < len; i++)
+    rx.push_back(RxByte{first_us + i * byte_us, data[i]});
+}
+size_t uart_pending() { return rx.size(); }
+void uart_clear() { rx.clear(); }
+const std::vector<uint8_t> &uart_tx() { return tx; }
+
+void preferences_clear() {
+  preferences.clear();
+  saves = syncs = 0;
+}
+uint32_t preference_saves() { return saves; }
+uint32_t preference_syncs() { return syncs; }
+
+void set_log_level(int level) { log_level = level; }
+
+void set_log_hook(int level, std::function<void(const char *tag, const char *line)> hook) {
+  hook_level = level;
+  log_hook = std::move(hook);
+}
+
+void log_printf(int level, const char *tag, const char *format, ...) {
+  if (level > log_level && level > hook_level)
+    return;
+  char line[512];
+  va_list args;
+  va_start(args, format);
+  std::vsnprintf(line, sizeof(line), format, args);
+  va_end(args);
+  if (level <= log_level)
+    std::printf("[%s] %s\n", tag, line);
+  if (level <= hook_level && log_hook)
+    log_hook(tag, line);
+}
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Controls for the host stand-ins of the ESPHome core: a virtual clock, a UART whose RX bytes
+// arrive at scheduled times, and in-memory preferences that survive a simulated reboot.
+namespace esphome {
+namespace host {
+
+// Virtual clock (millis()/micros()); with the wall clock enabled micros() follows real time,
+// for benchmarks
+void set_time_us(uint64_t now_us);
+void advance_us(uint64_t delta_us);
+inline void advance_ms(uint32_t delta_ms) { advance_us(static_cast<uint64_t>(delta_ms) * 1000); }
+uint64_t time_us();
+void use_wall_clock(bool enabled);
+// Wall time (UTC seconds) of the time component at virtual time 0; 0 = not synced
+void set_epoch(uint32_t epoch_s);
+
+// RX bytes: byte i becomes available at first_us + i * byte_us
+void uart_schedule(const uint8_t *data, size_t len, uint64_t first_us, uint32_t byte_us);
+size_t uart_pending();
+void uart_clear();
+// Everything the component wrote
+const std::vector<uint8_t> &uart_tx();
+
+// Preferences: values persist across component instances until cleared
+void preferences_clear();
+uint32_t preference_saves();
+uint32_t preference_syncs();
+
+void set_log_level(int level);
+// Receives every formatted log line at or below the hook level, independent of set_log_level
+void set_log_hook(int level, std::function<void(const char *tag, const char *line)> hook);
+
+}  // namespace host
+}  // namespace esphome
@@ -0,0 +1,138 @@
+// Temperature estimator against the simulator, in closed loop.
+//
+// The cabin is held at 20 C from -10 C outside. The external sensor is a DS18B20-like reading
+// of the simulated sensor temperature, quantised to 0.0625 C and published every 10 s. Over a
+// 2 h hold after settling, the Kalman slope and the slope EMA it replaced (same window) are
+// compared against the slope of the unquantised sensor temperature, and the PI's power level
+// changes are counted. An 85 C power-on read in the middle must not reach the controller.
+
+#include <cmath>
+#include <cstdio>
+
+#include "host_harness.h"
+
+using namespace esphome;
+using namespace esphome::sunster_heater;
+using namespace esphome::sunster_heater::testing;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+  do { \
+    if (!(cond)) { \
+      std::printf("%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+#define CHECK_NEAR(a, b, tol) \
+  do { \
+    if (!(std::fabs((a) - (b)) <= (tol))) { \
+      std::printf("%s:%d: CHECK_NEAR failed: %s = %g, expected %g +/- %g\n", __FILE__, __LINE__, #a, (double) (a), \
+                  (double) (b), (double) (tol)); \
+      failures++; \
+    } \
+  } while (0)
+
+namespace {
+
+const uint32_t SAMPLE_S = 10;
+const uint32_t SETTLE_S = 7200;
+const uint32_t HOLD_S = 7200;
+const float QUANTUM_C = 0.0625f;
+// Power level changes allowed over the 2 h hold (about one every 2 min)
+const uint32_t MAX_LEVEL_CHANGES = 60;
+
+float quantise(float celsius) { return std::round(celsius / QUANTUM_C) * QUANTUM_C; }
+
+// The slope filter before the estimator: EMA of the sample-to-sample difference quotient
+struct SlopeEma {
+  float window_s;
+  float slope{0.0f};
+  float last{NAN};
+  void update(float celsius, float dt_s) {
+    if (!std::isnan(last)) {
+      float alpha = dt_s / (window_s + dt_s);
+      slope = alpha * (celsius - last) / dt_s + (1.0f - alpha) * slope;
+    }
+    last = celsius;
+  }
+};
+
+}  // namespace
+
+int main() {
+  host::preferences_clear();
+  host::uart_clear();
+  HostHeater host_heater;
+  SunsterHeater &heater = host_heater.heater;
+  SimConfig config;
+  config.ambient_c = -10.0f;
+  config.initial_c = -10.0f;
+  heater.set_simulation(config);
+  heater.set_control_mode(ControlMode::AUTOMATIC);
+  heater.set_target_temperature(20.0f);
+
+  sensor::Sensor power_level;
+  heater.set_power_level_sensor(&power_level);
+  bool holding = false;
+  float last_level = NAN;
+  uint32_t level_changes = 0;
+  power_level.add_on_state_callback([&](float level) {
+    if (holding && !std::isnan(last_level) && level != last_level)
+      level_changes++;
+    last_level = level;
+  });
+
+  host::set_time_us(1000000);
+  host_heater.setup();
+  host_heater.external_temperature.publish_state(quantise(heater.get_simulated_temperature()));
+  host_heater.run_for_ms(2000);  // first status frame (boot sync) before the start request
+  heater.turn_on();
+
+  TemperatureEstimator kalman;
+  kalman.configure(0.05f, heater.get_slope_window());
+  SlopeEma ema{heater.get_slope_window()};
+  float last_true = NAN;
+  double kalman_sq = 0.0, ema_sq = 0.0;
+  uint32_t samples = 0;
+  float max_used_c = -100.0f;
+
+  for (uint32_t t = SAMPLE_S; t <= SETTLE_S + HOLD_S; t += SAMPLE_S) {
+    host_heater.run_for_ms(SAMPLE_S * 1000);
+    float true_c = heater.get_simulated_temperature();
+    float measured = quantise(true_c);
+    if (t == SETTLE_S + HOLD_S / 2) {
+      // DS18B20 power-on value: the gate drops it, the controller keeps the last good sample
+      host_heater.external_temperature.publish_state(85.0f);
+      host_heater.run_for_ms(1000);
+      CHECK_NEAR(heater.get_external_temperature(), measured, 0.5f);
+    }
+    host_heater.external_temperature.publish_state(measured);
+    if (std::isnan(heater.get_external_temperature()) || heater.get_external_temperature() > max_used_c)
+      max_used_c = heater.get_external_temperature();
+
+    kalman.update(millis(), measured);
+    ema.update(measured, SAMPLE_S);
+    if (t > SETTLE_S) {
+      holding = true;
+      float true_slope = (true_c - last_true) / SAMPLE_S;
+      kalman_sq += (kalman.rate() - true_slope) * (kalman.rate() - true_slope);
+      ema_sq += (ema.slope - true_slope) * (ema.slope - true_slope);
+      samples++;
+    }
+    last_true = true_c;
+  }
+
+  float kalman_rms = std::sqrt(kalman_sq / samples) * 3600.0f;
+  float ema_rms = std::sqrt(ema_sq / samples) * 3600.0f;
+  const SimMetrics &m = heater.get_simulator()->metrics();
+  std::printf("2 h hold at 20 C, %.4f C steps: slope error rms %.3f C/h (EMA %.3f C/h), %u power level changes, "
+              "%u starts, highest controller input %.2f C\n",
+              QUANTUM_C, kalman_rms, ema_rms, (unsigned) level_changes, (unsigned) m.starts, max_used_c);
+  CHECK(kalman_rms < 0.9f * ema_rms);
+  CHECK(level_changes <= MAX_LEVEL_CHANGES);
+  CHECK(m.starts == 1);
+  CHECK(max_used_c < 21.0f);
+  std::printf("%s\n", failures == 0 ? "OK" : "FAILED");
+  return failures == 0 ? 0 : 1;
+}